@@ -43,7 +43,7 @@ report_experimental_options(Parsed_Cmd * parsed_cmd, int depth)
    REPORT_FLAG_OPTION(3,  "DDC Null Message never indicates invalid feature");
    REPORT_FLAG_OPTION(4,  "Read strategy tests");
    REPORT_FLAG_OPTION(5,  buf5);
-   REPORT_FLAG_OPTION(6,  "Unused");
+   REPORT_FLAG_OPTION(6,  "Poll for cross-instance locks instead of blocking wait");
    REPORT_FLAG_OPTION(7,  "Disable phantom display detection");
    REPORT_FLAG_OPTION(8,  "Slow down watch display polling");
    REPORT_FLAG_OPTION(9,  buf0);
@@ -57,7 +57,7 @@ report_experimental_options(Parsed_Cmd * parsed_cmd, int depth)
    rpt_vstring(depth+1, "Utility option --i2:          NULL Response Hack Millis");
    rpt_vstring(depth+1, "Utility option --i3:          flock_poll_millisec (default = %d)", DEFAULT_FLOCK_POLL_MILLISEC);
    rpt_vstring(depth+1, "Utility option --i4:          flock_max_wait_millisec (default = %d", DEFAULT_FLOCK_MAX_WAIT_MILLISEC);
-   rpt_vstring(depth+1, "Utility option --i5:          Unused");
+   rpt_vstring(depth+1, "Utility option --i5:          display_lock_max_wait_millisec, 0 = no limit (default = %d)", DEFAULT_DISPLAY_LOCK_MAX_WAIT_MILLISEC);
    rpt_vstring(depth+1, "Utility option --i6:          Unused");
    rpt_vstring(depth+1, "Utility option --i7:          Unused");
    rpt_vstring(depth+1, "Utility option --i8:          Unused");
@@ -3,7 +3,7 @@
  *  Initialize and release base services.
  */
 
-// Copyright (C) 2014-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2014-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "util/error_info.h"
@@ -17,11 +17,14 @@
 #include "feature_metadata.h"
 #include "i2c_bus_base.h"
 #include "linux_errno.h"
+#include "lock_stats.h"
 #include "per_display_data.h"
 #include "per_thread_data.h"
 #include "rtti.h"
 #include "sleep.h"
+#include "timeline.h"
 #include "tuned_sleep.h"
+#include "work_pool.h"
 
 #include "base_services.h"
 
@@ -37,15 +40,18 @@ void init_base_services() {
    init_ddc_packets();
    init_dsa2();
    init_execution_stats();
+   init_lock_stats();
    // init_linux_errno();
    init_per_display_data();
    init_per_thread_data();
    init_sleep_stats();
    init_status_code_mgt();
+   init_timeline();
    init_tuned_sleep();
    init_displays();
    init_i2c_bus_base();
    init_feature_metadata();
+   init_work_pool();
    if (debug)
       printf("(%s) Done\n", __func__);
 }
@@ -53,9 +59,13 @@ void init_base_services() {
 
 /** Cleanup at termination helps to reveal where the real leaks are */
 void terminate_base_services() {
+   terminate_work_pool();
+   terminate_timeline();
    terminate_per_thread_data();
    terminate_per_display_data();
    terminate_execution_stats();
+   terminate_lock_stats();
    terminate_dsa2();
+   terminate_i2c_bus_base();
    terminate_rtti();
 }
@@ -71,6 +71,7 @@ Value_Name_Table callopt_bitname_table2 = {
       VN(CALLOPT_WARN_FINDEX),
       VN(CALLOPT_WAIT),
       VN(CALLOPT_FORCE_SLAVE_ADDR),
+      VN(CALLOPT_POOLED),
       VN(CALLOPT_NONE),                // special entry
       VN_END
 };
@@ -71,6 +71,7 @@ typedef Byte Call_Options;
 #define CALLOPT_FORCE        0x08    ///< ignore various validity checks
 #define CALLOPT_WAIT         0x04    ///< wait on locked resources, if false then fail
 #define CALLOPT_FORCE_SLAVE_ADDR 0x02 ///< use op I2C_SLAVE_FORCE (not currently used)
+#define CALLOPT_POOLED       0x01    ///< handle may be retained in the I2C handle pool
 
 char * interpret_call_options_t(Call_Options calloptions);
 
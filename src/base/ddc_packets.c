@@ -3,13 +3,14 @@
  * Functions for creating DDC packets and interpreting DDC response packets.
  */
 
-// Copyright (C) 2014-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2014-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 /** \cond */
 #include <config.h>
 
 #include <assert.h>
+#include <glib-2.0/glib.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -223,7 +224,49 @@ bool isNullPacket(DDC_Packet * packet) {
 }
 
 
+//
+// Packet storage
+//
+
+// Freed packets are kept on a small per-thread free list and reused, so that
+// in the steady state creating and freeing packets performs no heap allocation.
+// A thread rarely has more than a request and a response packet outstanding.
+
+#define PACKET_FREE_LIST_MAX 4
+
+typedef struct {
+   int          ct;
+   DDC_Packet * packets[PACKET_FREE_LIST_MAX];
+} Packet_Free_List;
+
+static void
+free_packet_free_list(gpointer data) {
+   Packet_Free_List * free_list = data;
+   for (int ndx = 0; ndx < free_list->ct; ndx++)
+      free(free_list->packets[ndx]);
+   free(free_list);
+}
+
+static GPrivate packet_free_list_key = G_PRIVATE_INIT(free_packet_free_list);
+
+static gint packet_create_ct = 0;
+static gint packet_heap_alloc_ct = 0;
+
+
+static Packet_Free_List *
+get_packet_free_list() {
+   Packet_Free_List * free_list = g_private_get(&packet_free_list_key);
+   if (!free_list) {
+      free_list = calloc(1, sizeof(Packet_Free_List));
+      g_private_set(&packet_free_list_key, free_list);
+   }
+   return free_list;
+}
+
+
 /** Frees a #DDC_Packet
+ *
+ *  The packet is returned to the current thread's free list if there is room.
  *
  *  \param packet pointer to packet to free
  */
@@ -234,16 +277,18 @@ void free_ddc_packet(DDC_Packet * packet) {
    // dump_packet(packet);
 
    if (packet) {
-      if (packet->parsed.raw_parsed) {
-         DBGMSF(debug, "freeing packet->parsed.raw_parsed=%p", packet->parsed.raw_parsed);
-         free(packet->parsed.raw_parsed);
+      assert(packet->raw_bytes == &packet->raw_bytes_buffer);
+      assert(!packet->parsed.raw_parsed || packet->parsed.raw_parsed == &packet->parsed_storage);
+      packet->raw_bytes_buffer.marker[3] = 'x';
+      Packet_Free_List * free_list = get_packet_free_list();
+      if (free_list->ct < PACKET_FREE_LIST_MAX) {
+         DBGMSF(debug, "returning packet=%p to free list", packet);
+         free_list->packets[free_list->ct++] = packet;
+      }
+      else {
+         DBGMSF(debug, "freeing packet=%p", packet);
+         free(packet);
       }
-
-      DBGMSF(debug, "calling free_buffer() for packet->buf=%p", packet->raw_bytes);
-      buffer_free(packet->raw_bytes, "free DDC packet");
-
-      DBGMSF(debug, "freeing packet=%p", packet);
-      free(packet);
    }
    DBGMSF(debug, "Done" );
 }
@@ -251,17 +296,35 @@ void free_ddc_packet(DDC_Packet * packet) {
 
 /** Base function for creating any DDC packet
  *
- *  \param  max_size  size of buffer allocated for packet bytes
+ *  \param  max_size  number of bytes used in the packet's raw bytes buffer,
+ *                    at most MAX_DDC_PACKET_SIZE
  *  \param  tag       debug string (may be NULL)
- *  \return pointer to newly allocated #DDC_Packet
+ *  \return pointer to #DDC_Packet
  */
 DDC_Packet *
 create_empty_ddc_packet(int max_size, const char * tag) {
    bool debug = false;
    DBGTRC_STARTING(debug, TRACE_GROUP, "max_size=%d, tag=%s", max_size, (tag) ? tag : "(nil)");
+   assert(max_size <= MAX_DDC_PACKET_SIZE);
+
+   g_atomic_int_inc(&packet_create_ct);
+   DDC_Packet * packet = NULL;
+   Packet_Free_List * free_list = get_packet_free_list();
+   if (free_list->ct > 0) {
+      packet = free_list->packets[--free_list->ct];
+   }
+   else {
+      g_atomic_int_inc(&packet_heap_alloc_ct);
+      packet = malloc(sizeof(DDC_Packet));
+   }
 
-   DDC_Packet * packet = malloc(sizeof(DDC_Packet));
-   packet->raw_bytes = buffer_new(max_size, "empty DDC packet");
+   memcpy(packet->raw_bytes_buffer.marker, BUFFER_MARKER, 4);
+   memset(packet->raw_bytes_storage, 0, sizeof(packet->raw_bytes_storage));
+   packet->raw_bytes_buffer.bytes = packet->raw_bytes_storage;
+   packet->raw_bytes_buffer.buffer_size = max_size;
+   packet->raw_bytes_buffer.len = 0;
+   packet->raw_bytes_buffer.size_increment = 0;
+   packet->raw_bytes = &packet->raw_bytes_buffer;
    if (tag) {
       strncpy(packet->tag, tag, sizeof(packet->tag));  // no need to check if packet->tag truncated
       packet->tag[sizeof(packet->tag)-1] = '\0';
@@ -277,6 +340,39 @@ create_empty_ddc_packet(int max_size, const char * tag) {
 }
 
 
+/** Returns how many packets were created and how many of those
+ *  required a heap allocation.
+ *
+ *  \param  created_ct_loc     where to return number of packets created
+ *  \param  heap_alloc_ct_loc  where to return number of heap allocations
+ */
+void get_ddc_packet_alloc_stats(int * created_ct_loc, int * heap_alloc_ct_loc) {
+   *created_ct_loc    = g_atomic_int_get(&packet_create_ct);
+   *heap_alloc_ct_loc = g_atomic_int_get(&packet_heap_alloc_ct);
+}
+
+
+/** Reports how many packets were created and how many of those
+ *  required a heap allocation.
+ *
+ *  \param  depth  logical indentation depth
+ */
+void report_ddc_packet_alloc_stats(int depth) {
+   int created;
+   int allocated;
+   get_ddc_packet_alloc_stats(&created, &allocated);
+   rpt_vstring(depth, "DDC packets created: %d, reused: %d, heap allocations: %d",
+                      created, created - allocated, allocated);
+}
+
+
+/** Resets the DDC packet creation counters. */
+void reset_ddc_packet_alloc_stats() {
+   g_atomic_int_set(&packet_create_ct, 0);
+   g_atomic_int_set(&packet_heap_alloc_ct, 0);
+}
+
+
 //
 // Request Packets
 //
@@ -992,8 +1088,8 @@ create_ddc_typed_response_packet(
       case DDC_PACKET_TYPE_TABLE_READ_RESPONSE:
          {
             Interpreted_Multi_Part_Read_Fragment * aux_data
-                  = calloc(1, sizeof(Interpreted_Multi_Part_Read_Fragment));
-            assert(packet);
+                  = &packet->parsed_storage.multi_part_read_fragment;
+            memset(aux_data, 0, sizeof(Interpreted_Multi_Part_Read_Fragment));
             packet->parsed.multi_part_read_fragment = aux_data;
             rc = interpret_multi_part_read_response(
                    expected_type,
@@ -1006,8 +1102,8 @@ create_ddc_typed_response_packet(
       case DDC_PACKET_TYPE_QUERY_VCP_RESPONSE:
          {
             Parsed_Nontable_Vcp_Response * aux_data
-                  = calloc(1, sizeof(Parsed_Nontable_Vcp_Response));
-            assert(packet);
+                  = &packet->parsed_storage.nontable_response;
+            memset(aux_data, 0, sizeof(Parsed_Nontable_Vcp_Response));
             packet->parsed.nontable_response = aux_data;
             rc = interpret_vcp_feature_response_std(
                     get_data_start(packet),
@@ -1073,7 +1169,8 @@ create_ddc_multi_part_read_response_packet(
          rc = COUNT_STATUS_CODE(DDCRC_DDC_DATA);    // was DDCRC_INVALID_DATA
       }
       else {
-         Interpreted_Multi_Part_Read_Fragment * aux_data = calloc(1, sizeof(Interpreted_Multi_Part_Read_Fragment));
+         Interpreted_Multi_Part_Read_Fragment * aux_data = &packet->parsed_storage.multi_part_read_fragment;
+         memset(aux_data, 0, sizeof(Interpreted_Multi_Part_Read_Fragment));
          packet->parsed.multi_part_read_fragment = aux_data;
 
          rc = interpret_multi_part_read_response(
@@ -1133,7 +1230,8 @@ create_ddc_getvcp_response_packet(
          rc = COUNT_STATUS_CODE(DDCRC_DDC_DATA);     // was DDCRC_INVALID_DATA
       }
       else {
-         Parsed_Nontable_Vcp_Response * aux_data = calloc(1, sizeof(Parsed_Nontable_Vcp_Response));
+         Parsed_Nontable_Vcp_Response * aux_data = &packet->parsed_storage.nontable_response;
+         memset(aux_data, 0, sizeof(Parsed_Nontable_Vcp_Response));
          packet->parsed.nontable_response = aux_data;
 
          rc =  interpret_vcp_feature_response_std(
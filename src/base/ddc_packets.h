@@ -3,7 +3,7 @@
  * Functions for creating DDC packets and interpreting DDC response packets.
  */
 
-// Copyright (C) 2014-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2014-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #ifndef DDC_PACKETS_H_
@@ -96,24 +96,38 @@ typedef Byte DDC_Packet_Type;
 #define DDC_PACKET_TYPE_TABLE_READ_RESPONSE   0xe4
 #define DDC_PACKET_TYPE_TABLE_WRITE_REQUEST   0xe7
 
-/** Packet bytes and interpretation */
+/** Packet bytes and interpretation
+ *
+ *  The raw bytes and the interpretation point into storage contained in
+ *  the packet itself, so a packet is a single allocation.
+ */
 typedef
 struct {
-   Buffer *         raw_bytes;          ///< raw packet bytes
+   Buffer *         raw_bytes;          ///< raw packet bytes, points to raw_bytes_buffer
    char             tag[MAX_DDC_TAG+1]; ///< debug string describing packet, +1 for \0
    DDC_Packet_Type  type;               ///< packet type
    union {
       Parsed_Nontable_Vcp_Response *         nontable_response;
       Interpreted_Multi_Part_Read_Fragment * multi_part_read_fragment;
       void *                                 raw_parsed;
-   } parsed;
+   } parsed;                            ///< NULL or points to parsed_storage
 
    // additional fields for new way of parsing result data
    // Parsed_Response_Data * parsed_response;
+
+   Buffer           raw_bytes_buffer;
+   Byte             raw_bytes_storage[MAX_DDC_PACKET_SIZE];
+   union {
+      Parsed_Nontable_Vcp_Response           nontable_response;
+      Interpreted_Multi_Part_Read_Fragment   multi_part_read_fragment;
+   } parsed_storage;
 } DDC_Packet;
 
 void dbgrpt_packet(DDC_Packet * packet, int depth);
 void free_ddc_packet(DDC_Packet * packet);
+void get_ddc_packet_alloc_stats(int * created_ct_loc, int * heap_alloc_ct_loc);
+void report_ddc_packet_alloc_stats(int depth);
+void reset_ddc_packet_alloc_stats();
 
 bool is_double_byte(Byte * pb);
 
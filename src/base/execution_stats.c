@@ -40,6 +40,7 @@ typedef struct {
    const char *   desc;
    uint64_t       call_nanosec;
    int            call_count;
+   int            avoided_count;    // calls found to be unnecessary and skipped
 } IO_Event_Type_Stats;
 
 
@@ -102,8 +103,9 @@ void reset_io_event_stats() {
 
    g_mutex_lock(&io_event_stats_mutex);
    for (int ndx = 0; ndx < IO_EVENT_TYPE_CT; ndx++) {
-      io_event_stats[ndx].call_count   = 0;
-      io_event_stats[ndx].call_nanosec = 0;
+      io_event_stats[ndx].call_count    = 0;
+      io_event_stats[ndx].call_nanosec  = 0;
+      io_event_stats[ndx].avoided_count = 0;
    }
    g_mutex_unlock(&io_event_stats_mutex);
 
@@ -188,11 +190,25 @@ void log_io_call(
 
    g_mutex_unlock(&io_event_stats_mutex);
 
+   optime_add(OPTIME_SYSCALL, elapsed_nanos);
+
    DBGMSF(debug, "Updated total nanosec = %"PRIu64", as millis=%"PRIu64,
                   io_event_stats[event_type].call_nanosec, io_event_stats[event_type].call_nanosec /(1000*1000) );
 }
 
 
+/** Records that an I/O call was skipped because it would have had no effect,
+ *  e.g. setting the I2C slave address to its current value.
+ *
+ *  @param  event_type  type of call skipped
+ */
+void log_io_call_avoided(const IO_Event_Type event_type) {
+   g_mutex_lock(&io_event_stats_mutex);
+   io_event_stats[event_type].avoided_count++;
+   g_mutex_unlock(&io_event_stats_mutex);
+}
+
+
 /** Reports the accumulated execution statistics
  *
  * @param depth logical indentation depth
@@ -228,6 +244,21 @@ void report_io_call_stats(int depth) {
                total_nanos / (1000*1000),
                total_nanos
               );
+
+   int avoided_ct = 0;
+   for (ndx = 0; ndx < IO_EVENT_TYPE_CT; ndx++)
+      avoided_ct += io_event_stats[ndx].avoided_count;
+   if (avoided_ct > 0) {
+      rpt_vstring(d1, "Unnecessary calls skipped:");
+      for (ndx = 0; ndx < IO_EVENT_TYPE_CT; ndx++) {
+         if (io_event_stats[ndx].avoided_count > 0) {
+            IO_Event_Type_Stats* curstat = &io_event_stats[ndx];
+            char buf[100];
+            snprintf(buf, 100, "%-22s (%s)", curstat->desc, curstat->name);
+            rpt_vstring(d1+1, "%-38s  %4d", buf, curstat->avoided_count);
+         }
+      }
+   }
 }
 
 
@@ -590,6 +621,202 @@ void report_execution_stats(int depth) {
 }
 
 
+//
+// Per-operation elapsed time breakdown
+//
+
+// Operation timing state for the current thread.  Operations can nest,
+// e.g. setvcp verification performs a getvcp.  Time is attributed to the
+// outermost operation.
+typedef struct {
+   int                  depth;
+   Timed_Operation_Type optype;
+   uint64_t             start_nanos;
+   int                  retry_depth;   // number of enclosing retry loops past their first try
+   uint64_t             component_nanos[OPERATION_TIME_COMPONENT_CT];
+} Thread_Operation_Timing;
+
+static GPrivate thread_operation_timing_key = G_PRIVATE_INIT(g_free);
+static Operation_Time_Breakdown operation_times[TIMED_OPERATION_TYPE_CT];
+static GMutex   operation_times_mutex;
+
+static const char * timed_operation_names[] = {
+      "getvcp",
+      "setvcp",
+      "capabilities",
+      "table read",
+      "initial checks"
+};
+
+
+static Thread_Operation_Timing *
+get_thread_operation_timing() {
+   Thread_Operation_Timing * timing = g_private_get(&thread_operation_timing_key);
+   if (!timing) {
+      timing = g_new0(Thread_Operation_Timing, 1);
+      g_private_set(&thread_operation_timing_key, timing);
+   }
+   return timing;
+}
+
+
+/** Marks the start of an operation whose elapsed time is to be broken down.
+ *
+ *  @param  optype  operation type
+ *  @return true if this is the outermost operation in the current thread,
+ *          to be passed to #optime_end()
+ */
+bool optime_start(Timed_Operation_Type optype) {
+   Thread_Operation_Timing * timing = get_thread_operation_timing();
+   bool started = (timing->depth == 0);
+   if (started) {
+      timing->optype = optype;
+      timing->retry_depth = 0;
+      memset(timing->component_nanos, 0, sizeof(timing->component_nanos));
+      timing->start_nanos = cur_realtime_nanosec();
+   }
+   timing->depth++;
+   return started;
+}
+
+
+/** Marks the end of an operation.  If it is the outermost operation,
+ *  its elapsed time and components are added to the global totals and
+ *  optionally to per-display totals.
+ *
+ *  @param  started                 value returned by #optime_start()
+ *  @param  per_display_breakdowns  array of TIMED_OPERATION_TYPE_CT
+ *                                  #Operation_Time_Breakdown, may be NULL
+ */
+void optime_end(bool started, Operation_Time_Breakdown * per_display_breakdowns) {
+   Thread_Operation_Timing * timing = get_thread_operation_timing();
+   assert(timing->depth > 0);
+   timing->depth--;
+   if (started) {
+      assert(timing->depth == 0);
+      uint64_t elapsed_nanos = cur_realtime_nanosec() - timing->start_nanos;
+      g_mutex_lock(&operation_times_mutex);
+      Operation_Time_Breakdown * dests[2] = {
+            &operation_times[timing->optype],
+            (per_display_breakdowns) ? &per_display_breakdowns[timing->optype] : NULL };
+      for (int ndx = 0; ndx < 2; ndx++) {
+         Operation_Time_Breakdown * dest = dests[ndx];
+         if (dest) {
+            dest->operation_ct++;
+            dest->total_nanos += elapsed_nanos;
+            for (int cndx = 0; cndx < OPERATION_TIME_COMPONENT_CT; cndx++)
+               dest->component_nanos[cndx] += timing->component_nanos[cndx];
+         }
+      }
+      g_mutex_unlock(&operation_times_mutex);
+   }
+}
+
+
+/** Adds time to a component of the current thread's operation, if any.
+ *
+ *  @param  component  time component
+ *  @param  nanos      time to add
+ */
+void optime_add(Operation_Time_Component component, uint64_t nanos) {
+   Thread_Operation_Timing * timing = g_private_get(&thread_operation_timing_key);
+   if (timing && timing->depth > 0)
+      timing->component_nanos[component] += nanos;
+}
+
+
+/** Called by a retry loop when it begins its second try, so that
+ *  sleeps from then on are classified as retry sleeps.
+ *
+ *  Retry loops can nest, e.g. a multi-part read retries fragment
+ *  write/read exchanges that are themselves retried.
+ */
+void optime_retry_begin() {
+   Thread_Operation_Timing * timing = g_private_get(&thread_operation_timing_key);
+   if (timing && timing->depth > 0)
+      timing->retry_depth++;
+}
+
+
+/** Called by a retry loop that called #optime_retry_begin() when it exits. */
+void optime_retry_end() {
+   Thread_Operation_Timing * timing = g_private_get(&thread_operation_timing_key);
+   if (timing && timing->retry_depth > 0)
+      timing->retry_depth--;
+}
+
+
+/** Reports whether the current thread is executing a retry.
+ *
+ *  @return true if any enclosing retry loop is past its first try
+ */
+bool optime_in_retry() {
+   Thread_Operation_Timing * timing = g_private_get(&thread_operation_timing_key);
+   return timing && timing->depth > 0 && timing->retry_depth > 0;
+}
+
+
+/** Returns the name of the current thread's outermost timed operation.
+ *
+ *  @return operation name, e.g. "getvcp", NULL if no operation active
+ */
+const char * optime_current_operation_name() {
+   Thread_Operation_Timing * timing = g_private_get(&thread_operation_timing_key);
+   return (timing && timing->depth > 0) ? timed_operation_names[timing->optype] : NULL;
+}
+
+
+/** Reports the elapsed time breakdown for each operation type.
+ *
+ *  @param  breakdowns  array of TIMED_OPERATION_TYPE_CT #Operation_Time_Breakdown,
+ *                      if NULL report global totals
+ *  @param  depth       logical indentation depth
+ */
+void report_operation_time_breakdown(Operation_Time_Breakdown * breakdowns, int depth) {
+   int d1 = depth+1;
+   if (!breakdowns)
+      breakdowns = operation_times;
+   rpt_title("Elapsed time by operation type (milliseconds):", depth);
+   rpt_vstring(d1, "%-15s %5s %9s %9s %9s %9s %9s %9s",
+         "Operation", "Count", "Total", "Syscalls", "Spec", "DSA2", "Retry", "Overhead");
+   rpt_vstring(d1, "%-15s %5s %9s %9s %9s %9s %9s %9s",
+         "",          "",      "",      "",         "sleep", "sleep", "sleep", "");
+   g_mutex_lock(&operation_times_mutex);
+   bool found = false;
+   for (int ndx = 0; ndx < TIMED_OPERATION_TYPE_CT; ndx++) {
+      Operation_Time_Breakdown * cur = &breakdowns[ndx];
+      if (cur->operation_ct == 0)
+         continue;
+      found = true;
+      uint64_t accounted_nanos = 0;
+      for (int cndx = 0; cndx < OPERATION_TIME_COMPONENT_CT; cndx++)
+         accounted_nanos += cur->component_nanos[cndx];
+      uint64_t overhead_nanos =
+            (cur->total_nanos > accounted_nanos) ? cur->total_nanos - accounted_nanos : 0;
+      rpt_vstring(d1, "%-15s %5d %9"PRIu64" %9"PRIu64" %9"PRIu64" %9"PRIu64" %9"PRIu64" %9"PRIu64,
+            timed_operation_names[ndx],
+            cur->operation_ct,
+            cur->total_nanos / (1000*1000),
+            cur->component_nanos[OPTIME_SYSCALL]     / (1000*1000),
+            cur->component_nanos[OPTIME_SPEC_SLEEP]  / (1000*1000),
+            cur->component_nanos[OPTIME_DSA2_SLEEP]  / (1000*1000),
+            cur->component_nanos[OPTIME_RETRY_SLEEP] / (1000*1000),
+            overhead_nanos / (1000*1000));
+   }
+   g_mutex_unlock(&operation_times_mutex);
+   if (!found)
+      rpt_vstring(d1, "No operations recorded");
+}
+
+
+static void
+reset_operation_times() {
+   g_mutex_lock(&operation_times_mutex);
+   memset(operation_times, 0, sizeof(operation_times));
+   g_mutex_unlock(&operation_times_mutex);
+}
+
+
 //
 // Module initialization
 //
@@ -616,6 +843,7 @@ void reset_execution_stats() {
    reset_sleep_event_counts();
    reset_status_code_counts();
    reset_io_event_stats();
+   reset_operation_times();
 
    g_mutex_lock(&global_stats_mutex);
    resettable_start_timestamp = cur_realtime_nanosec();
@@ -649,6 +877,8 @@ void report_elapsed_stats(int depth) {
          "Total elapsed milliseconds (nanoseconds):          %10"PRIu64"  (%13"PRIu64")",
          elapsed_nanos / (1000*1000),
          elapsed_nanos);
+   rpt_nl();
+   report_operation_time_breakdown(NULL, depth);
 }
 
 void report_elapsed_summary(int depth) {
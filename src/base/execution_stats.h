@@ -57,6 +57,7 @@ void log_io_call(
         const char *         location,
         uint64_t             start_time_nanos,
         uint64_t             end_time_nanos);
+void log_io_call_avoided(const IO_Event_Type event_type);
 
 #define RECORD_IO_EVENT(_fd, _event_type, _cmd_to_time)  { \
    uint64_t _start_time = cur_realtime_nanosec(); \
@@ -94,6 +95,45 @@ void record_sleep_event(Sleep_Event_Type event_type);
 
 void report_execution_stats(int depth);
 
+
+// Per-operation elapsed time breakdown
+
+/** Operation types for which elapsed time is broken down */
+typedef enum {
+   OPTIME_GETVCP,
+   OPTIME_SETVCP,
+   OPTIME_CAPABILITIES,
+   OPTIME_TABLE_READ,
+   OPTIME_INITIAL_CHECKS
+} Timed_Operation_Type;
+#define TIMED_OPERATION_TYPE_CT (OPTIME_INITIAL_CHECKS+1)
+
+/** Components of an operation's elapsed time.
+ *  Time not accounted for by any component is reported as overhead.
+ */
+typedef enum {
+   OPTIME_SYSCALL,         ///< ioctl(), read(), write(), open(), close() calls
+   OPTIME_SPEC_SLEEP,      ///< sleep time specified by the DDC/CI spec
+   OPTIME_DSA2_SLEEP,      ///< sleep time added by multiplier and dynamic sleep adjustment
+   OPTIME_RETRY_SLEEP      ///< sleeps in tries after the first
+} Operation_Time_Component;
+#define OPERATION_TIME_COMPONENT_CT (OPTIME_RETRY_SLEEP+1)
+
+typedef struct {
+   int      operation_ct;
+   uint64_t total_nanos;
+   uint64_t component_nanos[OPERATION_TIME_COMPONENT_CT];
+} Operation_Time_Breakdown;
+
+bool optime_start(Timed_Operation_Type optype);
+void optime_end(bool started, Operation_Time_Breakdown * per_display_breakdowns);
+void optime_add(Operation_Time_Component component, uint64_t nanos);
+void optime_retry_begin();
+void optime_retry_end();
+bool optime_in_retry();
+const char * optime_current_operation_name();
+void report_operation_time_breakdown(Operation_Time_Breakdown * breakdowns, int depth);
+
 void terminate_execution_stats();
 
 #endif /* EXECUTION_STATS_H_ */
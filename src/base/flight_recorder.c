@@ -0,0 +1,208 @@
+/** @file flight_recorder.c
+ *
+ *  Always-on record of the most recent DDC transactions.
+ *
+ *  Full tracing changes timing enough that intermittent failures can
+ *  disappear when it is turned on.  Instead, each DDC exchange is recorded
+ *  in a fixed size ring buffer that is cheap enough to maintain at all times.
+ *  Recording performs no allocation and takes no locks.  Each slot is a
+ *  sequence lock: the writer clears the sequence number, writes the fields,
+ *  then publishes the sequence number with release semantics.  A reader
+ *  loads the sequence number with acquire semantics before and after copying
+ *  the fields, and skips slots that were overwritten while being copied.
+ *
+ *  The contents are reported when a DDC operation ultimately fails and
+ *  by ddca_report_error_detail().
+ */
+
+// Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "config.h"
+
+/** \cond */
+#include <assert.h>
+#include <glib-2.0/glib.h>
+#include <string.h>
+/** \endcond */
+
+#include "util/report_util.h"
+#include "util/timestamp.h"
+
+#include "base/core.h"
+#include "base/status_code_mgt.h"
+
+#include "base/flight_recorder.h"
+
+typedef struct {
+   uint64_t  seqno;                  // 0 if slot is empty or being written
+   uint64_t  timestamp_nanos;        // end of exchange
+   uint32_t  duration_micros;
+   int32_t   status;
+   int16_t   busno;
+   uint8_t   opcode;                 // DDC packet type of request
+   uint8_t   expected_subtype;       // e.g. feature code of VCP reply, 0 if no reply
+   uint16_t  tryno;
+   uint16_t  multiplier_hundredths;  // sleep multiplier * 100
+} Flight_Record;
+
+static Flight_Record frec_ring[FLIGHT_RECORDER_SIZE];
+static uint64_t      frec_next_seqno = 0;    // seqno of most recently started record
+
+#define STORE_RELAXED(_field, _val) __atomic_store_n(&(_field), (_val), __ATOMIC_RELAXED)
+#define LOAD_RELAXED(_field)        __atomic_load_n(&(_field), __ATOMIC_RELAXED)
+
+
+/** Records a DDC exchange.
+ *
+ *  @param  busno             I2C bus number
+ *  @param  opcode            DDC request type, e.g. DDC_PACKET_TYPE_QUERY_VCP_REQUEST
+ *  @param  expected_subtype  expected subtype of the reply, 0 if no reply expected
+ *  @param  status            status code of the exchange
+ *  @param  tryno             try number, 1 based
+ *  @param  sleep_multiplier  adjusted sleep multiplier in effect
+ *  @param  duration_nanos    elapsed time of the exchange
+ */
+void frec_record(
+      int      busno,
+      Byte     opcode,
+      Byte     expected_subtype,
+      int      status,
+      int      tryno,
+      float    sleep_multiplier,
+      uint64_t duration_nanos)
+{
+   uint64_t seqno = __atomic_add_fetch(&frec_next_seqno, 1, __ATOMIC_RELAXED);
+   Flight_Record * rec = &frec_ring[(seqno-1) & (FLIGHT_RECORDER_SIZE-1)];
+
+   STORE_RELAXED(rec->seqno,                 0);
+   __atomic_thread_fence(__ATOMIC_RELEASE);   // seqno cleared before fields change
+   STORE_RELAXED(rec->timestamp_nanos,       cur_realtime_nanosec());
+   STORE_RELAXED(rec->duration_micros,       (uint32_t) (duration_nanos/1000));
+   STORE_RELAXED(rec->status,                status);
+   STORE_RELAXED(rec->busno,                 (int16_t) busno);
+   STORE_RELAXED(rec->opcode,                opcode);
+   STORE_RELAXED(rec->expected_subtype,      expected_subtype);
+   STORE_RELAXED(rec->tryno,                 (uint16_t) tryno);
+   STORE_RELAXED(rec->multiplier_hundredths, (uint16_t) (sleep_multiplier * 100 + 0.5));
+   __atomic_store_n(&rec->seqno, seqno, __ATOMIC_RELEASE);
+}
+
+
+/** Copies a slot.
+ *
+ *  @param  slot_ndx        index in ring buffer
+ *  @param  expected_seqno  sequence number the slot should contain
+ *  @param  copy            where to copy the slot contents
+ *  @return true if the copy is consistent, false if the slot is empty
+ *          or was overwritten while being copied
+ */
+static bool
+copy_slot(int slot_ndx, uint64_t expected_seqno, Flight_Record * copy) {
+   Flight_Record * rec = &frec_ring[slot_ndx];
+   if (__atomic_load_n(&rec->seqno, __ATOMIC_ACQUIRE) != expected_seqno)
+      return false;
+   copy->timestamp_nanos       = LOAD_RELAXED(rec->timestamp_nanos);
+   copy->duration_micros       = LOAD_RELAXED(rec->duration_micros);
+   copy->status                = LOAD_RELAXED(rec->status);
+   copy->busno                 = LOAD_RELAXED(rec->busno);
+   copy->opcode                = LOAD_RELAXED(rec->opcode);
+   copy->expected_subtype      = LOAD_RELAXED(rec->expected_subtype);
+   copy->tryno                 = LOAD_RELAXED(rec->tryno);
+   copy->multiplier_hundredths = LOAD_RELAXED(rec->multiplier_hundredths);
+   copy->seqno = expected_seqno;
+   __atomic_thread_fence(__ATOMIC_ACQUIRE);   // fields read before seqno is rechecked
+   return LOAD_RELAXED(rec->seqno) == expected_seqno;
+}
+
+
+/** Collects a consistent snapshot of the ring buffer, oldest first.
+ *
+ *  @param  busno       if >= 0, only collect records for this bus
+ *  @param  max_entries maximum number of records to collect
+ *  @param  snapshot    array of at least FLIGHT_RECORDER_SIZE entries
+ *  @return number of records collected
+ */
+static int
+take_snapshot(int busno, int max_entries, Flight_Record * snapshot) {
+   if (max_entries > FLIGHT_RECORDER_SIZE)
+      max_entries = FLIGHT_RECORDER_SIZE;
+   uint64_t newest = LOAD_RELAXED(frec_next_seqno);
+   uint64_t oldest = (newest > FLIGHT_RECORDER_SIZE) ? newest - FLIGHT_RECORDER_SIZE + 1 : 1;
+
+   // walk backwards from the newest record, then reverse
+   int ct = 0;
+   for (uint64_t seqno = newest; seqno >= oldest && seqno > 0 && ct < max_entries; seqno--) {
+      Flight_Record cur;
+      if (!copy_slot((seqno-1) & (FLIGHT_RECORDER_SIZE-1), seqno, &cur))
+         continue;
+      if (busno >= 0 && cur.busno != busno)
+         continue;
+      snapshot[ct++] = cur;
+   }
+   for (int ndx = 0; ndx < ct/2; ndx++) {
+      Flight_Record temp = snapshot[ndx];
+      snapshot[ndx] = snapshot[ct-1-ndx];
+      snapshot[ct-1-ndx] = temp;
+   }
+   return ct;
+}
+
+
+/** Returns a one line summary of recent exchanges on a bus, for
+ *  inclusion in an #Error_Info detail.
+ *
+ *  @param  busno        I2C bus number
+ *  @param  max_entries  maximum number of exchanges to include
+ *  @return summary string, caller must free, NULL if no exchanges recorded
+ */
+char * frec_summary_by_busno(int busno, int max_entries) {
+   Flight_Record snapshot[FLIGHT_RECORDER_SIZE];
+   int ct = take_snapshot(busno, max_entries, snapshot);
+   if (ct == 0)
+      return NULL;
+
+   GString * buf = g_string_sized_new(80*ct);
+   g_string_append_printf(buf, "Recent exchanges on bus %d:", busno);
+   for (int ndx = 0; ndx < ct; ndx++) {
+      Flight_Record * cur = &snapshot[ndx];
+      g_string_append_printf(buf, " [op=0x%02x/0x%02x try=%d %s mult=%d.%02d %d.%03dms]",
+            cur->opcode, cur->expected_subtype, cur->tryno, psc_name(cur->status),
+            cur->multiplier_hundredths/100, cur->multiplier_hundredths%100,
+            cur->duration_micros/1000, cur->duration_micros%1000);
+   }
+   return g_string_free(buf, false);
+}
+
+
+/** Reports the contents of the flight recorder, oldest exchange first.
+ *
+ *  @param  depth  logical indentation depth
+ */
+void frec_report(int depth) {
+   Flight_Record snapshot[FLIGHT_RECORDER_SIZE];
+   int ct = take_snapshot(-1, FLIGHT_RECORDER_SIZE, snapshot);
+   if (ct == 0) {
+      rpt_vstring(depth, "Recent DDC exchanges: None");
+      return;
+   }
+   uint64_t now = cur_realtime_nanosec();
+   rpt_vstring(depth, "Recent DDC exchanges (most recent last):");
+   rpt_vstring(depth+1, "Ago (ms)  Bus  Opcode  Subtype  Try  Multiplier  Duration (ms)  Status");
+   for (int ndx = 0; ndx < ct; ndx++) {
+      Flight_Record * cur = &snapshot[ndx];
+      rpt_vstring(depth+1, "%8"PRIu64"  %3d  0x%02x    0x%02x     %3d  %5d.%02d    %6d.%03d     %s",
+            (now > cur->timestamp_nanos) ? (now - cur->timestamp_nanos) / (1000*1000) : 0,
+            cur->busno, cur->opcode, cur->expected_subtype, cur->tryno,
+            cur->multiplier_hundredths/100, cur->multiplier_hundredths%100,
+            cur->duration_micros/1000, cur->duration_micros%1000,
+            psc_name_code(cur->status));
+   }
+}
+
+
+/** Discards all records. */
+void frec_reset() {
+   for (int ndx = 0; ndx < FLIGHT_RECORDER_SIZE; ndx++)
+      STORE_RELAXED(frec_ring[ndx].seqno, 0);
+}
@@ -0,0 +1,31 @@
+/** @file flight_recorder.h
+ *
+ *  Always-on record of the most recent DDC transactions.
+ */
+
+// Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef FLIGHT_RECORDER_H_
+#define FLIGHT_RECORDER_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "util/coredefs_base.h"
+
+#define FLIGHT_RECORDER_SIZE 256     // must be a power of 2
+
+void   frec_record(
+          int      busno,
+          Byte     opcode,
+          Byte     expected_subtype,
+          int      status,
+          int      tryno,
+          float    sleep_multiplier,
+          uint64_t duration_nanos);
+char * frec_summary_by_busno(int busno, int max_entries);
+void   frec_report(int depth);
+void   frec_reset();
+
+#endif /* FLIGHT_RECORDER_H_ */
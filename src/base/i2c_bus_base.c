@@ -12,14 +12,17 @@
 #include "config.h"
 
 #include "util/coredefs.h"
+#include "util/data_structures.h"
 #include "util/edid.h"
 
 #include "util/glib_string_util.h"
 #include "util/report_util.h"
 #include "util/string_util.h"
 #include "util/sysfs_util.h"
+#include "util/timestamp.h"
 
 #include "core.h"
+#include "parms.h"
 #include "rtti.h"
 
 #include "i2c/i2c_sysfs.h"
@@ -117,6 +120,7 @@ void i2c_reset_bus_info(I2C_Bus_Info * bus_info) {
    assert(bus_info);
    DBGTRC_STARTING(debug, TRACE_GROUP, "businfo=%p, busno = %d", bus_info, bus_info->busno);
    bus_info->flags = I2C_BUS_VALID_NAME_CHECKED | I2C_BUS_HAS_VALID_NAME;
+   memset(&bus_info->connected_cache, 0, sizeof(I2C_State_Cache));
    if (i2c_device_exists(bus_info->busno))
       bus_info->flags |= I2C_BUS_EXISTS;
    if (bus_info->edid) {
@@ -322,6 +326,7 @@ void  i2c_update_bus_info(I2C_Bus_Info * existing, I2C_Bus_Info* new) {
       }
    }
    existing->last_checked_dpms_asleep = new->last_checked_dpms_asleep;
+   memset(&existing->connected_cache, 0, sizeof(I2C_State_Cache));
 
    if ( IS_DBGTRC(debug, DDCA_TRC_NONE)) {
       DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Updated bus info:");
@@ -335,17 +340,36 @@ void  i2c_update_bus_info(I2C_Bus_Info * existing, I2C_Bus_Info* new) {
 // Generic Bus_Info retrieval
 //
 
+static Ptr_Array_Index * all_i2c_buses_index = NULL;   // by busno, for all_i2c_buses
+
+static bool businfo_busno_key(gconstpointer element, gpointer * key_loc) {
+   const I2C_Bus_Info * businfo = element;
+   *key_loc = GINT_TO_POINTER(businfo->busno);
+   return true;
+}
+
+static bool businfo_busno_match(gconstpointer element, gconstpointer key) {
+   const I2C_Bus_Info * businfo = element;
+   return businfo->busno == GPOINTER_TO_INT(key);
+}
+
+
 I2C_Bus_Info *
 i2c_find_bus_info_in_gptrarray_by_busno(GPtrArray * buses, int busno) {
    bool debug = false;
    DBGMSF(debug, "Starting. busno=%d", busno);
 
    I2C_Bus_Info * result = NULL;
-   for (int ndx = 0; ndx < buses->len; ndx++) {
-      I2C_Bus_Info * cur_info = g_ptr_array_index(all_i2c_buses, ndx);
-      if (cur_info->busno == busno) {
-         result = cur_info;
-         break;
+   if (buses == all_i2c_buses && all_i2c_buses_index) {
+      result = pai_lookup(all_i2c_buses_index, buses, GINT_TO_POINTER(busno));
+   }
+   else {
+      for (int ndx = 0; ndx < buses->len; ndx++) {
+         I2C_Bus_Info * cur_info = g_ptr_array_index(buses, ndx);
+         if (cur_info->busno == busno) {
+            result = cur_info;
+            break;
+         }
       }
    }
 
@@ -360,7 +384,7 @@ int   i2c_find_bus_info_index_in_gptrarray_by_busno(GPtrArray * buses, int busno
 
    int result = -1;
    for (int ndx = 0; ndx < buses->len; ndx++) {
-      I2C_Bus_Info * cur_info = g_ptr_array_index(all_i2c_buses, ndx);
+      I2C_Bus_Info * cur_info = g_ptr_array_index(buses, ndx);
       if (cur_info->busno == busno) {
          result = ndx;
          break;
@@ -390,7 +414,9 @@ I2C_Bus_Info * i2c_find_bus_info_by_busno(int busno) {
    bool debug = false;
    DBGMSF(debug, "Starting. busno=%d", busno);
 
-   I2C_Bus_Info * result = i2c_find_bus_info_in_gptrarray_by_busno(all_i2c_buses, busno);
+   I2C_Bus_Info * result = (all_i2c_buses)
+                              ? i2c_find_bus_info_in_gptrarray_by_busno(all_i2c_buses, busno)
+                              : NULL;
 
    DBGMSF(debug, "Done.     Returning: %p", result);
    return result;
@@ -518,6 +544,74 @@ int i2c_device_count() {
 
 
 
+//
+// Display state cache
+//
+
+/** Event classes currently monitored by the watch thread */
+DDCA_Display_Event_Class i2c_watched_event_classes = DDCA_EVENT_CLASS_NONE;
+int i2c_state_cache_ttl_millisec = DEFAULT_I2C_STATE_CACHE_TTL_MILLISEC;
+
+static gint   display_state_generation = 1;
+static GMutex state_cache_mutex;
+
+
+/** Discards all cached display state checks.
+ *
+ *  Called when a hotplug or DPMS change is detected.
+ */
+void i2c_note_display_state_change() {
+   g_atomic_int_inc(&display_state_generation);
+}
+
+
+/** Retrieves a cached display state check result.
+ *
+ *  @param  cache                 cache
+ *  @param  invalidating_classes  event classes that can change the result
+ *  @param  status_loc            where to return the cached result
+ *  @return true if a current cached value exists, false if not
+ */
+bool i2c_state_cache_lookup(
+      I2C_State_Cache *        cache,
+      DDCA_Display_Event_Class invalidating_classes,
+      int *                    status_loc)
+{
+   bool debug = false;
+   bool found = false;
+   g_mutex_lock(&state_cache_mutex);
+   if (cache->checked_nanos > 0 &&
+       cache->generation == g_atomic_int_get(&display_state_generation))
+   {
+      if ((i2c_watched_event_classes & invalidating_classes) == invalidating_classes ||
+          cur_realtime_nanosec() - cache->checked_nanos <
+                (uint64_t) i2c_state_cache_ttl_millisec * (1000*1000) )
+      {
+         *status_loc = cache->status;
+         found = true;
+      }
+   }
+   g_mutex_unlock(&state_cache_mutex);
+   DBGTRC_EXECUTED(debug, TRACE_GROUP, "cache=%p, Returning %s, *status_loc=%d",
+         cache, SBOOL(found), (found) ? *status_loc : 0);
+   return found;
+}
+
+
+/** Saves the result of a display state check.
+ *
+ *  @param  cache   cache
+ *  @param  status  result to save
+ */
+void i2c_state_cache_save(I2C_State_Cache * cache, int status) {
+   g_mutex_lock(&state_cache_mutex);
+   cache->checked_nanos = cur_realtime_nanosec();
+   cache->generation = g_atomic_int_get(&display_state_generation);
+   cache->status = status;
+   g_mutex_unlock(&state_cache_mutex);
+}
+
+
 /** Module initialization. */
 void init_i2c_bus_base() {
    RTTI_ADD_FUNC(i2c_dbgrpt_buses);
@@ -527,6 +621,15 @@ void init_i2c_bus_base() {
    RTTI_ADD_FUNC(i2c_reset_bus_info);
    RTTI_ADD_FUNC(i2c_update_bus_info);
 
+   all_i2c_buses_index = pai_new(g_direct_hash, g_direct_equal, NULL,
+                                 businfo_busno_key, businfo_busno_match);
    // connected_buses = EMPTY_BIT_SET_256;
 }
 
+
+/** Module termination. */
+void terminate_i2c_bus_base() {
+   pai_free(all_i2c_buses_index);
+   all_i2c_buses_index = NULL;
+}
+
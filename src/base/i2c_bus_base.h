@@ -8,9 +8,12 @@
 #ifndef I2C_BUS_BASE_H_
 #define I2C_BUS_BASE_H_
 
+#include <inttypes.h>
 #include <stdbool.h>
 #include <glib-2.0/glib.h>
 
+#include "public/ddcutil_types.h"
+
 #include "util/data_structures.h"
 #include "util/edid.h"
 
@@ -44,6 +47,18 @@ typedef enum {
 
 const char * drm_connector_found_by_name(Drm_Connector_Found_By found_by);
 
+/** Cached result of a check of display state, e.g. whether connected.
+ *
+ *  A cached value is discarded when a display state change is noted.  If
+ *  the watch thread is not monitoring the relevant class of change, a cached
+ *  value also expires after #i2c_state_cache_ttl_millisec.
+ */
+typedef struct {
+   uint64_t         checked_nanos;      ///< when checked, 0 if no cached value
+   int              generation;         ///< display state generation when checked
+   int              status;             ///< result of check
+} I2C_State_Cache;
+
 #define I2C_BUS_INFO_MARKER "BINF"
 /** Information about one I2C bus */
 typedef
@@ -59,6 +74,7 @@ struct {
    Drm_Connector_Found_By
                     drm_connector_found_by;
    bool             last_checked_dpms_asleep;
+   I2C_State_Cache  connected_cache;    ///< cached sysfs connector status check
 } I2C_Bus_Info;
 
 char *           i2c_interpret_bus_flags(uint16_t flags);
@@ -80,6 +96,15 @@ void             i2c_free_bus_info(I2C_Bus_Info * businfo);
 void             i2c_update_bus_info(I2C_Bus_Info * existing, I2C_Bus_Info* new_info);
 void             i2c_reset_bus_info(I2C_Bus_Info * bus_info);
 
+// Display state cache
+extern DDCA_Display_Event_Class i2c_watched_event_classes;
+extern int       i2c_state_cache_ttl_millisec;
+void             i2c_note_display_state_change();
+bool             i2c_state_cache_lookup(I2C_State_Cache * cache,
+                                        DDCA_Display_Event_Class invalidating_classes,
+                                        int * status_loc);
+void             i2c_state_cache_save(I2C_State_Cache * cache, int status);
+
 // Generalized Bus_Info retrieval
 I2C_Bus_Info *   i2c_find_bus_info_in_gptrarray_by_busno(GPtrArray * buses, int busno);
 int              i2c_find_bus_info_index_in_gptrarray_by_busno(GPtrArray * buses, int busno);
@@ -103,5 +128,6 @@ int              i2c_device_count();           // simple /dev/i2c-n count, no si
 
 // Initialization
 void init_i2c_bus_base();
+void terminate_i2c_bus_base();
 
 #endif /* I2C_BUS_BASE_H_ */
@@ -0,0 +1,251 @@
+/** @file lock_stats.c
+ *
+ *  Wait time and hold time statistics for locks that can serialize
+ *  operations on displays.
+ *
+ *  When multiple threads or processes access the same displays, part of
+ *  the latency of an operation is time spent queueing for a lock rather
+ *  than time spent performing I/O.  For each lock, this module maintains
+ *  histograms of wait and hold times, and the callers that spent the most
+ *  time waiting.
+ */
+
+// Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/** \cond */
+#include <assert.h>
+#include <glib-2.0/glib.h>
+#include <string.h>
+/** \endcond */
+
+#include "util/report_util.h"
+
+#include "base/lock_stats.h"
+
+#define LOCK_STATS_BUCKET_CT  7
+#define LOCK_STATS_TOP_CALLERS 5
+
+static const char * lock_names[] = {
+      "Display lock",
+      "flock()",
+      "Cross display operation",
+      "Cross thread operation"
+};
+
+// upper bounds of histogram buckets, the last bucket is unbounded
+static const uint64_t bucket_limit_nanos[LOCK_STATS_BUCKET_CT-1] = {
+      10*1000,              //  10 microsec
+      100*1000,             // 100 microsec
+      1000*1000,            //   1 millisec
+      10*1000*1000,         //  10 millisec
+      100*1000*1000,        // 100 millisec
+      1000*1000*1000,       //   1 sec
+};
+
+static const char * bucket_names[LOCK_STATS_BUCKET_CT] = {
+      "<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s"
+};
+
+typedef struct {
+   int      ct;
+   uint64_t total_nanos;
+   uint64_t max_nanos;
+   int      buckets[LOCK_STATS_BUCKET_CT];
+} Lock_Time_Histogram;
+
+typedef struct {
+   Lock_Time_Histogram wait;
+   Lock_Time_Histogram hold;
+   Lock_Time_Histogram handoff;            // release by previous holder until acquisition
+   GHashTable *        waits_by_caller;    // caller name -> Caller_Wait_Stats
+} Lock_Stats;
+
+typedef struct {
+   const char * caller;                    // points to hash table key
+   int          ct;
+   uint64_t     total_nanos;
+   uint64_t     max_nanos;
+} Caller_Wait_Stats;
+
+static Lock_Stats lock_stats[LOCK_STATS_ID_CT];
+static GMutex     lock_stats_mutex;
+
+
+static void
+histogram_add(Lock_Time_Histogram * histogram, uint64_t nanos) {
+   int ndx = 0;
+   while (ndx < LOCK_STATS_BUCKET_CT-1 && nanos >= bucket_limit_nanos[ndx])
+      ndx++;
+   histogram->buckets[ndx]++;
+   histogram->ct++;
+   histogram->total_nanos += nanos;
+   if (nanos > histogram->max_nanos)
+      histogram->max_nanos = nanos;
+}
+
+
+/** Records the time spent waiting to acquire a lock.
+ *
+ *  @param  lock_id     lock
+ *  @param  caller      name of waiting function or operation, NULL if unknown
+ *  @param  wait_nanos  wait time
+ */
+void lock_stats_record_wait(Lock_Stats_Id lock_id, const char * caller, uint64_t wait_nanos) {
+   assert(lock_id >= 0 && lock_id < LOCK_STATS_ID_CT);
+   if (!caller)
+      caller = "unknown";
+
+   g_mutex_lock(&lock_stats_mutex);
+   Lock_Stats * stats = &lock_stats[lock_id];
+   histogram_add(&stats->wait, wait_nanos);
+   if (stats->waits_by_caller) {
+      Caller_Wait_Stats * cstats = g_hash_table_lookup(stats->waits_by_caller, caller);
+      if (!cstats) {
+         char * key = g_strdup(caller);
+         cstats = g_new0(Caller_Wait_Stats, 1);
+         cstats->caller = key;
+         g_hash_table_insert(stats->waits_by_caller, key, cstats);
+      }
+      cstats->ct++;
+      cstats->total_nanos += wait_nanos;
+      if (wait_nanos > cstats->max_nanos)
+         cstats->max_nanos = wait_nanos;
+   }
+   g_mutex_unlock(&lock_stats_mutex);
+}
+
+
+/** Records the time a lock was held.
+ *
+ *  @param  lock_id     lock
+ *  @param  hold_nanos  time from acquisition to release
+ */
+void lock_stats_record_hold(Lock_Stats_Id lock_id, uint64_t hold_nanos) {
+   assert(lock_id >= 0 && lock_id < LOCK_STATS_ID_CT);
+   g_mutex_lock(&lock_stats_mutex);
+   histogram_add(&lock_stats[lock_id].hold, hold_nanos);
+   g_mutex_unlock(&lock_stats_mutex);
+}
+
+
+/** Records the latency from the release of a contended lock by its previous
+ *  holder until its acquisition by a waiter.
+ *
+ *  @param  lock_id        lock
+ *  @param  handoff_nanos  handoff latency
+ */
+void lock_stats_record_handoff(Lock_Stats_Id lock_id, uint64_t handoff_nanos) {
+   assert(lock_id >= 0 && lock_id < LOCK_STATS_ID_CT);
+   g_mutex_lock(&lock_stats_mutex);
+   histogram_add(&lock_stats[lock_id].handoff, handoff_nanos);
+   g_mutex_unlock(&lock_stats_mutex);
+}
+
+
+static void
+report_histogram(const char * title, Lock_Time_Histogram * histogram, int depth) {
+   rpt_vstring(depth, "%-8s count: %6d, total: %7"PRIu64" ms, avg: %7.3f ms, max: %7.3f ms",
+         title,
+         histogram->ct,
+         histogram->total_nanos / (1000*1000),
+         (histogram->ct > 0) ? (histogram->total_nanos / (double) histogram->ct) / (1000*1000) : 0.0,
+         histogram->max_nanos / (1000.0*1000));
+   char buf[200];
+   int pos = 0;
+   for (int ndx = 0; ndx < LOCK_STATS_BUCKET_CT; ndx++)
+      pos += g_snprintf(buf+pos, sizeof(buf)-pos, " %s:%d", bucket_names[ndx], histogram->buckets[ndx]);
+   rpt_vstring(depth+1, "%s", buf);
+}
+
+
+static gint
+compare_caller_total_wait(gconstpointer a, gconstpointer b) {
+   const Caller_Wait_Stats * ca = *(Caller_Wait_Stats **) a;
+   const Caller_Wait_Stats * cb = *(Caller_Wait_Stats **) b;
+   if (ca->total_nanos == cb->total_nanos)
+      return 0;
+   return (ca->total_nanos > cb->total_nanos) ? -1 : 1;
+}
+
+
+/** Reports lock wait and hold time statistics.
+ *
+ *  @param  depth  logical indentation depth
+ */
+void report_lock_stats(int depth) {
+   int d1 = depth+1;
+   int d2 = depth+2;
+   int d3 = depth+3;
+   rpt_title("Lock contention statistics:", depth);
+
+   g_mutex_lock(&lock_stats_mutex);
+   for (int lock_id = 0; lock_id < LOCK_STATS_ID_CT; lock_id++) {
+      Lock_Stats * stats = &lock_stats[lock_id];
+      rpt_vstring(d1, "%s:", lock_names[lock_id]);
+      if (stats->wait.ct == 0 && stats->hold.ct == 0) {
+         rpt_vstring(d2, "Not used");
+         continue;
+      }
+      report_histogram("Wait", &stats->wait, d2);
+      report_histogram("Hold", &stats->hold, d2);
+      if (stats->handoff.ct > 0)
+         report_histogram("Handoff", &stats->handoff, d2);
+
+      if (stats->waits_by_caller && g_hash_table_size(stats->waits_by_caller) > 0) {
+         GPtrArray * callers = g_ptr_array_new();
+         GHashTableIter iter;
+         gpointer key, value;
+         g_hash_table_iter_init(&iter, stats->waits_by_caller);
+         while (g_hash_table_iter_next(&iter, &key, &value))
+            g_ptr_array_add(callers, value);
+         g_ptr_array_sort(callers, compare_caller_total_wait);
+
+         rpt_vstring(d2, "Top waiting callers:");
+         rpt_vstring(d3, "%-40s %6s %10s %10s", "Caller", "Count", "Total ms", "Max ms");
+         for (int ndx = 0; ndx < callers->len && ndx < LOCK_STATS_TOP_CALLERS; ndx++) {
+            Caller_Wait_Stats * cur = g_ptr_array_index(callers, ndx);
+            rpt_vstring(d3, "%-40s %6d %10.3f %10.3f",
+                  cur->caller, cur->ct,
+                  cur->total_nanos / (1000.0*1000),
+                  cur->max_nanos / (1000.0*1000));
+         }
+         g_ptr_array_free(callers, true);
+      }
+   }
+   g_mutex_unlock(&lock_stats_mutex);
+}
+
+
+/** Discards all lock statistics. */
+void reset_lock_stats() {
+   g_mutex_lock(&lock_stats_mutex);
+   for (int lock_id = 0; lock_id < LOCK_STATS_ID_CT; lock_id++) {
+      Lock_Stats * stats = &lock_stats[lock_id];
+      memset(&stats->wait, 0, sizeof(stats->wait));
+      memset(&stats->hold, 0, sizeof(stats->hold));
+      memset(&stats->handoff, 0, sizeof(stats->handoff));
+      if (stats->waits_by_caller)
+         g_hash_table_remove_all(stats->waits_by_caller);
+   }
+   g_mutex_unlock(&lock_stats_mutex);
+}
+
+
+void init_lock_stats() {
+   for (int lock_id = 0; lock_id < LOCK_STATS_ID_CT; lock_id++)
+      lock_stats[lock_id].waits_by_caller =
+            g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+}
+
+
+void terminate_lock_stats() {
+   g_mutex_lock(&lock_stats_mutex);
+   for (int lock_id = 0; lock_id < LOCK_STATS_ID_CT; lock_id++) {
+      if (lock_stats[lock_id].waits_by_caller) {
+         g_hash_table_destroy(lock_stats[lock_id].waits_by_caller);
+         lock_stats[lock_id].waits_by_caller = NULL;
+      }
+   }
+   g_mutex_unlock(&lock_stats_mutex);
+}
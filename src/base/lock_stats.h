@@ -0,0 +1,34 @@
+/** @file lock_stats.h
+ *
+ *  Wait time and hold time statistics for locks that can serialize
+ *  operations on displays.
+ */
+
+// Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef LOCK_STATS_H_
+#define LOCK_STATS_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+/** Locks for which statistics are collected */
+typedef enum {
+   LOCK_STATS_DISPLAY,            ///< per-display lock, lock_display()
+   LOCK_STATS_FLOCK,              ///< cross-instance flock() on /dev/i2c device
+   LOCK_STATS_CROSS_DISPLAY,      ///< Per_Display_Data cross display operation
+   LOCK_STATS_CROSS_THREAD        ///< Per_Thread_Data cross thread operation
+} Lock_Stats_Id;
+#define LOCK_STATS_ID_CT (LOCK_STATS_CROSS_THREAD+1)
+
+void lock_stats_record_wait(Lock_Stats_Id lock_id, const char * caller, uint64_t wait_nanos);
+void lock_stats_record_hold(Lock_Stats_Id lock_id, uint64_t hold_nanos);
+void lock_stats_record_handoff(Lock_Stats_Id lock_id, uint64_t handoff_nanos);
+void report_lock_stats(int depth);
+void reset_lock_stats();
+
+void init_lock_stats();
+void terminate_lock_stats();
+
+#endif /* LOCK_STATS_H_ */
@@ -99,6 +99,8 @@
 /** Parallelize DDC communication checks if three are least this number of /dev/i2c devices having an EDID */
 // on banner with 4 displays, async  detect: 1.7 sec, non-async 3.4 sec
 #define DEFAULT_DDC_CHECK_ASYNC_THRESHOLD 3
+/** Maximum number of threads used for parallel bus and DDC communication checks */
+#define DEFAULT_WORK_POOL_MAX_WORKERS 8
 
 
 //
@@ -110,6 +112,28 @@
 
 #define DEFAULT_FLOCK_POLL_MILLISEC      500
 #define DEFAULT_FLOCK_MAX_WAIT_MILLISEC 3000
+/** Wait for cross-instance locks using a blocking flock() instead of polling */
+#define DEFAULT_FLOCK_BLOCKING_WAIT      true
+/** Maximum wait for a display lock held by another thread, 0 = no limit */
+#define DEFAULT_DISPLAY_LOCK_MAX_WAIT_MILLISEC 0
+/** Lifetime of cached display state checks when the watch thread is not active */
+#define DEFAULT_I2C_STATE_CACHE_TTL_MILLISEC 1000
+/** Keep /dev/i2c devices opened by libddcutil open between operations */
+#define DEFAULT_ENABLE_I2C_HANDLE_POOL   false
+/** Pooled /dev/i2c devices unused for this long are closed, releasing their flock() */
+#define DEFAULT_I2C_HANDLE_POOL_IDLE_MILLISEC 2000
+/** Redetection reexamines only buses whose DRM connector state changed */
+#define DEFAULT_INCREMENTAL_REDETECTION  false
+/** libddcutil detects a display identified by bus number or EDID without detecting all displays */
+#define DEFAULT_LAZY_DISPLAY_DETECTION   false
+/** Display status event dispatcher merges a disconnect followed by a reconnect */
+#define DEFAULT_COALESCE_DISPLAY_EVENTS  false
+/** Window within which a disconnect and reconnect are merged */
+#define DEFAULT_DOUBLE_TAP_MILLISEC      5000
+/** Capacity of the display status event queue, must be a power of 2 */
+#define DISPLAY_EVENT_QUEUE_SIZE         64
+/** Watch thread learns of DPMS changes from uevents and sysfs notification where the driver supports it */
+#define DEFAULT_DPMS_EVENT_DETECTION     false
 
 /** Maximum number of i2c buses this code supports */
 #define I2C_BUS_MAX 64
@@ -16,11 +16,13 @@
 #include "util/linux_util.h"
 #include "util/report_util.h"
 #include "util/string_util.h"
+#include "util/timestamp.h"
 
 #include "base/core.h"
 #include "base/display_retry_data.h"    // temp circular
 #include "base/displays.h"
 #include "base/dsa2.h"
+#include "base/lock_stats.h"
 #include "base/parms.h"
 #include "base/per_display_data.h"
 #include "base/per_thread_data.h"
@@ -115,9 +117,10 @@ void pdd_unlock_if_needed(bool unlock_requested) {
 }
 
 
-static bool    cross_thread_operation_active = false;
-static GMutex  cross_thread_operation_mutex;
-static pid_t   cross_thread_operation_owner;
+static bool     cross_thread_operation_active = false;
+static GMutex   cross_thread_operation_mutex;
+static pid_t    cross_thread_operation_owner;
+static uint64_t cross_thread_operation_start_nanos;   // for lock hold time statistics
 
 // The locking strategy relies on the fact that in practice conflicts
 // will be rare, and critical sections short.
@@ -151,7 +154,11 @@ bool pdd_cross_display_operation_start(const char * caller) {
    if (display_lock_depth == 0) {    // (A)
    // if (!thread_has_lock) {
       // display_lock_depth is per-thread, so must be unchanged from (A)
+      uint64_t wait_start = cur_realtime_nanosec();
       g_mutex_lock(&cross_thread_operation_mutex);
+      cross_thread_operation_start_nanos = cur_realtime_nanosec();
+      lock_stats_record_wait(LOCK_STATS_CROSS_DISPLAY, caller,
+                             cross_thread_operation_start_nanos - wait_start);
       lock_performed = true;
       cross_thread_operation_active = true;
       pdd_lock_count++;
@@ -184,6 +191,8 @@ void pdd_cross_display_operation_end(const char * caller) {
       cross_thread_operation_owner = 0;
       pdd_unlock_count++;
       assert(pdd_lock_count == pdd_unlock_count);
+      lock_stats_record_hold(LOCK_STATS_CROSS_DISPLAY,
+                             cur_realtime_nanosec() - cross_thread_operation_start_nanos);
       g_mutex_unlock(&cross_thread_operation_mutex);
    }
    else {
@@ -205,9 +214,11 @@ void pdd_cross_display_operation_block(const char * caller) {
    intmax_t cur_displayid = thread_settings->tid;
    if (cross_thread_operation_active && cur_displayid != cross_thread_operation_owner) {
       __sync_fetch_and_add(&pdd_cross_thread_operation_blocked_count, 1);
+      uint64_t wait_start = cur_realtime_nanosec();
       do {
          sleep_millis(10);
       } while (cross_thread_operation_active);
+      lock_stats_record_wait(LOCK_STATS_CROSS_DISPLAY, caller, cur_realtime_nanosec() - wait_start);
    }
 }
 
@@ -598,6 +609,7 @@ void pdd_reset_per_display_data(Per_Display_Data * data, void* arg ) {
          pdd->try_stats[retry_type].counters[ndx] = 0;
       }
    }
+   memset(pdd->op_times, 0, sizeof(pdd->op_times));
 
    DBGTRC_DONE(debug, DDCA_TRC_NONE, "");
 }
@@ -710,6 +722,8 @@ void pdd_report_elapsed(Per_Display_Data * pdd, bool include_dsa_internal, int d
    //    rpt_vstring(d1, "Internal data: (A)");
    // }
    rpt_nl();
+   report_operation_time_breakdown(pdd->op_times, d1);
+   rpt_nl();
 
    if (include_dsa_internal) {
       if (pdd->dsa2_enabled) {
@@ -826,6 +840,17 @@ void  pdd_record_final(Per_Display_Data * pdd, DDCA_Status ddcrc, int tries) {
 }
 
 
+/** Ends a timed operation, accumulating its elapsed time breakdown
+ *  both globally and for the display.
+ *
+ *  @param  pdd      #Per_Display_Data instance, may be NULL
+ *  @param  started  value returned by #optime_start()
+ */
+void pdd_optime_end(Per_Display_Data * pdd, bool started) {
+   optime_end(started, (pdd) ? pdd->op_times : NULL);
+}
+
+
 //
 // Wrappers invoking Per_Display_Data functions by Display_Handle
 //
@@ -858,6 +883,11 @@ void pdd_record_final_by_dh(Display_Handle * dh, DDCA_Status ddcrc, int retries)
 }
 
 
+void pdd_optime_end_by_dh(Display_Handle * dh, bool started) {
+   pdd_optime_end(dh->dref->pdd, started);
+}
+
+
 //
 // Initialization and Termination
 //
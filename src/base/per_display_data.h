@@ -20,6 +20,7 @@
 #include "base/core.h"
 #include "base/parms.h"
 #include "base/displays.h"
+#include "base/execution_stats.h"
 #include "base/stats.h"
 
 // use struct instead of #include "dsa2.h", etc. to avoid circular includes
@@ -59,6 +60,7 @@ typedef struct Per_Display_Data {
    bool                   dsa2_enabled;
    bool                   dynamic_sleep_active;
    bool                   cur_loop_null_adjustment_occurred;
+   Operation_Time_Breakdown op_times[TIMED_OPERATION_TYPE_CT];
 } Per_Display_Data;
 
 // For new displays
@@ -103,12 +105,14 @@ DDCA_Sleep_Multiplier
        pdd_get_adjusted_sleep_multiplier(Per_Display_Data* pdd);
 void   pdd_note_retryable_failure(Per_Display_Data * pdd, DDCA_Status ddcrc, int remaining_tries);
 void   pdd_record_final(Per_Display_Data * pdd, DDCA_Status ddcrc, int retries);
+void   pdd_optime_end(Per_Display_Data * pdd, bool started);
 
 void   pdd_reset_multiplier_by_dh(Display_Handle * dh, DDCA_Sleep_Multiplier multiplier);
 DDCA_Sleep_Multiplier
        pdd_get_sleep_multiplier_by_dh(Display_Handle * dh);
 void   pdd_note_retryable_failure_by_dh(Display_Handle * dh, DDCA_Status ddcrc, int remaining_tries);
 void   pdd_record_final_by_dh(Display_Handle * dh, DDCA_Status ddcrc, int retries);
+void   pdd_optime_end_by_dh(Display_Handle * dh, bool started);
 
 void   init_per_display_data();
 void   terminate_per_display_data();
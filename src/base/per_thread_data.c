@@ -23,6 +23,7 @@
 #include "base/core.h"
 #include "base/core_per_thread_settings.h"
 #include "base/displays.h"
+#include "base/lock_stats.h"
 #include "base/parms.h"
 #include "base/rtti.h"
 #include "base/sleep.h"
@@ -46,9 +47,10 @@ void dbgrpt_per_thread_data_locks(int depth) {
    rpt_vstring(depth, "cross_thread_operation_blocked_count:  %-4d", cross_thread_operation_blocked_count);
 }
 
-static bool    cross_thread_operation_active = false;
-static GMutex  cross_thread_operation_mutex;
-static pid_t   cross_thread_operation_owner;
+static bool     cross_thread_operation_active = false;
+static GMutex   cross_thread_operation_mutex;
+static pid_t    cross_thread_operation_owner;
+static uint64_t cross_thread_operation_start_nanos;   // for lock hold time statistics
 
 // The locking strategy relies on the fact that in practice conflicts
 // will be rare, and critical sections short.
@@ -64,9 +66,12 @@ static pid_t   cross_thread_operation_owner;
 //   These are referred to as cross thread operations.
 //   Alt, perhaps clearer, refer to them as multi-thread data instances.
 
-/**
+/** Starts an operation that involves multiple #Per_Thread_Data instances.
+ *
+ *  @param  caller  name of calling function, for lock statistics
+ *  @return true if the lock was acquired, false if already held by this thread
  */
-bool ptd_cross_thread_operation_start() {
+bool ptd_cross_thread_operation_start(const char * caller) {
    // Only 1 cross thread action can be active at one time.
    // All per_thread actions must wait
 
@@ -85,7 +90,11 @@ bool ptd_cross_thread_operation_start() {
    if (thread_lock_depth == 0) {    // (A)
    // if (!thread_has_lock) {
       // thread_lock_depth is per-thread, so must be unchanged from (A)
+      uint64_t wait_start = cur_realtime_nanosec();
       g_mutex_lock(&cross_thread_operation_mutex);
+      cross_thread_operation_start_nanos = cur_realtime_nanosec();
+      lock_stats_record_wait(LOCK_STATS_CROSS_THREAD, caller,
+                             cross_thread_operation_start_nanos - wait_start);
       lock_performed = true;
       cross_thread_operation_active = true;
 
@@ -119,6 +128,8 @@ void ptd_cross_thread_operation_end() {
       g_private_set(&this_thread_has_lock, false);
       ptd_unlock_count++;
       assert(ptd_lock_count == ptd_unlock_count);
+      lock_stats_record_hold(LOCK_STATS_CROSS_THREAD,
+                             cur_realtime_nanosec() - cross_thread_operation_start_nanos);
       g_mutex_unlock(&cross_thread_operation_mutex);
    }
    else {
@@ -129,17 +140,21 @@ void ptd_cross_thread_operation_end() {
 
 /** Block execution of single Per_Thread_Data operations when an operation
  *  involving multiple Per_Thead_Data instances is active.
+ *
+ *  @param  caller  name of calling function, for lock statistics
  */
 
-void ptd_cross_thread_operation_block() {
+void ptd_cross_thread_operation_block(const char * caller) {
    // intmax_t cur_threadid = get_thread_id();
    Thread_Output_Settings * thread_settings = get_thread_settings();
    intmax_t cur_threadid = thread_settings->tid;
    if (cross_thread_operation_active && cur_threadid != cross_thread_operation_owner) {
       __sync_fetch_and_add(&cross_thread_operation_blocked_count, 1);
+      uint64_t wait_start = cur_realtime_nanosec();
       do {
          sleep_millis(10);
       } while (cross_thread_operation_active);
+      lock_stats_record_wait(LOCK_STATS_CROSS_THREAD, caller, cur_realtime_nanosec() - wait_start);
    }
 }
 
@@ -231,7 +246,7 @@ Per_Thread_Data * ptd_get_per_thread_data() {
 // instance for the currently executing thread.
 
 void ptd_set_thread_description(const char * description) {
-   ptd_cross_thread_operation_block();
+   ptd_cross_thread_operation_block(__func__);
    Per_Thread_Data *  ptd = ptd_get_per_thread_data();
    // DBGMSG("thread: %d, description: %s", ptd->thread_id, description);
    if (ptd->description)
@@ -241,7 +256,7 @@ void ptd_set_thread_description(const char * description) {
 
 
 void ptd_append_thread_description(const char * addl_description) {
-   ptd_cross_thread_operation_block();
+   ptd_cross_thread_operation_block(__func__);
    Per_Thread_Data *  ptd = ptd_get_per_thread_data();
    // DBGMSG("ptd->description = %s, addl_descripton = %s", ptd->description, addl_description);
    if (!ptd->description)
@@ -258,7 +273,7 @@ const char * ptd_get_thread_description_t() {
    static GPrivate  x_key = G_PRIVATE_INIT(g_free);
    static GPrivate  x_len_key = G_PRIVATE_INIT(g_free);
 
-   ptd_cross_thread_operation_block();
+   ptd_cross_thread_operation_block(__func__);
    Per_Thread_Data *  ptd = ptd_get_per_thread_data();
    char * buf = NULL;
    if (ptd->description) {
@@ -302,7 +317,7 @@ void dbgrpt_per_thread_data(Per_Thread_Data * data, int depth) {
  *  This is a multi-instance operation.
  */
 void ptd_apply_all(Ptd_Func func, void * arg) {
-   ptd_cross_thread_operation_start();
+   ptd_cross_thread_operation_start(__func__);
    bool debug = false;
    assert(per_thread_data_hash);    // allocated by init_thread_data_module()
 
@@ -330,7 +345,7 @@ void ptd_apply_all(Ptd_Func func, void * arg) {
 void ptd_apply_all_sorted(Ptd_Func func, void * arg) {
    bool debug = false;
    DBGMSF(debug, "Starting");
-   ptd_cross_thread_operation_start();
+   ptd_cross_thread_operation_start(__func__);
    assert(per_thread_data_hash);
 
    DBGMSF(debug, "hash table size = %d", g_hash_table_size(per_thread_data_hash));
@@ -366,7 +381,7 @@ void ptd_apply_all_sorted(Ptd_Func func, void * arg) {
 void ptd_thread_summary(Per_Thread_Data * ptd, void * arg) {
    int depth = GPOINTER_TO_INT(arg);
    int d1 = depth+1;
-   ptd_cross_thread_operation_block();
+   ptd_cross_thread_operation_block(__func__);
 
    // simple but ugly
    // rpt_vstring(depth, "Thread: %d. Description:%s",
@@ -487,7 +502,7 @@ void ptd_profile_function_stats_value_destroy(void * data) {  // GDestroyNofify
 void ptd_profile_reset_thread_stats(Per_Thread_Data * ptd, void * data) {
    bool debug = false;
    DBGMSF(debug, "Starting. ptd=%p, data=%p", ptd, data);
-   ptd_cross_thread_operation_block();    // wait for any cross-thread operation to complete
+   ptd_cross_thread_operation_block(__func__);    // wait for any cross-thread operation to complete
    if (ptd->function_stats)
       g_hash_table_remove_all(ptd->function_stats);
    DBGMSF(debug, "Done");
@@ -495,7 +510,7 @@ void ptd_profile_reset_thread_stats(Per_Thread_Data * ptd, void * data) {
 
 
 void ptd_profile_reset_all_stats()  {
-   ptd_cross_thread_operation_start();
+   ptd_cross_thread_operation_start(__func__);
    ptd_apply_all(ptd_profile_reset_thread_stats, NULL);
    ptd_cross_thread_operation_end();
 }
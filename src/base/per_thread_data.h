@@ -51,9 +51,9 @@ typedef struct {
    double                sleep_multiplier;
 } Per_Thread_Data;
 
-bool ptd_cross_thread_operation_start();
+bool ptd_cross_thread_operation_start(const char * caller);
 void ptd_cross_thread_operation_end();
-void ptd_cross_thread_operation_block();
+void ptd_cross_thread_operation_block(const char * caller);
 void dbgrpt_per_thread_data_locks(int depth);
 
 Per_Thread_Data * ptd_get_per_thread_data();
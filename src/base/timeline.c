@@ -0,0 +1,236 @@
+/** @file timeline.c
+ *
+ *  Records the elapsed time of significant operations, e.g. display detection,
+ *  individual DDC write/read tries and protocol sleeps, and writes them in
+ *  Chrome trace event format so they can be viewed in chrome://tracing or
+ *  https://ui.perfetto.dev.
+ *
+ *  Recording is enabled by option --timeline.  When not enabled, the cost
+ *  of each instrumentation point is a test of a boolean.
+ */
+
+// Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "config.h"
+
+/** \cond */
+#include <assert.h>
+#include <errno.h>
+#include <glib-2.0/glib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+/** \endcond */
+
+#include "util/report_util.h"
+#include "util/timestamp.h"
+
+#include "base/core.h"
+#include "base/per_thread_data.h"
+#include "base/rtti.h"
+
+#include "base/timeline.h"
+
+// Trace class for this file
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_BASE;
+
+#define TIMELINE_MAX_EVENTS 200000
+
+typedef struct {
+   char *       name;
+   const char * category;          // always a string constant
+   pid_t        tid;
+   uint64_t     start_nanos;
+   uint64_t     duration_nanos;
+   int          busno;             // -1 if not applicable
+   const char * extra_arg_name;    // always a string constant, NULL if none
+   int          extra_arg_value;
+} Timeline_Event;
+
+bool            timeline_enabled = false;
+static char *   timeline_filename = NULL;
+static GArray * timeline_events = NULL;   // array of Timeline_Event
+static GMutex   timeline_mutex;
+static int      timeline_dropped_ct = 0;
+
+
+/** Enables timeline recording.
+ *
+ *  @param  filename  file to which the timeline is written at termination
+ *  @return true if enabled, false if filename is NULL or empty
+ */
+bool timeline_enable(const char * filename) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "filename=%s", filename);
+   bool result = false;
+   if (filename && strlen(filename) > 0) {
+      g_mutex_lock(&timeline_mutex);
+      free(timeline_filename);
+      timeline_filename = g_strdup(filename);
+      if (!timeline_events)
+         timeline_events = g_array_sized_new(false, false, sizeof(Timeline_Event), 1000);
+      timeline_enabled = true;
+      g_mutex_unlock(&timeline_mutex);
+      result = true;
+   }
+   DBGTRC_RET_BOOL(debug, TRACE_GROUP, result, "");
+   return result;
+}
+
+
+/** Returns the start time to be passed to #timeline_span_end().
+ *
+ *  @return current time in nanoseconds, 0 if recording not enabled
+ */
+uint64_t timeline_span_start() {
+   return (timeline_enabled) ? cur_realtime_nanosec() : 0;
+}
+
+
+/** Records a completed span.
+ *
+ *  Does nothing if recording is not enabled, or if recording was enabled
+ *  after the span started.
+ *
+ *  @param  name             span name, copied
+ *  @param  category         span category, must be a string constant
+ *  @param  start_nanos      value returned by #timeline_span_start()
+ *  @param  busno            I2C bus number, -1 if not applicable
+ *  @param  extra_arg_name   name of additional numeric argument, must be a
+ *                           string constant, NULL if none
+ *  @param  extra_arg_value  value of additional argument
+ */
+void timeline_span_end(
+      const char * name,
+      const char * category,
+      uint64_t     start_nanos,
+      int          busno,
+      const char * extra_arg_name,
+      int          extra_arg_value)
+{
+   if (!timeline_enabled || start_nanos == 0)
+      return;
+
+   Timeline_Event event;
+   event.start_nanos     = start_nanos;
+   event.duration_nanos  = cur_realtime_nanosec() - start_nanos;
+   event.tid             = ptd_get_per_thread_data()->thread_id;
+   event.category        = category;
+   event.busno           = busno;
+   event.extra_arg_name  = extra_arg_name;
+   event.extra_arg_value = extra_arg_value;
+
+   g_mutex_lock(&timeline_mutex);
+   if (timeline_events->len < TIMELINE_MAX_EVENTS) {
+      event.name = g_strdup(name);
+      g_array_append_val(timeline_events, event);
+   }
+   else {
+      timeline_dropped_ct++;
+   }
+   g_mutex_unlock(&timeline_mutex);
+}
+
+
+static void
+write_json_string(FILE * fp, const char * s) {
+   fputc('"', fp);
+   for (const char * p = s; *p; p++) {
+      if (*p == '"' || *p == '\\')
+         fprintf(fp, "\\%c", *p);
+      else if ((unsigned char) *p < 0x20)
+         fprintf(fp, "\\u%04x", *p);
+      else
+         fputc(*p, fp);
+   }
+   fputc('"', fp);
+}
+
+
+/** Writes the recorded spans to the file specified by #timeline_enable().
+ *
+ *  Timestamps are written relative to the start of the earliest span.
+ *
+ *  @return true if successful, false if recording not enabled or
+ *          the file could not be written
+ */
+bool timeline_write_file() {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "timeline_filename=%s", timeline_filename);
+
+   bool ok = false;
+   if (timeline_enabled) {
+      g_mutex_lock(&timeline_mutex);
+      FILE * fp = fopen(timeline_filename, "w");
+      if (!fp) {
+         MSG_W_SYSLOG(DDCA_SYSLOG_ERROR, "Error opening timeline file %s: %s",
+                      timeline_filename, strerror(errno));
+      }
+      else {
+         uint64_t base_nanos = UINT64_MAX;
+         for (int ndx = 0; ndx < timeline_events->len; ndx++) {
+            Timeline_Event * cur = &g_array_index(timeline_events, Timeline_Event, ndx);
+            if (cur->start_nanos < base_nanos)
+               base_nanos = cur->start_nanos;
+         }
+         pid_t pid = getpid();
+         fprintf(fp, "{\"traceEvents\":[\n");
+         for (int ndx = 0; ndx < timeline_events->len; ndx++) {
+            Timeline_Event * cur = &g_array_index(timeline_events, Timeline_Event, ndx);
+            fprintf(fp, "{\"name\":");
+            write_json_string(fp, cur->name);
+            fprintf(fp, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d",
+                    cur->category,
+                    (cur->start_nanos - base_nanos) / 1000.0,
+                    cur->duration_nanos / 1000.0,
+                    pid,
+                    cur->tid);
+            if (cur->busno >= 0 || cur->extra_arg_name) {
+               fprintf(fp, ",\"args\":{");
+               if (cur->busno >= 0)
+                  fprintf(fp, "\"busno\":%d", cur->busno);
+               if (cur->extra_arg_name)
+                  fprintf(fp, "%s\"%s\":%d", (cur->busno >= 0) ? "," : "",
+                          cur->extra_arg_name, cur->extra_arg_value);
+               fprintf(fp, "}");
+            }
+            fprintf(fp, "}%s\n", (ndx < timeline_events->len-1) ? "," : "");
+         }
+         fprintf(fp, "],\n\"displayTimeUnit\":\"ms\",\n");
+         fprintf(fp, "\"otherData\":{\"dropped_events\":%d}}\n", timeline_dropped_ct);
+         ok = (fclose(fp) == 0);
+         if (!ok)
+            MSG_W_SYSLOG(DDCA_SYSLOG_ERROR, "Error writing timeline file %s: %s",
+                         timeline_filename, strerror(errno));
+      }
+      g_mutex_unlock(&timeline_mutex);
+   }
+
+   DBGTRC_RET_BOOL(debug, TRACE_GROUP, ok, "events written: %d",
+                   (timeline_events) ? timeline_events->len : 0);
+   return ok;
+}
+
+
+void init_timeline() {
+   RTTI_ADD_FUNC(timeline_enable);
+   RTTI_ADD_FUNC(timeline_write_file);
+}
+
+
+/** Writes the timeline file if recording is enabled, then releases all resources. */
+void terminate_timeline() {
+   if (timeline_enabled)
+      timeline_write_file();
+   timeline_enabled = false;
+   if (timeline_events) {
+      for (int ndx = 0; ndx < timeline_events->len; ndx++)
+         free(g_array_index(timeline_events, Timeline_Event, ndx).name);
+      g_array_free(timeline_events, true);
+      timeline_events = NULL;
+   }
+   free(timeline_filename);
+   timeline_filename = NULL;
+}
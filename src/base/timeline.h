@@ -0,0 +1,34 @@
+/** @file timeline.h
+ *
+ *  Records the elapsed time of significant operations, e.g. display detection,
+ *  individual DDC write/read tries and protocol sleeps, and writes them in
+ *  Chrome trace event format so they can be viewed in chrome://tracing or
+ *  https://ui.perfetto.dev.
+ */
+
+// Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef TIMELINE_H_
+#define TIMELINE_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+extern bool timeline_enabled;
+
+bool     timeline_enable(const char * filename);
+uint64_t timeline_span_start();
+void     timeline_span_end(
+            const char * name,
+            const char * category,
+            uint64_t     start_nanos,
+            int          busno,
+            const char * extra_arg_name,
+            int          extra_arg_value);
+bool     timeline_write_file();
+
+void     init_timeline();
+void     terminate_timeline();
+
+#endif /* TIMELINE_H_ */
@@ -18,6 +18,7 @@
 #include "base/per_display_data.h"
 #include "base/rtti.h"
 #include "base/sleep.h"
+#include "base/timeline.h"
 
 // Trace class for this file
 static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_SLEEP;
@@ -228,7 +229,7 @@ adjust_sleep_time(
             "Adding %d milliseconds for %d Null response(s), busno=%d, event_type=%s, adjusted_sleep_time=%d %s",
             null_adjustment_millis ,
             dh->dref->pdd->cur_loop_null_msg_ct,
-            dh->dref->io_path.path.i2c_busno,
+            (dh->dref->io_path.io_mode == DDCA_IO_I2C) ? dh->dref->io_path.path.i2c_busno : -1,
             sleep_event_name(event_type),
             adjusted_sleep_time_millis, (msg) ? msg : "");
       DBGTRC_NOPREFIX(debug, TRACE_GROUP, "%s", s);
@@ -328,7 +329,24 @@ void tuned_sleep_with_trace(
       else
          g_snprintf(msg_buf, 100, "Event_type: %s", evname);
 
+      uint64_t span_start = timeline_span_start();
+      uint64_t sleep_start = cur_realtime_nanosec();
       sleep_millis_with_trace(adjusted_sleep_time_millis, func, lineno, filename, msg_buf);
+      uint64_t slept_nanos = cur_realtime_nanosec() - sleep_start;
+      timeline_span_end(evname, "sleep", span_start,
+            (dh->dref->io_path.io_mode == DDCA_IO_I2C) ? dh->dref->io_path.path.i2c_busno : -1,
+            "millis", adjusted_sleep_time_millis);
+      if (optime_in_retry()) {
+         optime_add(OPTIME_RETRY_SLEEP, slept_nanos);
+      }
+      else {
+         // time beyond that required by the spec is due to the sleep multiplier
+         uint64_t spec_nanos = (uint64_t) spec_sleep_time_millis * (1000*1000);
+         if (spec_nanos > slept_nanos)
+            spec_nanos = slept_nanos;
+         optime_add(OPTIME_SPEC_SLEEP, spec_nanos);
+         optime_add(OPTIME_DSA2_SLEEP, slept_nanos - spec_nanos);
+      }
       pdd->total_sleep_time_millis += adjusted_sleep_time_millis;
    }
 
@@ -364,7 +382,14 @@ void check_deferred_sleep(
    if (dref->next_i2c_io_after > curtime) {
       int sleep_time = (dh->dref->next_i2c_io_after - curtime)/ (1000*1000);
       DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Sleeping for %d milliseconds", sleep_time);
+      uint64_t span_start = timeline_span_start();
+      uint64_t sleep_start = cur_realtime_nanosec();
       sleep_millis_with_trace(sleep_time, func, lineno, filename, "deferred");
+      optime_add((optime_in_retry()) ? OPTIME_RETRY_SLEEP : OPTIME_SPEC_SLEEP,
+                 cur_realtime_nanosec() - sleep_start);
+      timeline_span_end("deferred sleep", "sleep", span_start,
+            (dref->io_path.io_mode == DDCA_IO_I2C) ? dref->io_path.path.i2c_busno : -1,
+            "millis", sleep_time);
       pdd->total_sleep_time_millis += sleep_time;
       DBGTRC_DONE(debug, TRACE_GROUP,"");
    }
@@ -0,0 +1,243 @@
+/** @file work_pool.c
+ *
+ *  Shared pool of worker threads for operations that are performed in
+ *  parallel, e.g. display detection.
+ *
+ *  Rather than creating one thread per bus or display and joining them all,
+ *  work items are queued to a pool with a bounded number of worker threads,
+ *  which are reused across operations.  Items are submitted as a #Work_Batch.
+ *  The submitting thread receives completed items in the order they finish,
+ *  so it can make use of the results for fast devices while slow devices
+ *  are still being examined.  work_batch_try_next_completed() lets it
+ *  collect results without blocking while it is still adding items.
+ *
+ *  An item may itself submit a batch.  Since waiting for a batch from within
+ *  a worker thread could leave every worker waiting on items that no worker
+ *  is free to execute, items added from a worker thread are executed
+ *  immediately in that thread.
+ */
+
+// Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "config.h"
+
+/** \cond */
+#include <assert.h>
+#include <glib-2.0/glib.h>
+#include <stdlib.h>
+#include <string.h>
+/** \endcond */
+
+#include "base/core.h"
+#include "base/parms.h"
+#include "base/rtti.h"
+#include "base/timeline.h"
+
+#include "base/work_pool.h"
+
+// Trace class for this file
+static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_BASE;
+
+struct work_batch {
+   char *          name;
+   Work_Pool_Func  func;
+   GAsyncQueue *   completed;        // completed Work_Item
+   int             submitted_ct;
+   int             returned_ct;
+   uint64_t        span_start;
+};
+
+typedef struct {
+   Work_Batch *    batch;
+   gpointer        item;
+} Work_Item;
+
+int                  work_pool_max_workers = DEFAULT_WORK_POOL_MAX_WORKERS;
+static GThreadPool * work_pool = NULL;
+static GMutex        work_pool_mutex;
+static GPrivate      in_worker_thread_key;     // non-NULL in a worker thread
+
+
+static void
+work_pool_worker_func(gpointer data, gpointer user_data) {
+   Work_Item * witem = data;
+   witem->batch->func(witem->item);
+   g_async_queue_push(witem->batch->completed, witem);
+}
+
+
+static void
+work_pool_thread_func(gpointer data, gpointer user_data) {
+   g_private_set(&in_worker_thread_key, GINT_TO_POINTER(1));
+   work_pool_worker_func(data, user_data);
+}
+
+
+/** Sets the maximum number of worker threads.
+ *
+ *  @param  max_workers  maximum number of threads, must be > 0
+ */
+void work_pool_set_max_workers(int max_workers) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "max_workers=%d", max_workers);
+   assert(max_workers > 0);
+
+   g_mutex_lock(&work_pool_mutex);
+   work_pool_max_workers = max_workers;
+   if (work_pool)
+      g_thread_pool_set_max_threads(work_pool, max_workers, NULL);
+   g_mutex_unlock(&work_pool_mutex);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+/** Creates a new, empty batch.
+ *
+ *  @param  name  batch name, used for tracing
+ *  @param  func  function to be executed for each item
+ *  @return newly allocated #Work_Batch
+ */
+Work_Batch * work_batch_new(const char * name, Work_Pool_Func func) {
+   Work_Batch * batch = calloc(1, sizeof(Work_Batch));
+   batch->name = g_strdup(name);
+   batch->func = func;
+   batch->completed = g_async_queue_new();
+   batch->span_start = timeline_span_start();
+   return batch;
+}
+
+
+/** Queues an item for execution by a worker thread.
+ *
+ *  If the pool cannot be created, or if called from a worker thread,
+ *  the item is processed in the current thread.
+ *
+ *  @param  batch  batch to which the item belongs
+ *  @param  item   item to process, must not be NULL
+ */
+void work_batch_add(Work_Batch * batch, gpointer item) {
+   bool debug = false;
+   assert(item);
+
+   Work_Item * witem = calloc(1, sizeof(Work_Item));
+   witem->batch = batch;
+   witem->item  = item;
+   batch->submitted_ct++;
+
+   bool queued = false;
+   if (g_private_get(&in_worker_thread_key)) {
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "batch %s: nested in worker thread", batch->name);
+      work_pool_worker_func(witem, NULL);
+      return;
+   }
+
+   g_mutex_lock(&work_pool_mutex);
+   if (!work_pool) {
+      GError * error = NULL;
+      work_pool = g_thread_pool_new(work_pool_thread_func, NULL,
+                                    work_pool_max_workers, false, &error);
+      if (!work_pool) {
+         MSG_W_SYSLOG(DDCA_SYSLOG_ERROR, "Error creating worker thread pool: %s",
+                      (error) ? error->message : "unknown");
+         if (error)
+            g_error_free(error);
+      }
+   }
+   if (work_pool)
+      queued = g_thread_pool_push(work_pool, witem, NULL);
+   g_mutex_unlock(&work_pool_mutex);
+
+   if (!queued) {
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "batch %s: processing item synchronously", batch->name);
+      work_pool_worker_func(witem, NULL);
+   }
+}
+
+
+/** Waits for the next item of a batch to complete.
+ *
+ *  Items are returned in the order in which they completed.
+ *
+ *  @param  batch  batch
+ *  @return completed item, NULL if all items have been returned
+ */
+gpointer work_batch_next_completed(Work_Batch * batch) {
+   if (batch->returned_ct == batch->submitted_ct)
+      return NULL;
+   // items added in a worker thread have already completed, so never blocks there
+   assert(!g_private_get(&in_worker_thread_key) || g_async_queue_length(batch->completed) > 0);
+   Work_Item * witem = g_async_queue_pop(batch->completed);
+   gpointer result = witem->item;
+   free(witem);
+   batch->returned_ct++;
+   if (batch->returned_ct == batch->submitted_ct)
+      timeline_span_end(batch->name, "work_pool", batch->span_start, -1,
+                        "items", batch->submitted_ct);
+   return result;
+}
+
+
+/** Returns the next completed item of a batch, without waiting.
+ *
+ *  Items are returned in the order in which they completed.
+ *
+ *  @param  batch  batch
+ *  @return completed item, NULL if no item is currently complete
+ */
+gpointer work_batch_try_next_completed(Work_Batch * batch) {
+   if (batch->returned_ct == batch->submitted_ct)
+      return NULL;
+   Work_Item * witem = g_async_queue_try_pop(batch->completed);
+   if (!witem)
+      return NULL;
+   gpointer result = witem->item;
+   free(witem);
+   batch->returned_ct++;
+   if (batch->returned_ct == batch->submitted_ct)
+      timeline_span_end(batch->name, "work_pool", batch->span_start, -1,
+                        "items", batch->submitted_ct);
+   return result;
+}
+
+
+/** Waits for all remaining items of a batch to complete.
+ *
+ *  @param  batch  batch
+ */
+void work_batch_wait(Work_Batch * batch) {
+   while (work_batch_next_completed(batch))
+      ;
+}
+
+
+/** Waits for all remaining items of a batch to complete,
+ *  then frees the batch.
+ *
+ *  @param  batch  batch
+ */
+void work_batch_free(Work_Batch * batch) {
+   if (batch) {
+      work_batch_wait(batch);
+      g_async_queue_unref(batch->completed);
+      free(batch->name);
+      free(batch);
+   }
+}
+
+
+void init_work_pool() {
+   RTTI_ADD_FUNC(work_pool_set_max_workers);
+}
+
+
+/** Waits for queued items to be processed, then releases the worker threads. */
+void terminate_work_pool() {
+   g_mutex_lock(&work_pool_mutex);
+   GThreadPool * pool = work_pool;
+   work_pool = NULL;
+   g_mutex_unlock(&work_pool_mutex);
+   if (pool)
+      g_thread_pool_free(pool, false, true);
+}
@@ -0,0 +1,38 @@
+/** @file work_pool.h
+ *
+ *  Shared pool of worker threads for operations that are performed in
+ *  parallel, e.g. display detection.
+ */
+
+// Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef WORK_POOL_H_
+#define WORK_POOL_H_
+
+/** \cond */
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+/** \endcond */
+
+/** Function executed by a worker thread for each item of a #Work_Batch */
+typedef void (*Work_Pool_Func)(gpointer item);
+
+/** Opaque set of work items submitted together, whose completions are
+ *  collected by the submitting thread */
+typedef struct work_batch Work_Batch;
+
+extern int work_pool_max_workers;
+
+void         work_pool_set_max_workers(int max_workers);
+Work_Batch * work_batch_new(const char * name, Work_Pool_Func func);
+void         work_batch_add(Work_Batch * batch, gpointer item);
+gpointer     work_batch_next_completed(Work_Batch * batch);
+gpointer     work_batch_try_next_completed(Work_Batch * batch);
+void         work_batch_wait(Work_Batch * batch);
+void         work_batch_free(Work_Batch * batch);
+
+void init_work_pool();
+void terminate_work_pool();
+
+#endif /* WORK_POOL_H_ */
@@ -107,6 +107,9 @@ stats_arg_func(const    gchar* option_name,
       else if ( is_abbrev(v2,"ELAPSED",3) || is_abbrev(v2, "TIME",3)) {
          stats_work |= DDCA_STATS_ELAPSED;
       }
+      else if ( is_abbrev(v2,"LOCKS",3)) {
+         stats_work |= DDCA_STATS_LOCKS;
+      }
       else
          ok = false;
       free(v2);
@@ -891,6 +894,9 @@ parse_command(
    char     i2c_bus_check_async_expl[80];
    g_snprintf(i2c_bus_check_async_expl, 80, "Threshold for parallel examination of I2C buses (Experimental). Default=%d.",
          DEFAULT_BUS_CHECK_ASYNC_THRESHOLD);
+   char     async_workers_expl[80];
+   g_snprintf(async_workers_expl, 80, "Maximum threads for parallel bus and DDC checks. Default=%d.",
+               DEFAULT_WORK_POOL_MAX_WORKERS);
    char     ddc_check_async_expl[80];
    g_snprintf(ddc_check_async_expl, 80, "Threshold for parallel examination of possible DDC devices. Default=%d.",
          DEFAULT_DDC_CHECK_ASYNC_THRESHOLD);
@@ -911,6 +917,22 @@ parse_command(
    const char * enable_flock_expl =  (enable_flock_flag) ? "Enable cross-instance locking (default)" : "Enable cross-instance locking";
    const char * disable_flock_expl = (enable_flock_flag) ? "Disable cross-instance locking" : "Disable cross-instance locking (default)";
 
+   gboolean enable_handle_pool_flag = DEFAULT_ENABLE_I2C_HANDLE_POOL;
+   const char * enable_handle_pool_expl =  (enable_handle_pool_flag) ? "Keep /dev/i2c devices open between operations (default)" : "Keep /dev/i2c devices open between operations";
+   const char * disable_handle_pool_expl = (enable_handle_pool_flag) ? "Close /dev/i2c devices after each operation" : "Close /dev/i2c devices after each operation (default)";
+   gboolean incremental_redetect_flag = DEFAULT_INCREMENTAL_REDETECTION;
+   const char * enable_incremental_redetect_expl =  (incremental_redetect_flag) ? "Redetection only reexamines changed buses (default)" : "Redetection only reexamines changed buses";
+   const char * disable_incremental_redetect_expl = (incremental_redetect_flag) ? "Redetection reexamines all buses" : "Redetection reexamines all buses (default)";
+   gboolean lazy_detection_flag = DEFAULT_LAZY_DISPLAY_DETECTION;
+   const char * enable_lazy_detection_expl =  (lazy_detection_flag) ? "Detect only the displays requested by bus number or EDID (default)" : "Detect only the displays requested by bus number or EDID";
+   const char * disable_lazy_detection_expl = (lazy_detection_flag) ? "Detect all displays at initialization" : "Detect all displays at initialization (default)";
+   gboolean coalesce_events_flag = DEFAULT_COALESCE_DISPLAY_EVENTS;
+   const char * enable_coalesce_events_expl =  (coalesce_events_flag) ? "Report a quick disconnect/reconnect as a single event (default)" : "Report a quick disconnect/reconnect as a single event";
+   const char * disable_coalesce_events_expl = (coalesce_events_flag) ? "Report every display status event" : "Report every display status event (default)";
+   gboolean dpms_events_flag = DEFAULT_DPMS_EVENT_DETECTION;
+   const char * enable_dpms_events_expl =  (dpms_events_flag) ? "Detect DPMS changes from driver notifications where supported (default)" : "Detect DPMS changes from driver notifications where supported";
+   const char * disable_dpms_events_expl = (dpms_events_flag) ? "Detect DPMS changes by periodic checks" : "Detect DPMS changes by periodic checks (default)";
+
    gboolean quick_flag         = false;
    gboolean mock_data_flag     = false;
    gboolean profile_api_flag   = false;
@@ -1105,6 +1127,8 @@ parse_command(
                                          G_OPTION_ARG_INT, &parsed_cmd->i2c_bus_check_async_min, i2c_bus_check_async_expl, NULL},
       {"ddc-checks-async-min",    '\0', G_OPTION_FLAG_NONE,
                                      G_OPTION_ARG_INT, &parsed_cmd->ddc_check_async_min, ddc_check_async_expl, NULL},
+      {"async-workers",    '\0', G_OPTION_FLAG_NONE,
+                                     G_OPTION_ARG_INT, &parsed_cmd->async_max_workers, async_workers_expl, "number"},
 
       {"skip-ddc-checks",'\0', G_OPTION_FLAG_HIDDEN,
                                   G_OPTION_ARG_NONE,     &skip_ddc_checks_flag,     "Skip initial DDC checks",  NULL},
@@ -1143,6 +1167,29 @@ parse_command(
             '\0', 0, G_OPTION_ARG_NONE,     &enable_flock_flag,   enable_flock_expl,     NULL},
       {"disable-cross-instance-locks", '\0', G_OPTION_FLAG_REVERSE,
                      G_OPTION_ARG_NONE,     &enable_flock_flag,   disable_flock_expl ,   NULL},
+      {"enable-handle-pool",
+            '\0', 0, G_OPTION_ARG_NONE,     &enable_handle_pool_flag,  enable_handle_pool_expl,  NULL},
+      {"disable-handle-pool", '\0', G_OPTION_FLAG_REVERSE,
+                     G_OPTION_ARG_NONE,     &enable_handle_pool_flag,  disable_handle_pool_expl, NULL},
+      {"enable-incremental-redetect",
+            '\0', 0, G_OPTION_ARG_NONE,     &incremental_redetect_flag,  enable_incremental_redetect_expl,  NULL},
+      {"disable-incremental-redetect", '\0', G_OPTION_FLAG_REVERSE,
+                     G_OPTION_ARG_NONE,     &incremental_redetect_flag,  disable_incremental_redetect_expl, NULL},
+      {"enable-lazy-detection",
+            '\0', 0, G_OPTION_ARG_NONE,     &lazy_detection_flag,  enable_lazy_detection_expl,  NULL},
+      {"disable-lazy-detection", '\0', G_OPTION_FLAG_REVERSE,
+                     G_OPTION_ARG_NONE,     &lazy_detection_flag,  disable_lazy_detection_expl, NULL},
+      {"enable-event-coalescing",
+            '\0', 0, G_OPTION_ARG_NONE,     &coalesce_events_flag,  enable_coalesce_events_expl,  NULL},
+      {"disable-event-coalescing", '\0', G_OPTION_FLAG_REVERSE,
+                     G_OPTION_ARG_NONE,     &coalesce_events_flag,  disable_coalesce_events_expl, NULL},
+      {"enable-dpms-events",
+            '\0', 0, G_OPTION_ARG_NONE,     &dpms_events_flag,  enable_dpms_events_expl,  NULL},
+      {"disable-dpms-events", '\0', G_OPTION_FLAG_REVERSE,
+                     G_OPTION_ARG_NONE,     &dpms_events_flag,  disable_dpms_events_expl, NULL},
+      {"handle-pool-idle", '\0', 0,
+                     G_OPTION_ARG_INT, &parsed_cmd->handle_pool_idle_millisec,
+                                          "Close pooled /dev/i2c devices unused for this long", "millisec"},
 
       {"enable-try-get-edid-from-sysfs", '\0', 0,
                             G_OPTION_ARG_NONE,    &try_get_edid_from_sysfs,   enable_tgefs_expl, NULL},
@@ -1218,6 +1265,7 @@ parse_command(
       {"trace-to-syslog-only",'\0', G_OPTION_FLAG_HIDDEN,
                               G_OPTION_ARG_NONE,         &trace_to_syslog_only_flag,  "Direct trace output only to syslog", NULL},
       {"libddcutil-trace-file",'\0', 0, G_OPTION_ARG_STRING,   &parsed_cmd->trace_destination,  "libddcutil trace file",  "file name"},
+      {"timeline",   '\0', 0, G_OPTION_ARG_FILENAME,     &parsed_cmd->timeline_fn,  "Write Chrome trace event timeline",  "file name"},
       {"stats-to-syslog",'\0', G_OPTION_FLAG_HIDDEN,
                               G_OPTION_ARG_NONE,         &stats_to_syslog_only_flag,  "Direct stats to syslog", NULL},
 
@@ -1479,6 +1527,11 @@ parse_command(
       LIBDDCUTIL_ONLY_OPTION("--profile-api",           profile_api_flag);
       LIBDDCUTIL_ONLY_OPTION("--libddcutil-trace-file", parsed_cmd->trace_destination);
       LIBDDCUTIL_ONLY_OPTION("--enable-watch-displays", watch_displays_flag);
+      LIBDDCUTIL_ONLY_OPTION("--enable-handle-pool",    enable_handle_pool_flag);
+      LIBDDCUTIL_ONLY_OPTION("--enable-incremental-redetect", incremental_redetect_flag);
+      LIBDDCUTIL_ONLY_OPTION("--enable-lazy-detection", lazy_detection_flag);
+      LIBDDCUTIL_ONLY_OPTION("--enable-event-coalescing", coalesce_events_flag);
+      LIBDDCUTIL_ONLY_OPTION("--enable-dpms-events",    dpms_events_flag);
    }
 
 #undef LIBDDCUTIL_ONLY_OPTION
@@ -1570,6 +1623,11 @@ parse_command(
    SET_CMDFLAG(CMD_FLAG_FLOCK,             enable_flock_flag);
 
    SET_CLR_CMDFLAG2(CMD_FLAG_TRY_GET_EDID_FROM_SYSFS,    try_get_edid_from_sysfs);
+   SET_CLR_CMDFLAG2(CMD_FLAG2_I2C_HANDLE_POOL,           enable_handle_pool_flag);
+   SET_CLR_CMDFLAG2(CMD_FLAG2_INCREMENTAL_REDETECT,      incremental_redetect_flag);
+   SET_CLR_CMDFLAG2(CMD_FLAG2_LAZY_DETECTION,            lazy_detection_flag);
+   SET_CLR_CMDFLAG2(CMD_FLAG2_COALESCE_EVENTS,           coalesce_events_flag);
+   SET_CLR_CMDFLAG2(CMD_FLAG2_DPMS_EVENTS,               dpms_events_flag);
    SET_CLR_CMDFLAG(CMD_FLAG_ENABLE_CACHED_CAPABILITIES, enable_cc_flag);
 // #ifdef REMOVED
    SET_CLR_CMDFLAG(CMD_FLAG_ENABLE_CACHED_DISPLAYS, enable_cd_flag);
@@ -1782,6 +1840,16 @@ parse_command(
    else
       parsed_cmd->edid_read_size = edid_read_size_work;
 
+   if (parsed_cmd->async_max_workers == 0 || parsed_cmd->async_max_workers < -1) {
+      EMIT_PARSER_ERROR(errmsgs, "Invalid number of async workers: %d", parsed_cmd->async_max_workers);
+      parsing_ok = false;
+   }
+
+   if (parsed_cmd->handle_pool_idle_millisec < -1) {
+      EMIT_PARSER_ERROR(errmsgs, "Invalid handle pool idle time: %d", parsed_cmd->handle_pool_idle_millisec);
+      parsing_ok = false;
+   }
+
    if (trace_classes) {
       parsing_ok &= parse_trace_classes(trace_classes, parsed_cmd, errmsgs);
       ntsa_free(trace_classes, true);
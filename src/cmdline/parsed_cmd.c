@@ -125,6 +125,8 @@ Parsed_Cmd *  new_parsed_cmd() {
    parsed_cmd->min_dynamic_multiplier = -1.0;
    parsed_cmd->i2c_bus_check_async_min = -1;
    parsed_cmd->ddc_check_async_min = -1;
+   parsed_cmd->async_max_workers = -1;
+   parsed_cmd->handle_pool_idle_millisec = -1;
    parsed_cmd->i1 = -1;               // if set, values are >= 0
 #ifdef OLD
    parsed_cmd->flags |= CMD_FLAG_NODETECT;
@@ -158,6 +160,7 @@ void free_parsed_cmd(Parsed_Cmd * parsed_cmd) {
          free_display_identifier(parsed_cmd->pdid);
       free(parsed_cmd->raw_command);
       free(parsed_cmd->failsim_control_fn);
+      free(parsed_cmd->timeline_fn);
       free(parsed_cmd->fref);
       ntsa_free(parsed_cmd->traced_files, true);
       ntsa_free(parsed_cmd->traced_functions, true);
@@ -313,6 +316,13 @@ void dbgrpt_parsed_cmd(Parsed_Cmd * parsed_cmd, int depth) {
       rpt_bool("dsa2 enabled",      NULL, parsed_cmd->flags & CMD_FLAG_DSA2,                    d1);
       rpt_int("i2c_bus_check_async_min", NULL, parsed_cmd->i2c_bus_check_async_min,             d1);
       rpt_int("ddc_check_async_min", NULL, parsed_cmd->ddc_check_async_min,                     d1);
+      rpt_int("async_max_workers", NULL, parsed_cmd->async_max_workers,                         d1);
+      rpt_bool("enable handle pool", NULL, parsed_cmd->flags2 & CMD_FLAG2_I2C_HANDLE_POOL,       d1);
+      rpt_bool("incremental redetection", NULL, parsed_cmd->flags2 & CMD_FLAG2_INCREMENTAL_REDETECT, d1);
+      rpt_bool("lazy display detection", NULL, parsed_cmd->flags2 & CMD_FLAG2_LAZY_DETECTION,     d1);
+      rpt_bool("coalesce display events", NULL, parsed_cmd->flags2 & CMD_FLAG2_COALESCE_EVENTS,  d1);
+      rpt_bool("DPMS event detection", NULL, parsed_cmd->flags2 & CMD_FLAG2_DPMS_EVENTS,         d1);
+      rpt_int("handle_pool_idle_millisec", NULL, parsed_cmd->handle_pool_idle_millisec,         d1);
 
 
       rpt_bool("verbose stats:", NULL, parsed_cmd->flags & CMD_FLAG_VERBOSE_STATS,      d1);
@@ -337,6 +347,7 @@ void dbgrpt_parsed_cmd(Parsed_Cmd * parsed_cmd, int depth) {
       dbgrpt_ntsa(d1, "traced_api_calls", parsed_cmd->traced_api_calls);
       dbgrpt_ntsa(d1, "traced_calls", parsed_cmd->traced_calls);
       rpt_str ("library trace file", NULL, parsed_cmd->trace_destination,           d1);
+      rpt_str ("timeline file",      NULL, parsed_cmd->timeline_fn,                 d1);
       rpt_bool("trace to syslog only", NULL, parsed_cmd->flags & CMD_FLAG_TRACE_TO_SYSLOG_ONLY, d1);
 
       rpt_str("syslog_level",      NULL, syslog_level_name(parsed_cmd->syslog_level), d1);
@@ -146,6 +146,11 @@ typedef enum {
 
 typedef enum {
    CMD_FLAG_TRY_GET_EDID_FROM_SYSFS =  0x01,
+   CMD_FLAG2_I2C_HANDLE_POOL        =  0x02,
+   CMD_FLAG2_INCREMENTAL_REDETECT   =  0x04,
+   CMD_FLAG2_LAZY_DETECTION         =  0x08,
+   CMD_FLAG2_COALESCE_EVENTS        =  0x10,
+   CMD_FLAG2_DPMS_EVENTS            =  0x20,
 
    CMD_FLAG2_I1_SET           = 0x010000000000,
    CMD_FLAG2_I2_SET           = 0x020000000000,
@@ -226,6 +231,8 @@ struct {
    DDCA_Stats_Type        stats_types;
    int16_t                i2c_bus_check_async_min;
    int16_t                ddc_check_async_min;
+   int16_t                async_max_workers;
+   int                    handle_pool_idle_millisec;
 
    // Tracing and logging
    DDCA_Trace_Group       traced_groups;
@@ -234,6 +241,7 @@ struct {
    gchar **               traced_calls;
    gchar **               traced_api_calls;
    char *                 trace_destination;
+   char *                 timeline_fn;
    DDCA_Syslog_Level      syslog_level;
 
    // Other Development
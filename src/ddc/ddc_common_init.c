@@ -30,13 +30,16 @@
 #include "base/per_thread_data.h"
 #include "base/rtti.h"
 #include "base/stats.h"
+#include "base/timeline.h"
 #include "base/tuned_sleep.h"
+#include "base/work_pool.h"
 
 #include "vcp/persistent_capabilities.h"
 
 #include "dynvcp/dyn_feature_files.h"
 
 #include "i2c/i2c_bus_core.h"
+#include "i2c/i2c_display_lock.h"
 #include "i2c/i2c_edid.h"
 #include "i2c/i2c_execute.h"
 #include "i2c/i2c_strategy_dispatcher.h"
@@ -45,6 +48,7 @@
 #include "ddc_multi_part_io.h"
 #include "ddc_serialize.h"
 #include "ddc_services.h"
+#include "ddc_status_events.h"
 #include "ddc_try_data.h"
 #include "ddc_watch_displays.h"
 #include "ddc_vcp.h"
@@ -173,6 +177,9 @@ init_tracing(Parsed_Cmd * parsed_cmd)
 
    ptd_api_profiling_enabled = parsed_cmd->flags & CMD_FLAG_PROFILE_API;
 
+   if (parsed_cmd->timeline_fn)
+      timeline_enable(parsed_cmd->timeline_fn);
+
    // if (debug)
    //    printf("(%s) Done. Returning: %s\n", __func__, sbool(ok));
 
@@ -287,6 +294,9 @@ init_performance_options(Parsed_Cmd * parsed_cmd)
    ddc_set_async_threshold(threshold);
    // DBGMSG("called ddc_set_async_threshold(%d)", threshold);
 
+   if (parsed_cmd->async_max_workers > 0)
+      work_pool_set_max_workers(parsed_cmd->async_max_workers);
+
 
    if (parsed_cmd->sleep_multiplier >= 0) {
       User_Multiplier_Source  source =
@@ -340,6 +350,8 @@ init_experimental_options(Parsed_Cmd* parsed_cmd) {
 
    if (parsed_cmd->flags & CMD_FLAG_F5)
       EDID_Read_Uses_I2C_Layer = !EDID_Read_Uses_I2C_Layer;
+   if (parsed_cmd->flags & CMD_FLAG_F6)
+      flock_blocking_wait = false;
    if (parsed_cmd->flags & CMD_FLAG_F7)
       detect_phantom_displays = false;
    if (parsed_cmd->flags & CMD_FLAG_F8)
@@ -365,6 +377,8 @@ init_experimental_options(Parsed_Cmd* parsed_cmd) {
         flock_poll_millisec = parsed_cmd->i3;
    if (parsed_cmd->flags2 & CMD_FLAG2_I4_SET)
         flock_max_wait_millisec = parsed_cmd->i4;
+   if (parsed_cmd->flags2 & CMD_FLAG2_I5_SET)
+        display_lock_max_wait_millisec = parsed_cmd->i5;
    // if (parsed_cmd->flags & CMD_FLAG_FL1_SET)
    //     dsa2_step_floor = dsa2_multiplier_to_step(parsed_cmd->fl1);
 }
@@ -397,6 +411,13 @@ submaster_initializer(Parsed_Cmd * parsed_cmd) {
    if (parsed_cmd->flags & CMD_FLAG_I2C_IO_IOCTL)
       i2c_set_io_strategy_by_id(I2C_IO_STRATEGY_IOCTL);
    i2c_enable_cross_instance_locks(parsed_cmd->flags & CMD_FLAG_FLOCK);
+   i2c_enable_handle_pool(parsed_cmd->flags2 & CMD_FLAG2_I2C_HANDLE_POOL);
+   ddc_incremental_redetection = parsed_cmd->flags2 & CMD_FLAG2_INCREMENTAL_REDETECT;  // extern in ddc_displays.h
+   ddc_lazy_display_detection  = parsed_cmd->flags2 & CMD_FLAG2_LAZY_DETECTION;        // extern in ddc_displays.h
+   ddc_coalesce_display_events = parsed_cmd->flags2 & CMD_FLAG2_COALESCE_EVENTS;       // extern in ddc_status_events.h
+   ddc_dpms_event_detection    = parsed_cmd->flags2 & CMD_FLAG2_DPMS_EVENTS;           // extern in ddc_watch_displays.h
+   if (parsed_cmd->handle_pool_idle_millisec >= 0)
+      i2c_handle_pool_idle_millisec = parsed_cmd->handle_pool_idle_millisec;  // extern in i2c_bus_core.h
    force_read_edid = !(parsed_cmd->flags2 & CMD_FLAG_TRY_GET_EDID_FROM_SYSFS);  // extern in i2c_bus_core.h
    ddc_set_verify_setvcp(parsed_cmd->flags & CMD_FLAG_VERIFY);
    set_output_level(parsed_cmd->output_level);  // current thread
@@ -1,6 +1,6 @@
 /** @file ddc_display_selection.c */
 
-// Copyright (C) 2022-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2022-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "config.h"
@@ -12,6 +12,7 @@
 #include <stdbool.h>
 #include <string.h>
 
+#include "util/data_structures.h"
 #include "util/debug_util.h"
 #include "util/edid.h"
 #include "util/report_util.h"
@@ -162,16 +163,87 @@ bye:
 }
 
 
+//
+// Indexes of the detected displays by EDID and by manufacturer/model/serial number.
+// Only display references having a parsed EDID are indexed.  As with the
+// linear search, the first matching display reference is found.
+//
+
+static Ptr_Array_Index * dref_edid_index   = NULL;
+static Ptr_Array_Index * dref_monser_index = NULL;
+
+static bool dref_edid_key(gconstpointer element, gpointer * key_loc) {
+   const Display_Ref * dref = element;
+   if (!dref->pedid)
+      return false;
+   *key_loc = g_malloc(128);
+   memcpy(*key_loc, dref->pedid->bytes, 128);
+   return true;
+}
+
+static bool dref_edid_match(gconstpointer element, gconstpointer key) {
+   const Display_Ref * dref = element;
+   return dref->pedid && memcmp(dref->pedid->bytes, key, 128) == 0;
+}
+
+static inline char *
+monser_key(const char * mfg_id, const char * model_name, const char * serial_ascii) {
+   return g_strdup_printf("%s\t%s\t%s", mfg_id, model_name, serial_ascii);
+}
+
+static bool dref_monser_key(gconstpointer element, gpointer * key_loc) {
+   const Display_Ref * dref = element;
+   if (!dref->pedid)
+      return false;
+   *key_loc = monser_key(dref->pedid->mfg_id, dref->pedid->model_name, dref->pedid->serial_ascii);
+   return true;
+}
+
+static bool dref_monser_match(gconstpointer element, gconstpointer key) {
+   const Display_Ref * dref = element;
+   bool result = false;
+   if (dref->pedid) {
+      char * dref_key = monser_key(dref->pedid->mfg_id, dref->pedid->model_name, dref->pedid->serial_ascii);
+      result = streq(dref_key, key);
+      free(dref_key);
+   }
+   return result;
+}
+
+
 static Display_Ref *
 ddc_find_display_ref_by_criteria(Display_Criteria * criteria) {
    Display_Ref * result = NULL;
    GPtrArray * all_displays = ddc_get_all_display_refs();
-   for (int ndx = 0; ndx < all_displays->len; ndx++) {
-      Display_Ref * drec = g_ptr_array_index(all_displays, ndx);
-      TRACED_ASSERT(memcmp(drec->marker, DISPLAY_REF_MARKER, 4) == 0);
-      if (ddc_test_display_ref_criteria(drec, criteria)) {
-         result = drec;
-         break;
+
+   // Criteria that consist solely of an EDID, or of a fully specified
+   // manufacturer/model/serial number, are satisfied using an index
+   bool edid_only = criteria->edidbytes &&
+                    !criteria->mfg_id && !criteria->model_name && !criteria->serial_ascii;
+   bool monser_only = !criteria->edidbytes &&
+                      criteria->mfg_id       && strlen(criteria->mfg_id)       > 0 &&
+                      criteria->model_name   && strlen(criteria->model_name)   > 0 &&
+                      criteria->serial_ascii && strlen(criteria->serial_ascii) > 0;
+   bool no_path_criteria = criteria->dispno < 0 && criteria->i2c_busno < 0 &&
+                           criteria->hiddev < 0 &&
+                           criteria->usb_busno < 0 && criteria->usb_devno < 0;
+
+   if (no_path_criteria && edid_only) {
+      result = pai_lookup(dref_edid_index, all_displays, criteria->edidbytes);
+   }
+   else if (no_path_criteria && monser_only) {
+      char * key = monser_key(criteria->mfg_id, criteria->model_name, criteria->serial_ascii);
+      result = pai_lookup(dref_monser_index, all_displays, key);
+      free(key);
+   }
+   else {
+      for (int ndx = 0; ndx < all_displays->len; ndx++) {
+         Display_Ref * drec = g_ptr_array_index(all_displays, ndx);
+         TRACED_ASSERT(memcmp(drec->marker, DISPLAY_REF_MARKER, 4) == 0);
+         if (ddc_test_display_ref_criteria(drec, criteria)) {
+            result = drec;
+            break;
+         }
       }
    }
    return result;
@@ -241,6 +313,10 @@ ddc_find_display_ref_by_display_identifier(Display_Identifier * did) {
 /** Searches the detected displays for one matching the criteria in a
  *  #Display_Identifier.
  *
+ *  Displays are detected if that has not already occurred.  In lazy
+ *  detection mode, if the identifier specifies a bus number or EDID only
+ *  the display on that bus is detected.
+ *
  *  @param pdid  pointer to a #Display_Identifier
  *  @param callopts  standard call options
  *  @return pointer to #Display_Ref for the display, NULL if not found
@@ -255,7 +331,21 @@ get_display_ref_for_display_identifier(
                 Display_Identifier* pdid,
                 Call_Options        callopts)
 {
-   Display_Ref * dref = ddc_find_display_ref_by_display_identifier(pdid);
+   Display_Ref * dref = NULL;
+   bool single_lookup_done =
+         ddc_lazy_display_detection &&
+         (pdid->id_type == DISP_ID_BUSNO || pdid->id_type == DISP_ID_EDID) &&
+         ddc_detect_single_display( (pdid->id_type == DISP_ID_BUSNO) ? pdid->busno : -1,
+                                    (pdid->id_type == DISP_ID_EDID)  ? pdid->edidbytes : NULL,
+                                    &dref);
+   if (single_lookup_done) {
+      if (dref && dref->dispno < 0)
+         dref = NULL;   // display doesn't support DDC
+   }
+   else {
+      ddc_ensure_displays_detected();
+      dref = ddc_find_display_ref_by_display_identifier(pdid);
+   }
 
    return dref;
 }
@@ -264,5 +354,19 @@ get_display_ref_for_display_identifier(
 void
 init_ddc_display_selection() {
    RTTI_ADD_FUNC(ddc_find_display_ref_by_display_identifier);
+
+   dref_edid_index   = pai_new(edid_bytes_hash, edid_bytes_equal, g_free,
+                               dref_edid_key, dref_edid_match);
+   dref_monser_index = pai_new(g_str_hash, g_str_equal, g_free,
+                               dref_monser_key, dref_monser_match);
+}
+
+
+void
+terminate_ddc_display_selection() {
+   pai_free(dref_edid_index);
+   pai_free(dref_monser_index);
+   dref_edid_index   = NULL;
+   dref_monser_index = NULL;
 }
 
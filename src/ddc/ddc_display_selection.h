@@ -1,6 +1,6 @@
 /** @file ddc_display_selection.h */
 
-// Copyright (C) 2022-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2022-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #ifndef DDC_DISPLAY_SELECTION_H_
@@ -16,4 +16,7 @@ get_display_ref_for_display_identifier(
 
 void
 init_ddc_display_selection();
+
+void
+terminate_ddc_display_selection();
 #endif /* DDC_DISPLAY_SELECTION_H_ */
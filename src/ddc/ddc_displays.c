@@ -46,12 +46,15 @@
 #include "base/core.h"
 #include "base/ddc_packets.h"
 #include "base/dsa2.h"
+#include "base/execution_stats.h"
 #include "base/feature_metadata.h"
 #include "base/linux_errno.h"
 #include "base/monitor_model_key.h"
 #include "base/parms.h"
 #include "base/per_display_data.h"
 #include "base/rtti.h"
+#include "base/timeline.h"
+#include "base/work_pool.h"
 
 #include "vcp/vcp_feature_codes.h"
 
@@ -69,6 +72,7 @@
 #include "ddc/ddc_display_ref_reports.h"
 #include "ddc/ddc_packet_io.h"
 #include "ddc/ddc_serialize.h"
+#include "ddc/ddc_status_events.h"
 #include "ddc/ddc_vcp_version.h"
 #include "ddc/ddc_vcp.h"
 #include "ddc/ddc_watch_displays.h"
@@ -81,6 +85,14 @@ static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_DDC;
 static GPtrArray * all_display_refs = NULL;         // all detected displays, array of Display_Ref *
 static GPtrArray * display_open_errors = NULL;  // array of Bus_Open_Error
 static int dispno_max = 0;                      // highest assigned display number
+bool ddc_incremental_redetection = DEFAULT_INCREMENTAL_REDETECTION;
+static bool cached_buses_restored = false;     // bus info restored from validated displays cache
+bool ddc_lazy_display_detection = DEFAULT_LAZY_DISPLAY_DETECTION;
+static bool partial_detection = false;         // only individually requested displays detected
+// Serializes lazy detection of single displays and completion of detection.
+// Recursive, since a display ready callback can call back into the API.
+static GRecMutex detection_mutex;
+static bool detection_in_progress = false;     // ddc_detect_all_displays() is executing
 static int ddc_detect_async_threshold = DEFAULT_DDC_CHECK_ASYNC_THRESHOLD;
 #ifdef ENABLE_USB
 static bool detect_usb_displays = true;
@@ -90,6 +102,15 @@ static bool detect_usb_displays = false;
 bool monitor_state_tests = false;
 bool skip_ddc_checks = false;
 
+/** Reports whether the information for a bus was restored from a displays
+ *  cache whose fingerprint matched, so that cached display state is current.
+ */
+static bool
+is_bus_restored_from_cache(int busno) {
+   return cached_buses_restored && ddc_bus_restored_by_fingerprint(busno);
+}
+
+
 void ddc_add_display_ref(Display_Ref * dref) {
    g_ptr_array_add(all_display_refs, dref);
 }
@@ -653,6 +674,8 @@ ddc_initial_checks_by_dref(Display_Ref * dref) {
 
    bool result = false;
    Error_Info * err = NULL;
+   uint64_t span_start = timeline_span_start();
+   bool optime_started = optime_start(OPTIME_INITIAL_CHECKS);
 
    if (skip_ddc_checks) {
       dref->flags |= (DREF_DDC_COMMUNICATION_CHECKED |
@@ -662,6 +685,14 @@ ddc_initial_checks_by_dref(Display_Ref * dref) {
       DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Skipping initial ddc checks");
       result = true;
    }
+   else if (dref->io_path.io_mode == DDCA_IO_I2C &&
+            is_bus_restored_from_cache(dref->io_path.path.i2c_busno) &&
+            (dref->flags & DREF_DDC_COMMUNICATION_CHECKED))
+   {
+      // restored from a displays cache whose fingerprint matched, do not open the device
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Using cached initial check results");
+      result = dref->flags & DREF_DDC_COMMUNICATION_WORKING;
+   }
    else {
    // if (!(dref->flags & DREF_DPMS_SUSPEND_STANDBY_OFF)) {
       Display_Handle * dh = NULL;
@@ -686,6 +717,11 @@ ddc_initial_checks_by_dref(Display_Ref * dref) {
    // }
    }
 
+   pdd_optime_end(dref->pdd, optime_started);
+   timeline_span_end("ddc_initial_checks_by_dref", "detect", span_start,
+         (dref->io_path.io_mode == DDCA_IO_I2C) ? dref->io_path.path.i2c_busno : -1,
+         "communication_working", result);
+
    DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Final flags: %s", interpret_dref_flags_t(dref->flags));
    DBGTRC_RET_BOOL(debug, TRACE_GROUP, result, "dref = %s", dref_repr_t(dref) );
    if (err)
@@ -694,11 +730,11 @@ ddc_initial_checks_by_dref(Display_Ref * dref) {
 }
 
 
-/** Performs initial checks in a thread
+/** Performs initial checks in a worker thread
  *
  *  @param data display reference
  */
-STATIC void *
+STATIC void
 threaded_initial_checks_by_dref(gpointer data) {
    bool debug = false;
 
@@ -707,60 +743,175 @@ threaded_initial_checks_by_dref(gpointer data) {
    DBGTRC_STARTING(debug, TRACE_GROUP, "dref = %s", dref_repr_t(dref) );
 
    ddc_initial_checks_by_dref(dref);
-   // g_thread_exit(NULL);
-   DBGTRC_DONE(debug, TRACE_GROUP, "Returning NULL. dref = %s,", dref_repr_t(dref) );
-   return NULL;
+   DBGTRC_DONE(debug, TRACE_GROUP, "dref = %s,", dref_repr_t(dref) );
 }
 
 
-/** Spawns threads to perform initial checks and waits for them all to complete.
+// Display detection in progress.  Display refs are collected as buses are
+// checked.  Once there are at least ddc_detect_async_threshold displays,
+// their initial checks are queued to the shared worker pool, and each
+// display found thereafter is queued as soon as it is found.  Initial checks
+// therefore overlap with the checks of buses that are still in progress.
+//
+// Each display is reported to the display ready callbacks as soon as its
+// initial checks complete, unless it might turn out to be a phantom display.
+// Those are held until phantom displays have been filtered out.
+typedef struct {
+   GPtrArray *  display_list;       // Display_Ref *
+   GPtrArray *  bus_open_errors;    // Bus_Open_Error *
+   Work_Batch * batch;              // initial checks, NULL if not using the pool
+   GPtrArray *  held_displays;      // Display_Ref *, checked but not yet reported
+   int          mst_bus_found;      // -1 not yet determined, else 0/1
+} Display_Scan;
+
+
+/** Tests whether any attached I2C bus is a DisplayPort MST bus.
+ *  The result is determined once per scan.
  *
- *  @param all_displays #GPtrArray of pointers to #Display_Ref
+ *  @param scan  scan in progress
  */
-STATIC void
-ddc_async_scan(GPtrArray * all_displays) {
-   bool debug = false;
-   DBGTRC_STARTING(debug, TRACE_GROUP, "all_displays=%p, display_count=%d",
-                                       all_displays, all_displays->len);
+static bool
+scan_has_mst_bus(Display_Scan * scan) {
+   if (scan->mst_bus_found < 0) {
+      scan->mst_bus_found = 0;
+      for (int ndx = 0; all_i2c_buses && ndx < all_i2c_buses->len && !scan->mst_bus_found; ndx++) {
+         I2C_Bus_Info * businfo = g_ptr_array_index(all_i2c_buses, ndx);
+         char * bus_name = get_i2c_device_sysfs_name(businfo->busno);
+         if (streq(bus_name, "DPMST"))
+            scan->mst_bus_found = 1;
+         free(bus_name);
+      }
+   }
+   return scan->mst_bus_found;
+}
 
-   GPtrArray * threads = g_ptr_array_new();
-   for (int ndx = 0; ndx < all_displays->len; ndx++) {
-      Display_Ref * dref = g_ptr_array_index(all_displays, ndx);
-      TRACED_ASSERT( memcmp(dref->marker, DISPLAY_REF_MARKER, 4) == 0 );
 
-      GThread * th =
-      g_thread_new(
-            dref_repr_t(dref),                // thread name
-            threaded_initial_checks_by_dref,
-            dref);                            // pass pointer to display ref as data
-      g_ptr_array_add(threads, th);
-   }
-   DBGMSF(debug, "Started %d threads", threads->len);
-   for (int ndx = 0; ndx < threads->len; ndx++) {
-      GThread * thread = g_ptr_array_index(threads, ndx);
-      g_thread_join(thread);  // implicitly unrefs the GThread
+/** Tests whether a display whose initial checks are complete could be
+ *  marked phantom by #filter_phantom_displays() once all displays are known.
+ *
+ *  That is the case for an I2C display on which DDC does not work, which may
+ *  duplicate a working display, and for a working display on a non-MST bus
+ *  if an MST bus exists, since the MST display may have the same EDID.
+ *
+ *  @param scan  scan in progress
+ *  @param dref  display reference
+ */
+static bool
+may_be_phantom_display(Display_Scan * scan, Display_Ref * dref) {
+   if (!detect_phantom_displays || dref->io_path.io_mode != DDCA_IO_I2C)
+      return false;
+   if (!(dref->flags & DREF_DDC_COMMUNICATION_WORKING))
+      return true;
+   bool result = false;
+   if (scan_has_mst_bus(scan)) {
+      char * bus_name = get_i2c_device_sysfs_name(dref->io_path.path.i2c_busno);
+      result = !streq(bus_name, "DPMST");
+      free(bus_name);
    }
-   DBGMSF(debug, "Threads joined");
-   g_ptr_array_free(threads, true);
+   return result;
+}
 
-   DBGTRC_DONE(debug, TRACE_GROUP, "");
+
+/** Called as the initial checks of each display complete.  Reports the
+ *  display to the display ready callbacks, or holds it if it might be
+ *  a phantom display.
+ *
+ *  @param scan  scan in progress
+ *  @param dref  display reference
+ */
+STATIC void
+ddc_scan_display_checked(Display_Scan * scan, Display_Ref * dref) {
+   bool debug = false;
+   DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Checks complete for %s, flags: %s",
+         dref_repr_t(dref), interpret_dref_flags_t(dref->flags));
+   if (may_be_phantom_display(scan, dref))
+      g_ptr_array_add(scan->held_displays, dref);
+   else
+      ddc_emit_display_ready(dref);
 }
 
 
-/** Loops through a list of display refs, performing initial checks on each.
+/** Loops through the displays of a scan, performing initial checks on each.
  *
- *  @param all_displays #GPtrArray of pointers to #Display_Ref
+ *  @param scan  scan in progress
  */
 STATIC void
-ddc_non_async_scan(GPtrArray * all_displays) {
+ddc_non_async_scan(Display_Scan * scan) {
    bool debug = false;
-   DBGTRC_STARTING(debug, TRACE_GROUP, "checking %d displays", all_displays->len);
+   DBGTRC_STARTING(debug, TRACE_GROUP, "checking %d displays", scan->display_list->len);
 
-   for (int ndx = 0; ndx < all_displays->len; ndx++) {
-      Display_Ref * dref = g_ptr_array_index(all_displays, ndx);
+   for (int ndx = 0; ndx < scan->display_list->len; ndx++) {
+      Display_Ref * dref = g_ptr_array_index(scan->display_list, ndx);
       TRACED_ASSERT( memcmp(dref->marker, DISPLAY_REF_MARKER, 4) == 0 );
       ddc_initial_checks_by_dref(dref);
+      ddc_scan_display_checked(scan, dref);
+   }
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+/** Reports the displays of an asynchronous scan whose initial checks have
+ *  completed, without waiting for others.
+ *
+ *  @param scan  scan in progress
+ */
+static void
+ddc_scan_report_completed(Display_Scan * scan) {
+   if (scan->batch) {
+      Display_Ref * dref = NULL;
+      while ( (dref = work_batch_try_next_completed(scan->batch)) )
+         ddc_scan_display_checked(scan, dref);
+   }
+}
+
+
+/** Adds a display ref to a scan, queuing its initial checks to the
+ *  worker pool if the scan is asynchronous.
+ *
+ *  @param scan  scan in progress
+ *  @param dref  display reference
+ */
+STATIC void
+ddc_scan_add_display(Display_Scan * scan, Display_Ref * dref) {
+   bool debug = false;
+   TRACED_ASSERT( memcmp(dref->marker, DISPLAY_REF_MARKER, 4) == 0 );
+   g_ptr_array_add(scan->display_list, dref);
+   if (scan->batch) {
+      work_batch_add(scan->batch, dref);
+   }
+   else if (scan->display_list->len >= ddc_detect_async_threshold) {
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Queuing initial checks for %d displays",
+                                          scan->display_list->len);
+      scan->batch = work_batch_new("ddc_async_scan", threaded_initial_checks_by_dref);
+      for (int ndx = 0; ndx < scan->display_list->len; ndx++)
+         work_batch_add(scan->batch, g_ptr_array_index(scan->display_list, ndx));
+   }
+}
+
+
+/** Waits for the initial checks of an asynchronous scan to complete,
+ *  or performs them if the scan is not asynchronous.  Each display is
+ *  reported as its checks complete.
+ *
+ *  @param scan  scan in progress
+ */
+STATIC void
+ddc_scan_complete(Display_Scan * scan) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "display count=%d, async=%s",
+                   scan->display_list->len, sbool(scan->batch));
+
+   if (scan->batch) {
+      Display_Ref * dref = NULL;
+      while ( (dref = work_batch_next_completed(scan->batch)) )
+         ddc_scan_display_checked(scan, dref);
+      work_batch_free(scan->batch);
+      scan->batch = NULL;
+   }
+   else {
+      ddc_non_async_scan(scan);
    }
+
    DBGTRC_DONE(debug, TRACE_GROUP, "");
 }
 
@@ -848,6 +999,42 @@ ddc_get_display_ref_by_drm_connector(
 }
 #endif
 
+// Indexes of live I2C display references in all_display_refs,
+// used by ddc_get_dref_by_busno_or_connector()
+static Ptr_Array_Index * live_dref_busno_index     = NULL;
+static Ptr_Array_Index * live_dref_connector_index = NULL;
+
+static inline bool is_live_i2c_dref(const Display_Ref * dref) {
+   return dref->dispno > 0 &&
+          !(dref->flags & DREF_REMOVED) &&
+          dref->io_path.io_mode == DDCA_IO_I2C;
+}
+
+static bool live_dref_busno_key(gconstpointer element, gpointer * key_loc) {
+   const Display_Ref * dref = element;
+   *key_loc = GINT_TO_POINTER(dref->io_path.path.i2c_busno);
+   return is_live_i2c_dref(dref);
+}
+
+static bool live_dref_busno_match(gconstpointer element, gconstpointer key) {
+   const Display_Ref * dref = element;
+   return is_live_i2c_dref(dref) && dref->io_path.path.i2c_busno == GPOINTER_TO_INT(key);
+}
+
+static bool live_dref_connector_key(gconstpointer element, gpointer * key_loc) {
+   const Display_Ref * dref = element;
+   if (!is_live_i2c_dref(dref) || !dref->drm_connector)
+      return false;
+   *key_loc = g_strdup(dref->drm_connector);
+   return true;
+}
+
+static bool live_dref_connector_match(gconstpointer element, gconstpointer key) {
+   const Display_Ref * dref = element;
+   return is_live_i2c_dref(dref) && streq(dref->drm_connector, key);
+}
+
+
 /** Locates the currently live Display_Ref for the specified bus.
  *  Discarded display references, i.e. ones marked removed (flag DREF_REMOVED)
  *  are ignored. There should be at most one non-removed Display_Ref.
@@ -869,6 +1056,20 @@ Display_Ref * ddc_get_dref_by_busno_or_connector(
    assert(all_display_refs);
 
    Display_Ref * result = NULL;
+   if (ignore_invalid) {
+      // There is at most one live display reference per bus or connector.
+      // Instead of counting matches, check that the index found no
+      // duplicate keys when last built.
+      Ptr_Array_Index * pai = (connector) ? live_dref_connector_index : live_dref_busno_index;
+      if (connector)
+         result = pai_lookup(pai, all_display_refs, connector);
+      else
+         result = pai_lookup(pai, all_display_refs, GINT_TO_POINTER(busno));
+      assert(pai_duplicate_key_ct(pai) == 0);
+      DBGTRC_DONE(debug, TRACE_GROUP, "Returning: %p= %s", result, dref_repr_t(result));
+      return result;
+   }
+
    int non_removed_ct = 0;
    for (int ndx = 0; ndx < all_display_refs->len; ndx++) {
       // If a display is repeatedly removed and added on a particular connector,
@@ -879,21 +1080,10 @@ Display_Ref * ddc_get_dref_by_busno_or_connector(
       Display_Ref * cur_dref = g_ptr_array_index(all_display_refs, ndx);
       // DBGMSG("Checking dref %s", dref_repr_t(cur_dref));
 
-      if (ignore_invalid && cur_dref->dispno <= 0) {
-         DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "cur_dref=%s@%p dispno < 0, Ignoring",
-               dref_repr_t(cur_dref), cur_dref);
-         continue;
-      }
-
       I2C_Bus_Info * businfo = (I2C_Bus_Info*) cur_dref->detail;
       DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "DREF_REMOVED=%s, dref_detail=%p -> /dev/i2c-%d",
             sbool(cur_dref->flags&DREF_REMOVED), cur_dref->detail,  businfo->busno);
 
-      if (ignore_invalid && cur_dref->flags&DREF_REMOVED) {
-         DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "cur_dref=%s@%p DREF_REMOVED set, Ignoring",
-                dref_repr_t(cur_dref), cur_dref);
-         continue;
-      }
       if (cur_dref->io_path.io_mode != DDCA_IO_I2C) {
          DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "cur_dref=%s@%p io_mode != DDCA_IO_I2C, Ignoring",
                 dref_repr_t(cur_dref), cur_dref);
@@ -1276,86 +1466,148 @@ Display_Ref * detect_display_by_businfo(I2C_Bus_Info * businfo) {
 #endif
 
 
-/** Detects all connected displays by querying the I2C and USB subsystems.
+/** Creates a #Bus_Open_Error for an I2C bus that could not be opened.
  *
- *  @param  open_errors_loc where to return address of #GPtrArray of #Bus_Open_Error
- *  @return array of #Display_Ref
+ *  @param  businfo  bus
+ *  @return newly allocated #Bus_Open_Error
  */
-STATIC GPtrArray *
-ddc_detect_all_displays(GPtrArray ** i2c_open_errors_loc) {
+static Bus_Open_Error *
+new_bus_open_error_by_businfo(I2C_Bus_Info * businfo) {
+   Bus_Open_Error * boe = calloc(1, sizeof(Bus_Open_Error));
+   boe->io_mode = DDCA_IO_I2C;
+   boe->devno = businfo->busno;
+   boe->error = businfo->open_errno;
+   return boe;
+}
+
+
+/** Called as the checks of each I2C bus complete.  Creates a display ref
+ *  if a display is connected, so that its initial checks can start while
+ *  other buses are still being checked, or records an open error.
+ *
+ *  @param  businfo  bus that has been checked
+ *  @param  data     #Display_Scan
+ */
+STATIC void
+ddc_scan_bus_checked(I2C_Bus_Info * businfo, gpointer data) {
    bool debug = false;
-   DBGTRC_STARTING(debug, TRACE_GROUP, "display_caching_enabled=%s, detect_usb_displays=%s",
-         sbool(display_caching_enabled), sbool(detect_usb_displays));
+   Display_Scan * scan = data;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "busno=%d", businfo->busno);
 
-   dispno_max = 0;
-   GPtrArray * bus_open_errors = g_ptr_array_new();
-   GPtrArray * display_list = g_ptr_array_new();
-
-   int busct = i2c_detect_buses();
-   DBGMSF(debug, "i2c_detect_buses() returned: %d", busct);
-   guint busndx = 0;
-   for (busndx=0; busndx < busct; busndx++) {
-      DBGMSF(debug, "busndx = %d", busndx);
-      I2C_Bus_Info * businfo = i2c_get_bus_info_by_index(busndx);
-      // if (IS_DBGTRC(debug, DDCA_TRC_NONE))
-      //    i2c_dbgrpt_bus_info(businfo, 2);
-      if ( (businfo->flags & I2C_BUS_ADDR_0X50)  && businfo->edid ) {
-         Display_Ref * dref = NULL;
-         // Do not restore serialized display ref if slave address x37 inactive
-         // Prevents creating a display ref with stale contents
-         if (display_caching_enabled && (businfo->flags&I2C_BUS_ADDR_0X37) ) {
-            dref = copy_display_ref(
-                       ddc_find_deserialized_display(businfo->busno, businfo->edid->bytes));
-            if (dref)
-               dref->detail = businfo;
-         }
-         if (!dref) {
-            dref = create_bus_display_ref(businfo->busno);
-            dref->dispno = DISPNO_INVALID;   // -1, guilty until proven innocent
-            if (businfo->drm_connector_name) {
-               dref->drm_connector = g_strdup(businfo->drm_connector_name);
-            }
-            dref->pedid = copy_parsed_edid(businfo->edid);
-            dref->mmid  = monitor_model_key_new(dref->pedid->mfg_id,
-                                                dref->pedid->model_name,
-                                                dref->pedid->product_code);
+   // if (IS_DBGTRC(debug, DDCA_TRC_NONE))
+   //    i2c_dbgrpt_bus_info(businfo, 2);
+   if ( (businfo->flags & I2C_BUS_ADDR_0X50)  && businfo->edid ) {
+      Display_Ref * dref = NULL;
+      // Do not restore serialized display ref if slave address x37 inactive
+      // Prevents creating a display ref with stale contents
+      // If the cache fingerprint matched, the cached state is known to be current.
+      bool restored = is_bus_restored_from_cache(businfo->busno);
+      if (display_caching_enabled && (restored || (businfo->flags&I2C_BUS_ADDR_0X37)) ) {
+         Display_Ref * cached = ddc_find_deserialized_display(businfo->busno, businfo->edid->bytes);
+         if (cached && !restored && !(cached->flags & DREF_DDC_COMMUNICATION_WORKING))
+            cached = NULL;   // recheck displays on which DDC did not work
+         dref = copy_display_ref(cached);
+         if (dref)
             dref->detail = businfo;
-            dref->flags |= DREF_DDC_IS_MONITOR_CHECKED;
-            dref->flags |= DREF_DDC_IS_MONITOR;
+      }
+      if (!dref) {
+         dref = create_bus_display_ref(businfo->busno);
+         dref->dispno = DISPNO_INVALID;   // -1, guilty until proven innocent
+         if (businfo->drm_connector_name) {
+            dref->drm_connector = g_strdup(businfo->drm_connector_name);
          }
+         dref->pedid = copy_parsed_edid(businfo->edid);
+         dref->mmid  = monitor_model_key_new(dref->pedid->mfg_id,
+                                             dref->pedid->model_name,
+                                             dref->pedid->product_code);
+         dref->detail = businfo;
+         dref->flags |= DREF_DDC_IS_MONITOR_CHECKED;
+         dref->flags |= DREF_DDC_IS_MONITOR;
+      }
 
 #ifdef USE_X11
-         bool asleep = dpms_state&DPMS_STATE_X11_ASLEEP;
-         if (!asleep & !(dpms_state&DPMS_STATE_X11_CHECKED)) {
-             if (dpms_check_drm_asleep_by_dref(dref)) {
-                dpms_state |= DPMS_SOME_DRM_ASLEEP;
-                asleep = true;
-             }
-             else {
-                all_displays_asleep = false;
-             }
-         }
-#else
-         if (dpms_check_drm_asleep_by_dref(dref)) {
-            dpms_state |= DPMS_SOME_DRM_ASLEEP;
-            dref->flags |= DREF_DPMS_SUSPEND_STANDBY_OFF;
+      bool asleep = dpms_state&DPMS_STATE_X11_ASLEEP;
+      if (!asleep & !(dpms_state&DPMS_STATE_X11_CHECKED)) {
+          if (dpms_check_drm_asleep_by_dref(dref)) {
+             dpms_state |= DPMS_SOME_DRM_ASLEEP;
+             asleep = true;
           }
           else {
              all_displays_asleep = false;
           }
+      }
+#else
+      if (dpms_check_drm_asleep_by_dref(dref)) {
+         dpms_state |= DPMS_SOME_DRM_ASLEEP;
+         dref->flags |= DREF_DPMS_SUSPEND_STANDBY_OFF;
+       }
+       else {
+          all_displays_asleep = false;
+       }
 #endif
 
-         // dbgrpt_display_ref(dref,5);
-         g_ptr_array_add(display_list, dref);
-      }
-      else if ( !(businfo->flags & I2C_BUS_ACCESSIBLE) ) {
-         Bus_Open_Error * boe = calloc(1, sizeof(Bus_Open_Error));
-         boe->io_mode = DDCA_IO_I2C;
-         boe->devno = businfo->busno;
-         boe->error = businfo->open_errno;
-         g_ptr_array_add(bus_open_errors, boe);
-      }
+      // dbgrpt_display_ref(dref,5);
+      ddc_scan_add_display(scan, dref);
+   }
+   else if ( !(businfo->flags & I2C_BUS_ACCESSIBLE) ) {
+      g_ptr_array_add(scan->bus_open_errors, new_bus_open_error_by_businfo(businfo));
    }
+   ddc_scan_report_completed(scan);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+/** Orders display refs by I2C bus number, followed by USB displays in the
+ *  order they were found.
+ */
+static gint
+compare_drefs_by_io_path(gconstpointer a, gconstpointer b) {
+   const Display_Ref * dref1 = *(Display_Ref **) a;
+   const Display_Ref * dref2 = *(Display_Ref **) b;
+   bool i2c1 = dref1->io_path.io_mode == DDCA_IO_I2C;
+   bool i2c2 = dref2->io_path.io_mode == DDCA_IO_I2C;
+   if (i2c1 && i2c2)
+      return dref1->io_path.path.i2c_busno - dref2->io_path.path.i2c_busno;
+   return (i2c1 == i2c2) ? 0 : (i2c1) ? -1 : 1;
+}
+
+
+/** Detects all connected displays by querying the I2C and USB subsystems.
+ *
+ *  @param  open_errors_loc where to return address of #GPtrArray of #Bus_Open_Error
+ *  @return array of #Display_Ref
+ */
+STATIC GPtrArray *
+ddc_detect_all_displays(GPtrArray ** i2c_open_errors_loc) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "display_caching_enabled=%s, detect_usb_displays=%s",
+         sbool(display_caching_enabled), sbool(detect_usb_displays));
+
+   dispno_max = 0;
+   Display_Scan scan = {0};
+   scan.bus_open_errors = g_ptr_array_new();
+   scan.display_list = g_ptr_array_new();
+   scan.held_displays = g_ptr_array_new();
+   scan.mst_bus_found = -1;
+
+   // verbose output is distracting within scans
+   // saved and reset here so that async threads are not adjusting output level
+   DDCA_Output_Level olev = get_output_level();
+   if (olev == DDCA_OL_VERBOSE)
+      set_output_level(DDCA_OL_NORMAL);
+
+   // Displays are reported to display ready callbacks as their checks complete,
+   // and may be used before the scan finishes.
+   __atomic_store_n(&detection_in_progress, true, __ATOMIC_RELEASE);
+
+   // If the display configuration fingerprint matches the displays cache,
+   // bus information is restored from the cache instead of probing each bus.
+   // Initial checks of each display start as soon as its bus has been checked.
+   cached_buses_restored = display_caching_enabled && ddc_restore_buses_by_fingerprint();
+   int busct = i2c_detect_buses_with_callback(ddc_scan_bus_checked, &scan);
+   DBGMSF(debug, "i2c_detect_buses_with_callback() returned: %d, cached_buses_restored=%s",
+                 busct, sbool(cached_buses_restored));
 
 #ifdef ENABLE_USB
    if (detect_usb_displays) {
@@ -1417,7 +1669,7 @@ ddc_detect_all_displays(GPtrArray ** i2c_open_errors_loc) {
              all_displays_asleep = false;
           }
 #endif
-         g_ptr_array_add(display_list, dref);
+         ddc_scan_add_display(&scan, dref);
       }
 
 
@@ -1430,7 +1682,7 @@ ddc_detect_all_displays(GPtrArray ** i2c_open_errors_loc) {
             boe_copy->devno   = usb_boe->devno;
             boe_copy->error   = usb_boe->error;
             boe_copy->detail  = usb_boe->detail;
-            g_ptr_array_add(bus_open_errors, boe_copy);
+            g_ptr_array_add(scan.bus_open_errors, boe_copy);
          }
       }
    }
@@ -1440,22 +1692,18 @@ ddc_detect_all_displays(GPtrArray ** i2c_open_errors_loc) {
     else
        dpms_state &= ~DPMS_ALL_DRM_ASLEEP;
 
-   // verbose output is distracting within scans
-   // saved and reset here so that async threads are not adjusting output level
-   DDCA_Output_Level olev = get_output_level();
-   if (olev == DDCA_OL_VERBOSE)
-      set_output_level(DDCA_OL_NORMAL);
-
    DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "display_list->len=%d, ddc_detect_async_threshold=%d",
-                 display_list->len, ddc_detect_async_threshold);
-   if (display_list->len >= ddc_detect_async_threshold)
-      ddc_async_scan(display_list);
-   else
-      ddc_non_async_scan(display_list);
+                 scan.display_list->len, ddc_detect_async_threshold);
+   ddc_scan_complete(&scan);
 
    if (olev == DDCA_OL_VERBOSE)
       set_output_level(olev);
 
+   // buses are reported in the order their checks completed
+   GPtrArray * display_list = scan.display_list;
+   GPtrArray * bus_open_errors = scan.bus_open_errors;
+   g_ptr_array_sort(display_list, compare_drefs_by_io_path);
+
    // assign display numbers
    for (int ndx = 0; ndx < display_list->len; ndx++) {
       Display_Ref * dref = g_ptr_array_index(display_list, ndx);
@@ -1482,6 +1730,15 @@ ddc_detect_all_displays(GPtrArray ** i2c_open_errors_loc) {
       }
    }
 
+   // displays that might have been phantoms are reported only now
+   for (int ndx = 0; ndx < scan.held_displays->len; ndx++) {
+      Display_Ref * dref = g_ptr_array_index(scan.held_displays, ndx);
+      if (dref->dispno != DISPNO_PHANTOM)
+         ddc_emit_display_ready(dref);
+   }
+   g_ptr_array_free(scan.held_displays, true);
+   __atomic_store_n(&detection_in_progress, false, __ATOMIC_RELEASE);
+
    if (bus_open_errors->len > 0) {
       *i2c_open_errors_loc = bus_open_errors;
    }
@@ -1501,6 +1758,73 @@ ddc_detect_all_displays(GPtrArray ** i2c_open_errors_loc) {
 }
 
 
+/** Completes detection after displays have been detected individually
+ *  by #ddc_detect_single_display().
+ *
+ *  All displays are detected.  Display refs already returned to the client
+ *  remain valid, replacing the newly created display refs for the same bus
+ *  and EDID.  A display ref whose display has since changed is marked removed,
+ *  since the client may still hold it.
+ */
+STATIC void
+ddc_complete_partial_detection() {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "%d displays already detected", all_display_refs->len);
+
+   GPtrArray * partial_drefs = all_display_refs;
+   GPtrArray * partial_buses = all_i2c_buses;
+   all_display_refs = NULL;
+   all_i2c_buses = NULL;
+   partial_detection = false;
+   all_display_refs = ddc_detect_all_displays(&display_open_errors);
+
+   for (int ndx = 0; ndx < partial_drefs->len; ndx++) {
+      Display_Ref * old_dref = g_ptr_array_index(partial_drefs, ndx);
+      int new_ndx = 0;
+      Display_Ref * new_dref = NULL;
+      for (; new_ndx < all_display_refs->len; new_ndx++) {
+         Display_Ref * cur = g_ptr_array_index(all_display_refs, new_ndx);
+         if (cur->io_path.io_mode == DDCA_IO_I2C &&
+             cur->io_path.path.i2c_busno == old_dref->io_path.path.i2c_busno)
+         {
+            new_dref = cur;
+            break;
+         }
+      }
+      if (new_dref && new_dref->pedid && old_dref->pedid &&
+          memcmp(new_dref->pedid->bytes, old_dref->pedid->bytes, 128) == 0)
+      {
+         DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Retaining %s", dref_repr_t(old_dref));
+         old_dref->detail         = new_dref->detail;
+         old_dref->dispno         = new_dref->dispno;
+         old_dref->actual_display = new_dref->actual_display;
+         for (int ndx2 = 0; ndx2 < all_display_refs->len; ndx2++) {
+            Display_Ref * cur = g_ptr_array_index(all_display_refs, ndx2);
+            if (cur->actual_display == new_dref)
+               cur->actual_display = old_dref;
+         }
+         all_display_refs->pdata[new_ndx] = old_dref;
+         new_dref->flags |= DREF_TRANSIENT;
+         free_display_ref(new_dref);
+      }
+      else {
+         DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Marking removed %s", dref_repr_t(old_dref));
+         // the bus info of the partial detection is freed below
+         old_dref->detail         = i2c_find_bus_info_by_busno(old_dref->io_path.path.i2c_busno);
+         old_dref->dispno         = DISPNO_INVALID;
+         old_dref->actual_display = NULL;
+         old_dref->flags |= DREF_REMOVED;
+         g_ptr_array_add(all_display_refs, old_dref);
+      }
+   }
+   g_ptr_array_free(partial_drefs, true);
+   if (partial_buses)
+      g_ptr_array_free(partial_buses, true);
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
 /** Initializes the master display list in global variable #all_displays and
  *  records open errors in global variable #display_open_errors.
  *
@@ -1509,11 +1833,16 @@ ddc_detect_all_displays(GPtrArray ** i2c_open_errors_loc) {
 void
 ddc_ensure_displays_detected() {
    bool debug = false;
-   DBGTRC_STARTING(debug, TRACE_GROUP, "");
+   DBGTRC_STARTING(debug, TRACE_GROUP, "partial_detection=%s", sbool(partial_detection));
+   g_rec_mutex_lock(&detection_mutex);
    if (!all_display_refs) {
       // i2c_detect_buses();  // called in ddc_detect_all_displays()
       all_display_refs = ddc_detect_all_displays(&display_open_errors);
    }
+   else if (partial_detection) {
+      ddc_complete_partial_detection();
+   }
+   g_rec_mutex_unlock(&detection_mutex);
    DBGTRC_DONE(debug, TRACE_GROUP,
                "all_displays=%p, all_displays has %d displays",
                all_display_refs, all_display_refs->len);
@@ -1532,8 +1861,11 @@ void
 ddc_discard_detected_displays() {
    bool debug = false;
    DBGTRC_STARTING(debug, TRACE_GROUP, "");
+   // queued events refer to the display refs about to be freed
+   ddc_flush_display_status_events();
    // grab locks to prevent any opens?
    ddc_close_all_displays();
+   i2c_handle_pool_invalidate(-1);
 #ifdef ENABLE_USB
    discard_usb_monitor_list();
 #endif
@@ -1557,27 +1889,146 @@ ddc_discard_detected_displays() {
    }
    free_sys_drm_connectors();
    i2c_discard_buses();
+   cached_buses_restored = false;
+   partial_detection = false;
    DBGTRC_DONE(debug, TRACE_GROUP, "");
 }
 
 
-void
-ddc_redetect_displays() {
+/** Checks, using only sysfs, whether the display on a bus appears to be
+ *  unchanged since the bus was last examined.
+ *
+ *  @param  businfo  bus information from the previous detection
+ *  @return true if the DRM connector status and EDID are unchanged,
+ *          false if they changed or cannot be determined from sysfs
+ */
+STATIC bool
+is_bus_unchanged_per_sysfs(I2C_Bus_Info * businfo) {
    bool debug = false;
-   DBGTRC_STARTING(debug, TRACE_GROUP, "all_displays=%p", all_display_refs);
-   SYSLOG2(DDCA_SYSLOG_NOTICE, "Display redetection starting.");
-   DDCA_Display_Event_Class enabled_classes = DDCA_EVENT_CLASS_NONE;
-   DDCA_Status active_rc = ddc_get_active_watch_classes(&enabled_classes);
-   if (active_rc) {
-      DDCA_Status rc = ddc_stop_watch_displays(/*wait*/ true, &enabled_classes);
-      assert(rc == DDCRC_OK);
+   DBGTRC_STARTING(debug, TRACE_GROUP, "busno=%d, drm_connector_name=%s",
+                                       businfo->busno, businfo->drm_connector_name);
+   bool result = false;
+   if (businfo->drm_connector_name) {
+      int depth = (IS_DBGTRC(debug, TRACE_GROUP)) ? 1 : -1;
+      char * status = NULL;
+      RPT_ATTR_TEXT(depth, &status, "/sys/class/drm", businfo->drm_connector_name, "status");
+      GByteArray * sysfs_edid = NULL;
+      RPT_ATTR_EDID(depth, &sysfs_edid, "/sys/class/drm", businfo->drm_connector_name, "edid");
+      bool connected = status && streq(status, "connected");
+      bool has_edid  = sysfs_edid && sysfs_edid->len >= 128;
+      if (businfo->edid)
+         result = connected && has_edid && memcmp(sysfs_edid->data, businfo->edid->bytes, 128) == 0;
+      else
+         result = !connected && !has_edid;
+      free(status);
+      if (sysfs_edid)
+         g_byte_array_free(sysfs_edid, true);
    }
-   ddc_discard_detected_displays();
+   DBGTRC_RET_BOOL(debug, TRACE_GROUP, result, "");
+   return result;
+}
+
+
+/** Removes and frees the display refs for a bus.
+ *
+ *  @param  busno  I2C bus number
+ */
+STATIC void
+discard_display_refs_by_busno(int busno) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "busno=%d", busno);
+   int ndx = 0;
+   while (ndx < all_display_refs->len) {
+      Display_Ref * dref = g_ptr_array_index(all_display_refs, ndx);
+      if (dref->io_path.io_mode == DDCA_IO_I2C && dref->io_path.path.i2c_busno == busno) {
+         for (int ndx2 = 0; ndx2 < all_display_refs->len; ndx2++) {
+            Display_Ref * other = g_ptr_array_index(all_display_refs, ndx2);
+            if (other->actual_display == dref) {
+               other->actual_display = NULL;
+               other->dispno = DISPNO_INVALID;
+            }
+         }
+         g_ptr_array_remove_index(all_display_refs, ndx);
+         DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Discarding %s", dref_repr_t(dref));
+         dref->flags |= DREF_TRANSIENT;  // allow the Display_Ref to be freed
+         free_display_ref(dref);
+      }
+      else {
+         ndx++;
+      }
+   }
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+/** Rebuilds the I2C entries of #display_open_errors from #all_i2c_buses,
+ *  as by #ddc_detect_all_displays().  Entries for USB devices are retained.
+ */
+STATIC void
+refresh_i2c_open_errors() {
+   bool debug = false;
+   if (!display_open_errors)
+      display_open_errors = g_ptr_array_new();
+   int ndx = 0;
+   while (ndx < display_open_errors->len) {
+      Bus_Open_Error * boe = g_ptr_array_index(display_open_errors, ndx);
+      if (boe->io_mode == DDCA_IO_I2C) {
+         g_ptr_array_remove_index(display_open_errors, ndx);
+         free(boe->detail);
+         free(boe);
+      }
+      else {
+         ndx++;
+      }
+   }
+   int i2c_ct = 0;
+   for (ndx = 0; ndx < all_i2c_buses->len; ndx++) {
+      I2C_Bus_Info * businfo = g_ptr_array_index(all_i2c_buses, ndx);
+      if ( !((businfo->flags & I2C_BUS_ADDR_0X50) && businfo->edid) &&
+           !(businfo->flags & I2C_BUS_ACCESSIBLE) )
+      {
+         // I2C errors precede USB errors
+         g_ptr_array_insert(display_open_errors, i2c_ct++, new_bus_open_error_by_businfo(businfo));
+      }
+   }
+   DBGTRC_EXECUTED(debug, TRACE_GROUP, "%d I2C open errors", i2c_ct);
+}
+
+
+static gint
+compare_businfo_busno(gconstpointer a, gconstpointer b) {
+   const I2C_Bus_Info * ba = *(I2C_Bus_Info **) a;
+   const I2C_Bus_Info * bb = *(I2C_Bus_Info **) b;
+   return ba->busno - bb->busno;
+}
+
+
+/** Redetects displays, examining only buses whose state has changed.
+ *
+ *  The display refs for buses whose DRM connector status and EDID are unchanged
+ *  are retained, along with the results of their initial checks.  Buses that
+ *  no longer exist are discarded.  New buses, and buses on which the display
+ *  changed, are probed and their displays checked as by #ddc_add_display_by_businfo().
+ *  If the DRM connector state of a bus cannot be determined from sysfs,
+ *  the bus is probed and its EDID compared with the previous one.
+ *
+ *  As with full redetection, dynamic sleep statistics are saved and reloaded,
+ *  I2C open errors are recomputed, and the display configuration fingerprint
+ *  stored with the displays cache is updated.  USB displays are unaffected.
+ */
+STATIC void
+ddc_redetect_displays_incremental() {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "all_display_refs->len=%d", all_display_refs->len);
+   assert(all_display_refs && all_i2c_buses);
+
+   // queued events refer to display refs that may be freed
+   ddc_flush_display_status_events();
+   ddc_close_all_displays();
+   i2c_handle_pool_invalidate(-1);
    if (dsa2_is_enabled())
       dsa2_save_persistent_stats();
-   // free_sysfs_drm_connector_names();
-
-   // init_sysfs_drm_connector_names();
+   free_sys_drm_connectors();
    get_sys_drm_connectors(/*rescan=*/true);
    if (dsa2_is_enabled()) {
       Error_Info * erec = dsa2_restore_persistent_stats();
@@ -1587,8 +2038,141 @@ ddc_redetect_displays() {
          free(erec);
       }
    }
-   i2c_detect_buses();
-   all_display_refs = ddc_detect_all_displays(&display_open_errors);
+
+   Bit_Set_256 cur_buses = i2c_detect_attached_buses_as_bitset();
+   Bit_Set_256 old_buses = EMPTY_BIT_SET_256;
+   int kept_ct = 0;
+   GPtrArray * changed_buses = g_ptr_array_new();   // new I2C_Bus_Info for changed or new buses
+
+   int ndx = 0;
+   while (ndx < all_i2c_buses->len) {
+      I2C_Bus_Info * old_businfo = g_ptr_array_index(all_i2c_buses, ndx);
+      int busno = old_businfo->busno;
+      old_buses = bs256_insert(old_buses, busno);
+      bool unchanged = false;
+      I2C_Bus_Info * new_businfo = NULL;
+      if (bs256_contains(cur_buses, busno)) {
+         unchanged = is_bus_unchanged_per_sysfs(old_businfo);
+         if (!unchanged && !old_businfo->drm_connector_name) {
+            // no DRM connector state to compare, probe the bus and compare EDIDs
+            new_businfo = i2c_new_bus_info(busno);
+            new_businfo->flags = I2C_BUS_EXISTS | I2C_BUS_VALID_NAME_CHECKED | I2C_BUS_HAS_VALID_NAME;
+            i2c_check_bus(new_businfo);
+            if (old_businfo->edid && new_businfo->edid)
+               unchanged = memcmp(old_businfo->edid->bytes, new_businfo->edid->bytes, 128) == 0;
+            else
+               unchanged = !old_businfo->edid && !new_businfo->edid;
+            if (unchanged) {
+               i2c_free_bus_info(new_businfo);
+               new_businfo = NULL;
+            }
+         }
+      }
+      if (unchanged) {
+         DBGTRC_NOPREFIX(debug, TRACE_GROUP, "bus %d unchanged", busno);
+         kept_ct++;
+         ndx++;
+      }
+      else {
+         DBGTRC_NOPREFIX(debug, TRACE_GROUP, "bus %d changed or removed", busno);
+         discard_display_refs_by_busno(busno);
+         g_ptr_array_remove_index(all_i2c_buses, ndx);   // frees old_businfo
+         if (bs256_contains(cur_buses, busno)) {
+            if (!new_businfo) {
+               new_businfo = i2c_new_bus_info(busno);
+               new_businfo->flags = I2C_BUS_EXISTS | I2C_BUS_VALID_NAME_CHECKED | I2C_BUS_HAS_VALID_NAME;
+            }
+            g_ptr_array_add(changed_buses, new_businfo);
+         }
+      }
+   }
+
+   Bit_Set_256 added_buses = bs256_and_not(cur_buses, old_buses);
+   Bit_Set_256_Iterator iter = bs256_iter_new(added_buses);
+   int busno;
+   while ( (busno = bs256_iter_next(iter)) >= 0) {
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "bus %d added", busno);
+      I2C_Bus_Info * new_businfo = i2c_new_bus_info(busno);
+      new_businfo->flags = I2C_BUS_EXISTS | I2C_BUS_VALID_NAME_CHECKED | I2C_BUS_HAS_VALID_NAME;
+      g_ptr_array_add(changed_buses, new_businfo);
+   }
+   bs256_iter_free(iter);
+
+   dispno_max = 0;
+   for (ndx = 0; ndx < all_display_refs->len; ndx++) {
+      Display_Ref * dref = g_ptr_array_index(all_display_refs, ndx);
+      if (dref->dispno > dispno_max)
+         dispno_max = dref->dispno;
+   }
+
+   int added_ct = 0;
+   for (ndx = 0; ndx < changed_buses->len; ndx++) {
+      I2C_Bus_Info * businfo = g_ptr_array_index(changed_buses, ndx);
+      g_ptr_array_add(all_i2c_buses, businfo);
+      Display_Ref * dref = ddc_add_display_by_businfo(businfo);
+      if (dref) {
+         added_ct++;
+         if (dref->flags & DREF_DDC_BUSY)
+            dref->dispno = DISPNO_BUSY;
+         else if (dref->flags & DREF_DDC_COMMUNICATION_WORKING)
+            dref->dispno = ++dispno_max;
+      }
+   }
+   g_ptr_array_sort(all_i2c_buses, compare_businfo_busno);
+   if (added_ct > 0)
+      filter_phantom_displays(all_display_refs);
+   refresh_i2c_open_errors();
+   // the bus information now reflects the current configuration
+   if (display_caching_enabled)
+      ddc_update_displays_fingerprint();
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "Retained %d buses, probed %d buses, added %d displays",
+                                   kept_ct, changed_buses->len, added_ct);
+   g_ptr_array_free(changed_buses, true);
+}
+
+
+/** Redetects displays.
+ *
+ *  If incremental redetection is enabled and displays have already been
+ *  detected, only buses whose state changed are reexamined and the display
+ *  refs for unchanged displays remain valid.  Otherwise all detected displays
+ *  are discarded and detection is performed from scratch.
+ */
+void
+ddc_redetect_displays() {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "all_displays=%p, incremental_redetection=%s",
+                                       all_display_refs, sbool(ddc_incremental_redetection));
+   SYSLOG2(DDCA_SYSLOG_NOTICE, "Display redetection starting.");
+   DDCA_Display_Event_Class enabled_classes = DDCA_EVENT_CLASS_NONE;
+   DDCA_Status active_rc = ddc_get_active_watch_classes(&enabled_classes);
+   if (active_rc) {
+      DDCA_Status rc = ddc_stop_watch_displays(/*wait*/ true, &enabled_classes);
+      assert(rc == DDCRC_OK);
+   }
+   if (ddc_incremental_redetection && all_display_refs && all_i2c_buses && !partial_detection) {
+      ddc_redetect_displays_incremental();
+   }
+   else {
+      ddc_discard_detected_displays();
+      if (dsa2_is_enabled())
+         dsa2_save_persistent_stats();
+      // free_sysfs_drm_connector_names();
+
+      // init_sysfs_drm_connector_names();
+      get_sys_drm_connectors(/*rescan=*/true);
+      if (dsa2_is_enabled()) {
+         Error_Info * erec = dsa2_restore_persistent_stats();
+         if (erec) {
+            MSG_W_SYSLOG(DDCA_SYSLOG_ERROR, "Unexpected error from dsa2_restore_persistent_stats(): %s",
+                  errinfo_summary(erec));
+            free(erec);
+         }
+      }
+      i2c_detect_buses();
+      all_display_refs = ddc_detect_all_displays(&display_open_errors);
+   }
    if (debug) {
       ddc_dbgrpt_drefs("all_displays:", all_display_refs, 1);
       // dbgrpt_valid_display_refs(1);
@@ -1646,13 +2230,18 @@ DDCA_Status
 ddc_validate_display_ref(Display_Ref * dref, bool require_not_asleep) {
    bool debug = false;
    DBGTRC_STARTING(debug, TRACE_GROUP, "dref=%p -> %s", dref, dref_repr_t(dref));
-   assert(all_display_refs);
+   // display ready callbacks are invoked before all_display_refs is set
+   bool in_detection = __atomic_load_n(&detection_in_progress, __ATOMIC_ACQUIRE);
+   assert(all_display_refs || in_detection);
    
    int d = (IS_DBGTRC(debug, DDCA_TRC_NONE)) ? 1 : -1;
    DDCA_Status ddcrc = DDCRC_OK;
    if (!dref || memcmp(dref->marker, DISPLAY_REF_MARKER, 4) != 0)
          ddcrc = DDCRC_ARG;
-   else if (dref->dispno < 0)   // needed? 
+   // during detection, a working display reported to a display ready
+   // callback does not yet have a display number
+   else if (dref->dispno < 0 &&
+            !(in_detection && (dref->flags & DREF_DDC_COMMUNICATION_WORKING)) )   // needed? 
       ddcrc = DDCRC_ARG;
    else if (all_video_drivers_implement_drm) {
       if (!dref->drm_connector)
@@ -1738,6 +2327,96 @@ ddc_displays_already_detected()
 }
 
 
+/** Indicates whether only individually requested displays have been detected,
+ *  i.e. lazy detection is in effect and full detection has not yet occurred.
+ *
+ *  @return true/false
+ */
+bool
+ddc_displays_partially_detected() {
+   return partial_detection;
+}
+
+
+/** Indicates whether detection of all displays is in progress, i.e.
+ *  whether display ready callbacks may currently be invoked.
+ *
+ *  @return true/false
+ */
+bool
+ddc_display_detection_in_progress() {
+   return __atomic_load_n(&detection_in_progress, __ATOMIC_ACQUIRE);
+}
+
+
+/** In lazy detection mode, detects the display on a single I2C bus without
+ *  detecting the displays on other buses.
+ *
+ *  The bus can be specified either by number or by the EDID of the display,
+ *  in which case the bus is found using the DRM connectors in sysfs.
+ *  Phantom display filtering is not performed for individually detected
+ *  displays.  Display numbers are assigned in the order displays are
+ *  requested, and can change when full detection is performed.
+ *
+ *  @param  busno      I2C bus number, -1 to use **edidbytes**
+ *  @param  edidbytes  128 byte EDID, used if busno < 0
+ *  @param  dref_loc   where to return the display ref, NULL if no display
+ *  @return true if the lookup was performed, false if the caller must
+ *          use full detection instead
+ */
+bool
+ddc_detect_single_display(int busno, Byte * edidbytes, Display_Ref ** dref_loc) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "busno=%d, edidbytes=%p", busno, edidbytes);
+   *dref_loc = NULL;
+   bool performed = false;
+   g_rec_mutex_lock(&detection_mutex);
+   if (!all_display_refs || partial_detection) {
+      if (busno < 0 && edidbytes) {
+         Sys_Drm_Connector * conn = find_sys_drm_connector_by_edid(edidbytes);
+         if (conn)
+            busno = conn->i2c_busno;
+      }
+   }
+   if (busno >= 0 && (!all_display_refs || partial_detection)) {
+      performed = true;
+      if (!all_display_refs) {
+         all_display_refs = g_ptr_array_new();
+         partial_detection = true;
+         dispno_max = 0;
+      }
+      Display_Ref * dref = NULL;
+      for (int ndx = 0; ndx < all_display_refs->len; ndx++) {
+         Display_Ref * cur = g_ptr_array_index(all_display_refs, ndx);
+         if (cur->io_path.io_mode == DDCA_IO_I2C && cur->io_path.path.i2c_busno == busno) {
+            dref = cur;
+            break;
+         }
+      }
+      if (!dref) {
+         I2C_Bus_Info * businfo = (all_i2c_buses) ? i2c_find_bus_info_by_busno(busno) : NULL;
+         if (!businfo)
+            businfo = i2c_detect_single_bus(busno);
+         if (businfo)
+            dref = ddc_add_display_by_businfo(businfo);
+         if (dref) {
+            if (businfo->drm_connector_name)
+               dref->drm_connector = g_strdup(businfo->drm_connector_name);
+            if (dref->flags & DREF_DDC_BUSY)
+               dref->dispno = DISPNO_BUSY;
+            else if (dref->flags & DREF_DDC_COMMUNICATION_WORKING)
+               dref->dispno = ++dispno_max;
+         }
+      }
+      if (dref && !(edidbytes && dref->pedid && memcmp(dref->pedid->bytes, edidbytes, 128) != 0))
+         *dref_loc = dref;
+   }
+   g_rec_mutex_unlock(&detection_mutex);
+   DBGTRC_RET_BOOL(debug, TRACE_GROUP, performed, "*dref_loc=%s", dref_repr_t(*dref_loc));
+   return performed;
+}
+
+
 /** Controls whether USB displays are to be detected.
  *
  *  Must be called before any function that triggers display detection.
@@ -1933,7 +2612,10 @@ void check_drefs_alive() {
 void init_ddc_displays() {
    RTTI_ADD_FUNC(check_how_unsupported_reported);
    RTTI_ADD_FUNC(ddc_add_display_by_businfo);
-   RTTI_ADD_FUNC(ddc_async_scan);
+   RTTI_ADD_FUNC(ddc_scan_add_display);
+   RTTI_ADD_FUNC(ddc_scan_bus_checked);
+   RTTI_ADD_FUNC(ddc_scan_complete);
+   RTTI_ADD_FUNC(ddc_scan_display_checked);
    RTTI_ADD_FUNC(ddc_detect_all_displays);
    RTTI_ADD_FUNC(ddc_discard_detected_displays);
    RTTI_ADD_FUNC(ddc_displays_already_detected);
@@ -1942,6 +2624,12 @@ void init_ddc_displays() {
    RTTI_ADD_FUNC(ddc_initial_checks_by_dref);
    RTTI_ADD_FUNC(ddc_non_async_scan);
    RTTI_ADD_FUNC(ddc_redetect_displays);
+   RTTI_ADD_FUNC(ddc_redetect_displays_incremental);
+   RTTI_ADD_FUNC(refresh_i2c_open_errors);
+   RTTI_ADD_FUNC(ddc_complete_partial_detection);
+   RTTI_ADD_FUNC(ddc_detect_single_display);
+   RTTI_ADD_FUNC(discard_display_refs_by_busno);
+   RTTI_ADD_FUNC(is_bus_unchanged_per_sysfs);
    RTTI_ADD_FUNC(drefs_edid_equal);
    RTTI_ADD_FUNC(has_duplicate_edids);
    RTTI_ADD_FUNC(filter_phantom_displays);
@@ -1951,10 +2639,19 @@ void init_ddc_displays() {
    RTTI_ADD_FUNC(ddc_validate_display_ref);
    RTTI_ADD_FUNC(ddc_remove_display_by_businfo);
    RTTI_ADD_FUNC(ddc_get_dref_by_busno_or_connector);
+
+   live_dref_busno_index     = pai_new(g_direct_hash, g_direct_equal, NULL,
+                                       live_dref_busno_key, live_dref_busno_match);
+   live_dref_connector_index = pai_new(g_str_hash, g_str_equal, g_free,
+                                       live_dref_connector_key, live_dref_connector_match);
 }
 
 
 void terminate_ddc_displays() {
    ddc_discard_detected_displays();
+   pai_free(live_dref_busno_index);
+   pai_free(live_dref_connector_index);
+   live_dref_busno_index = NULL;
+   live_dref_connector_index = NULL;
 }
 
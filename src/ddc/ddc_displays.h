@@ -26,6 +26,8 @@
 extern bool  monitor_state_tests;
 extern bool  detect_phantom_displays;
 extern bool  skip_ddc_checks;
+extern bool  ddc_incremental_redetection;
+extern bool  ddc_lazy_display_detection;
 
 // Initial Checks
 void         ddc_set_async_threshold(int threshold);
@@ -44,6 +46,9 @@ void         ddc_ensure_displays_detected();
 void         ddc_discard_detected_displays();
 void         ddc_redetect_displays();
 bool         ddc_displays_already_detected();
+bool         ddc_displays_partially_detected();
+bool         ddc_display_detection_in_progress();
+bool         ddc_detect_single_display(int busno, Byte * edidbytes, Display_Ref ** dref_loc);
 Display_Ref* detect_display_by_businfo(I2C_Bus_Info * businfo);
 DDCA_Status  ddc_enable_usb_display_detection(bool onoff);
 bool         ddc_is_usb_display_detection_enabled();
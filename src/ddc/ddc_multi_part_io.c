@@ -202,6 +202,8 @@ multi_part_read_with_retry(
       DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE,
              "Start of while loop. try_ctr=%d, max_multi_part_read_tries=%d",
              tryctr, max_multi_part_read_tries);
+      if (tryctr == 1)
+         optime_retry_begin();
 
       ddc_excp = try_multi_part_read(
               dh,
@@ -246,6 +248,8 @@ multi_part_read_with_retry(
       // write_read_flags = write_read_flags & ~Write_Read_Flag_All_Zero_Response_Ok;           // accept all zero response only on first fragment
       tryctr++;
    }
+   if (tryctr > 1)
+      optime_retry_end();
    ASSERT_IFF( rc==0, !ddc_excp);
    DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "After try loop. tryctr=%d, rc=%d. ddc_excp=%s",
                             tryctr, rc, errinfo_summary(ddc_excp));
@@ -377,6 +381,8 @@ multi_part_write_with_retry(
       DBGTRC_NOPREFIX(debug, TRACE_GROUP,
              "Start of while loop. try_ctr=%d, max_multi_part_write_tries=%d",
              tryctr, max_multi_part_write_tries);
+      if (tryctr == 1)
+         optime_retry_begin();
 
       ddc_excp = try_multi_part_write(
               dh,
@@ -390,6 +396,8 @@ multi_part_write_with_retry(
 
       tryctr++;
    }
+   if (tryctr > 1)
+      optime_retry_end();
    assert( (ddc_excp && rc < 0) || (!ddc_excp && rc==0) );
 
    if (rc < 0) {
@@ -29,6 +29,7 @@
 #include "util/report_util.h"
 #include "util/string_util.h"
 #include "util/sysfs_util.h"
+#include "util/timestamp.h"
 #include "util/utilrpt.h"
 /** \endcond */
 
@@ -38,9 +39,11 @@
 #include "base/displays.h"
 #include "base/dsa2.h"
 #include "base/execution_stats.h"
+#include "base/flight_recorder.h"
 #include "base/parms.h"
 #include "base/rtti.h"
 #include "base/status_code_mgt.h"
+#include "base/timeline.h"
 #include "base/tuned_sleep.h"
 #include "base/per_display_data.h"
 
@@ -182,12 +185,27 @@ ddc_open_display(
    Error_Info * err = NULL;
    int fd = -1;
 
-   if (dref->drm_connector && strlen(dref->drm_connector) > 0) {
-      char * status;
-      RPT_ATTR_TEXT(-1, &status, "/sys/class/drm", dref->drm_connector, "status");
-      if (streq(status, "disconnected"))
-         err = ERRINFO_NEW(DDCRC_DISCONNECTED, "Display disconnected");
-      free(status);
+   // A pooled handle has been validated since the last hotplug or DPMS event
+   bool pooled = dref->io_path.io_mode == DDCA_IO_I2C &&
+                 i2c_handle_pool_contains(dref->io_path.path.i2c_busno);
+   if (dref->drm_connector && strlen(dref->drm_connector) > 0 && !pooled) {
+      I2C_Bus_Info * businfo = (dref->io_path.io_mode == DDCA_IO_I2C) ? dref->detail : NULL;
+      int cached_status = 0;
+      if (businfo && i2c_state_cache_lookup(&businfo->connected_cache,
+                                            DDCA_EVENT_CLASS_DISPLAY_CONNECTION, &cached_status))
+      {
+         if (cached_status != 0)
+            err = ERRINFO_NEW(cached_status, "Display disconnected");
+      }
+      else {
+         char * status;
+         RPT_ATTR_TEXT(-1, &status, "/sys/class/drm", dref->drm_connector, "status");
+         if (streq(status, "disconnected"))
+            err = ERRINFO_NEW(DDCRC_DISCONNECTED, "Display disconnected");
+         free(status);
+         if (businfo)
+            i2c_state_cache_save(&businfo->connected_cache, (err) ? DDCRC_DISCONNECTED : 0);
+      }
       if (err)
          goto bye;
    }
@@ -223,7 +241,8 @@ ddc_open_display(
 
          if (!err) {
             DBGMSF(debug, "Calling i2c_open_bus() ...");
-            Error_Info * err2 = i2c_open_bus(dref->io_path.path.i2c_busno, callopts, &fd);
+            Error_Info * err2 = i2c_open_bus(dref->io_path.path.i2c_busno,
+                                             callopts | CALLOPT_POOLED, &fd);
             ASSERT_IFF(err2, fd == -1);
             if (err2) {
                err = errinfo_new_with_cause(err2->status_code, err2, __func__,
@@ -527,11 +546,14 @@ DDCA_Status ddc_i2c_write_read_raw(
  *  \param expected_subtype    expected subtype to check for
  *  \param response_packet_ptr_loc  where to write address of response packet received
  *
- *  \return pointer to #Error_Info struct if failure, NULL if success
+ *  \return status code, 0 if success
+ *  \remark
+ *  Returns a status code rather than an #Error_Info so that a failed try
+ *  that is followed by a successful retry does not allocate memory.
  *  \remark
  *  Issue: positive ADL codes, need to handle?
  */
-Error_Info *
+DDCA_Status
 ddc_write_read(
       Display_Handle * dh,
       DDC_Packet *     request_packet_ptr,
@@ -552,7 +574,8 @@ ddc_write_read(
    DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE,
          "Adding 1 to max_read_bytes to allow for initial double 0x63 quirk");
    max_read_bytes++;   //allow for quirk of double 0x6e at start
-   Byte * readbuf = calloc(1, max_read_bytes);
+   assert(max_read_bytes <= MAX_DDC_PACKET_SIZE+1);
+   Byte readbuf[MAX_DDC_PACKET_SIZE+1] = {0};
    int    bytes_received = max_read_bytes;
    DDCA_Status    psc;
    *response_packet_ptr_loc = NULL;
@@ -591,15 +614,15 @@ ddc_write_read(
        }
 
        if (psc != 0 && *response_packet_ptr_loc) {  // paranoid,  should never occur
-          free(*response_packet_ptr_loc);
+          free_ddc_packet(*response_packet_ptr_loc);
           *response_packet_ptr_loc = NULL;
        }
    }
-   free(readbuf);    // or does response_packet_ptr_loc point into here?
 
-   Error_Info * excp = (psc < 0) ? ERRINFO_NEW(psc,NULL) : NULL;
-   DBGTRC_RET_ERRINFO_STRUCT(debug, TRACE_GROUP, excp, response_packet_ptr_loc, dbgrpt_packet);
-   return excp;
+   DBGTRC_RET_DDCRC(debug, TRACE_GROUP, psc, "*response_packet_ptr_loc=%p", *response_packet_ptr_loc);
+   if (*response_packet_ptr_loc && IS_DBGTRC(debug, TRACE_GROUP))
+      dbgrpt_packet(*response_packet_ptr_loc, 2);
+   return psc;
 }
 
 
@@ -650,9 +673,11 @@ ddc_write_read_with_retry(
    int  ddcrc_null_response_max = 3;
    DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE,"ddcrc_null_response_max=%d, read_bytewise=%s",
                                         ddcrc_null_response_max, sbool(read_bytewise));
-   Error_Info * try_errors[MAX_MAX_TRIES] = {NULL};
+   Error_Status_Trail try_errors;
+   errinfo_status_trail_init(&try_errors, "ddc_write_read");
 
    TRACED_ASSERT(max_tries >= 1);
+   assert(max_tries <= ERRINFO_STATUS_TRAIL_MAX);
    for (tryctr=0, psc=-999, retryable=true;
         tryctr < max_tries && psc < 0 && retryable;
         tryctr++)
@@ -662,9 +687,11 @@ ddc_write_read_with_retry(
          "read_bytewise=%s, sleep-multiplier=%5.2f",
          tryctr, max_tries, psc_name_code(psc), sbool(retryable),
          sbool(read_bytewise), pdd_get_adjusted_sleep_multiplier(pdd) );
+      if (tryctr == 1)
+         optime_retry_begin();
 
-
-      Error_Info * cur_excp = ddc_write_read(
+      uint64_t try_start = cur_realtime_nanosec();
+      psc = ddc_write_read(
                 dh,
                 request_packet_ptr,
                 read_bytewise,
@@ -672,14 +699,18 @@ ddc_write_read_with_retry(
                 expected_response_type,
                 expected_subtype,
                 response_packet_ptr_loc);
+      frec_record(dh->dref->io_path.path.i2c_busno, request_packet_ptr->type, expected_subtype,
+                  psc, tryctr+1, pdd_get_adjusted_sleep_multiplier(pdd),
+                  cur_realtime_nanosec() - try_start);
+      timeline_span_end("ddc_write_read try", "ddc", try_start,
+                        dh->dref->io_path.path.i2c_busno, "try", tryctr+1);
 
       // TESTCASES:
       // if (tryctr < 2)
-      //    cur_excp = ERRINFO_NEW(DDCRC_NULL_RESPONSE, "dummy");
-      // cur_excp = errinfo_new(-EIO, "dummy");
+      //    psc = DDCRC_NULL_RESPONSE;
+      // psc = -EIO;
 
-      psc = (cur_excp) ? cur_excp->status_code : 0;
-      try_errors[tryctr] = cur_excp;
+      errinfo_status_trail_add(&try_errors, psc);
 
       if (psc == 0 && ddcrc_null_response_ct > 0) {
          DBGTRC_NOPREFIX(debug, TRACE_GROUP | DDCA_TRC_RETRY,
@@ -800,6 +831,8 @@ ddc_write_read_with_retry(
 
       }
    }  // for loop
+   if (tryctr > 1)
+      optime_retry_end();
 
    // tryctr = number of times through loop, i.e. 1..max_tries
    assert(tryctr >= 1 && tryctr <= max_tries);
@@ -824,19 +857,15 @@ ddc_write_read_with_retry(
    }
    pdd_record_final_by_dh(dh, psc, adjusted_tryctr);
 
-   Error_Info * errors_found[MAX_MAX_TRIES];
-   int errct = 0;
-   for (int ndx = 0; ndx < MAX_MAX_TRIES; ndx++) {
-      if (try_errors[ndx])
-         errors_found[errct++] = try_errors[ndx];
+   if (IS_DBGTRC(debug, TRACE_GROUP | DDCA_TRC_RETRY)) {
+      char * s = errinfo_status_trail_summary(&try_errors);
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP | DDCA_TRC_RETRY,
+                      "%s,%s after %d error(s): %s",
+                      dh_repr(dh),
+                      (psc == 0) ? "Succeeded" : "Failed",
+                      try_errors.ct, s);
+      free(s);
    }
-   char * s = errinfo_array_summary(errors_found, errct);
-   DBGTRC_NOPREFIX(debug, TRACE_GROUP | DDCA_TRC_RETRY,
-                   "%s,%s after %d error(s): %s",
-                   dh_repr(dh),
-                   (psc == 0) ? "Succeeded" : "Failed",
-                   errct, s);
-   free(s);
 
    Error_Info * ddc_excp = NULL;
 
@@ -858,16 +887,15 @@ ddc_write_read_with_retry(
          psc = DDCRC_ALL_RESPONSES_NULL;
       }
 
-      ddc_excp = errinfo_new_with_causes(psc, errors_found, errct, __func__, NULL);
+      char * recent = frec_summary_by_busno(dh->dref->io_path.path.i2c_busno, 2*max_tries);
+      // Error_Info records for the individual tries are only built now that
+      // the operation has failed
+      ddc_excp = errinfo_new_from_status_trail(psc, &try_errors, __func__, (recent) ? "%s" : NULL, recent);
+      free(recent);
 
-      if (psc != try_errors[tryctr-1]->status_code)
+      if (psc != try_errors.status_codes[try_errors.ct-1])
          COUNT_STATUS_CODE(psc);     // new status code, count it
    }
-   else {
-      for (int ndx = 0; ndx < tryctr-1; ndx++) {
-         BASE_ERRINFO_FREE_WITH_REPORT(try_errors[ndx], IS_DBGTRC(debug, TRACE_GROUP));
-      }
-   }
 
    try_data_record_tries2(dh, WRITE_READ_TRIES_OP, psc, tryctr);
 
@@ -924,35 +952,7 @@ ddc_i2c_write_only(
 }
 
 
-/* Writes a DDC request packet to a monitor
- *
- * \param  dh                  Display_Handle for open I2C or ADL device
- * \param  request_packet_ptr  DDC packet to write
- * \return NULL if success, #Error_Info struct if error
- *
- * @todo
- * Eliminate this function, it used to route to the ADL version as
- * well as ddc_i2c_write_only()
- */
-Error_Info *
-ddc_write_only(
-      Display_Handle * dh,
-      DDC_Packet *     request_packet_ptr)
-{
-   bool debug = false;
-   DBGTRC_STARTING(debug, TRACE_GROUP, "");
-
-   TRACED_ASSERT(dh->dref->io_path.io_mode == DDCA_IO_I2C);
-
-   DDCA_Status psc = ddc_i2c_write_only(dh, request_packet_ptr);
-   Error_Info *  ddc_excp = (psc) ? ERRINFO_NEW(psc,NULL) : NULL;
-
-   DBGTRC_DONE(debug, TRACE_GROUP, "Returning: %s", errinfo_summary(ddc_excp));
-   return ddc_excp;
-}
-
-
-/* Wraps ddc_write_only() in retry logic.
+/* Wraps ddc_i2c_write_only() in retry logic.
  *
  *  \param  dh                  display handle (for either I2C or ADL device)
  *  \param  request_packet_ptr  DDC packet to write
@@ -974,10 +974,12 @@ ddc_write_only_with_retry(
    DDCA_Status        psc;
    int                tryctr;
    bool               retryable;
-   Error_Info *       try_errors[MAX_MAX_TRIES];
+   Error_Status_Trail try_errors;
+   errinfo_status_trail_init(&try_errors, "ddc_i2c_write_only");
 
    int max_tries = try_data_get_maxtries2(WRITE_ONLY_TRIES_OP);
    TRACED_ASSERT(max_tries > 0);
+   assert(max_tries <= ERRINFO_STATUS_TRAIL_MAX);
    for (tryctr=0, psc=-999, retryable=true;
        tryctr < max_tries && psc < 0 && retryable;
        tryctr++)
@@ -985,13 +987,22 @@ ddc_write_only_with_retry(
       DBGMSF(debug,
              "Start of try loop, tryctr=%d, max_tries=%d, rc=%d, retryable=%d",
              tryctr, max_tries, psc, retryable );
-
-      Error_Info * cur_excp = ddc_write_only(dh, request_packet_ptr);
-      psc = (cur_excp) ? cur_excp->status_code : 0;
-      try_errors[tryctr] = cur_excp;
+      if (tryctr == 1)
+         optime_retry_begin();
+
+      uint64_t try_start = cur_realtime_nanosec();
+      // an Error_Info is only built if all tries fail
+      psc = ddc_i2c_write_only(dh, request_packet_ptr);
+      frec_record(dh->dref->io_path.path.i2c_busno, request_packet_ptr->type,
+                  0,    // no reply expected
+                  psc, tryctr+1, pdd_get_adjusted_sleep_multiplier(dh->dref->pdd),
+                  cur_realtime_nanosec() - try_start);
+      errinfo_status_trail_add(&try_errors, psc);
       if (psc == -EBUSY)
          retryable = false;
    }
+   if (tryctr > 1)
+      optime_retry_end();
 
    Error_Info * ddc_excp = NULL;
 
@@ -1009,23 +1020,24 @@ ddc_write_only_with_retry(
 
       if (retryable) {
          psc = DDCRC_RETRIES;
-         ddc_excp = errinfo_new_with_causes(psc, try_errors, tryctr, __func__, NULL);
-         if (psc != try_errors[tryctr-1]->status_code)
+         char * recent = frec_summary_by_busno(dh->dref->io_path.path.i2c_busno, 2*max_tries);
+         ddc_excp = errinfo_new_from_status_trail(psc, &try_errors, __func__, (recent) ? "%s" : NULL, recent);
+         free(recent);
+         if (psc != try_errors.status_codes[try_errors.ct-1])
             COUNT_STATUS_CODE(psc);     // new status code, count it
       }
+      else if (tryctr == 1) {
+         ddc_excp = errinfo_new(psc, try_errors.func, NULL);
+      }
       else {
-         assert (tryctr == 1);
-         ddc_excp = try_errors[0];
+         ddc_excp = errinfo_new_from_status_trail(psc, &try_errors, __func__, NULL);
       }
    }
-   else {
-      // 2 possibilities:
-      //   succeeded after retries, there will be some errors (tryctr > 1)
-      //   no errors (tryctr == 1)
-      // int last_bad_try_index = tryctr-2;
-      for (int ndx = 0; ndx < tryctr-1; ndx++) {
-         BASE_ERRINFO_FREE_WITH_REPORT(try_errors[ndx], IS_DBGTRC(debug, TRACE_GROUP) );
-      }
+   else if (tryctr > 1 && IS_DBGTRC(debug, TRACE_GROUP)) {
+      // succeeded after retries
+      char * s = errinfo_status_trail_summary(&try_errors);
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Succeeded after %d error(s): %s", try_errors.ct, s);
+      free(s);
    }
    try_data_record_tries2(dh, WRITE_ONLY_TRIES_OP, psc, tryctr);
 
@@ -1043,7 +1055,6 @@ init_ddc_packet_io_func_name_table() {
 // RTTI_ADD_FUNC(ddc_write_read_raw);
    RTTI_ADD_FUNC(ddc_write_read);
    RTTI_ADD_FUNC(ddc_write_read_with_retry);
-   RTTI_ADD_FUNC(ddc_write_only);
    RTTI_ADD_FUNC(ddc_write_only_with_retry);
    RTTI_ADD_FUNC(ddc_is_valid_display_handle);
 }
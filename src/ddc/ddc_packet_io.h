@@ -46,15 +46,11 @@ DDCA_Status ddc_validate_display_handle(Display_Handle * dh);
 
 void ddc_dbgrpt_valid_display_handles(int depth);
 
-Error_Info * ddc_write_only(
-      Display_Handle * dh,
-      DDC_Packet *     request_packet_ptr);
-
 Error_Info * ddc_write_only_with_retry(
       Display_Handle * dh,
       DDC_Packet *     request_packet_ptr);
 
-Error_Info * ddc_write_read(
+DDCA_Status ddc_write_read(
       Display_Handle * dh,
       DDC_Packet *     request_packet_ptr,
       bool             read_bytewise,
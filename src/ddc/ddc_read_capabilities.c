@@ -20,6 +20,8 @@
 
 #include "base/core.h"
 #include "base/ddc_errno.h"
+#include "base/execution_stats.h"
+#include "base/per_display_data.h"
 #include "base/rtti.h"
 #include "base/sleep.h"
 #include "base/status_code_mgt.h"
@@ -57,6 +59,7 @@ get_capabilities_into_buffer(
    bool debug = false;
    DBGTRC_STARTING(debug, TRACE_GROUP, "dh=%s", dh_repr(dh));
    Error_Info * ddc_excp = NULL;
+   bool optime_started = optime_start(OPTIME_CAPABILITIES);
 
    TUNED_SLEEP_WITH_TRACE(dh, SE_PRE_MULTI_PART_READ, "Before reading capabilities");
 
@@ -82,6 +85,7 @@ get_capabilities_into_buffer(
       buffer_set_byte(cap_buffer, len, '\0');
       buffer_set_length(cap_buffer, len+1);
    }
+   pdd_optime_end_by_dh(dh, optime_started);
 
    DBGTRC_RET_ERRINFO(debug, TRACE_GROUP, ddc_excp,
                        "*capabilities_buffer_loc=%p", *capabilities_buffer_loc);
@@ -1,6 +1,6 @@
 /** @file ddc_serialize.c */
 
-// Copyright (C) 2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2023-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <assert.h>
@@ -12,6 +12,8 @@
 
 #include "public/ddcutil_types.h"
 
+#include "util/data_structures.h"
+#include "util/edid.h"
 #include "util/file_util.h"
 #include "util/string_util.h"
 #include "util/xdg_util.h"
@@ -22,6 +24,9 @@
 #include "base/monitor_model_key.h"
 #include "base/rtti.h"
 
+#include "i2c/i2c_bus_core.h"
+#include "i2c/i2c_sysfs.h"
+
 #include "ddc/ddc_displays.h"
 
 #include "ddc_serialize.h"
@@ -32,27 +37,76 @@ static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_NONE;
 bool display_caching_enabled = false;
 
 GPtrArray* deserialized_displays = NULL;    // array of Display_Ref *
-GPtrArray* deserialized_buses    = NULL;    // array of Display_Ref *
+GPtrArray* deserialized_buses    = NULL;    // array of I2C_Bus_Info *
+static char * deserialized_fingerprint = NULL;  // fingerprint stored with the cache
+static char * detected_fingerprint     = NULL;  // fingerprint when buses were detected
+static Bit_Set_256 fingerprint_restored_buses = EMPTY_BIT_SET_256;  // buses restored from cache
+
+
+/** Reports whether the state of a bus is covered by the display configuration
+ *  fingerprint, i.e. whether it has a DRM connector that maps to the bus.
+ *  Buses without one, e.g. those of the proprietary nvidia driver, can have a
+ *  display connected or removed without the fingerprint changing.
+ *
+ *  @param  businfo  bus
+ *  @return true/false
+ */
+static bool
+bus_covered_by_fingerprint(I2C_Bus_Info * businfo) {
+   return businfo->drm_connector_name &&
+          businfo->drm_connector_found_by == DRM_CONNECTOR_FOUND_BY_BUSNO;
+}
+
+// Index of deserialized_displays by I2C bus number and EDID
+
+typedef struct {
+   int  busno;
+   Byte edidbytes[128];
+} Busno_Edid_Key;
+
+static Ptr_Array_Index * deserialized_displays_index = NULL;
+
+static guint busno_edid_hash(gconstpointer key) {
+   const Busno_Edid_Key * k = key;
+   return edid_bytes_hash(k->edidbytes) ^ (guint) k->busno;
+}
+
+static gboolean busno_edid_equal(gconstpointer a, gconstpointer b) {
+   const Busno_Edid_Key * ka = a;
+   const Busno_Edid_Key * kb = b;
+   return ka->busno == kb->busno && memcmp(ka->edidbytes, kb->edidbytes, 128) == 0;
+}
+
+static bool busno_edid_dref_key(gconstpointer element, gpointer * key_loc) {
+   const Display_Ref * dref = element;
+   if (dref->io_path.io_mode != DDCA_IO_I2C || !dref->pedid)
+      return false;
+   Busno_Edid_Key * key = g_new(Busno_Edid_Key, 1);
+   key->busno = dref->io_path.path.i2c_busno;
+   memcpy(key->edidbytes, dref->pedid->bytes, 128);
+   *key_loc = key;
+   return true;
+}
 
+static bool busno_edid_dref_match(gconstpointer element, gconstpointer key) {
+   const Display_Ref * dref = element;
+   const Busno_Edid_Key * k = key;
+   return dref->io_path.io_mode == DDCA_IO_I2C    &&
+          dref->io_path.path.i2c_busno == k->busno &&
+          dref->pedid                              &&
+          memcmp(dref->pedid->bytes, k->edidbytes, 128) == 0;
+}
 
-// #define CACHE_BUS_INFO   // not used
 
 Display_Ref * ddc_find_deserialized_display(int busno, Byte* edidbytes) {
    bool debug = false;
    DBGTRC_STARTING(debug, DDCA_TRC_DDCIO, "busno = %d", busno);
    Display_Ref * result = NULL;
    if (deserialized_displays) {
-      for (int ndx = 0; ndx < deserialized_displays->len; ndx++) {
-         Display_Ref * cur = g_ptr_array_index(deserialized_displays, ndx);
-         if (cur->io_path.io_mode == DDCA_IO_I2C    &&
-             cur->io_path.path.i2c_busno == busno   &&
-             cur->pedid                             &&
-             memcmp(cur->pedid->bytes, edidbytes, 128) == 0 )
-         {
-            result = cur;
-            break;
-         }
-      }
+      Busno_Edid_Key key;
+      key.busno = busno;
+      memcpy(key.edidbytes, edidbytes, 128);
+      result = pai_lookup(deserialized_displays_index, deserialized_displays, &key);
    }
    if (result)
       DBGTRC_RET_STRUCT(debug, DDCA_TRC_DDCIO, Display_Ref, dbgrpt_display_ref, result);
@@ -319,7 +373,6 @@ Display_Ref *  deserialize_one_display(json_t* disp_node) {
 }
 
 
-#ifdef CACHE_BUS_INFO
 json_t* serialize_one_i2c_bus(I2C_Bus_Info * businfo) {
    bool debug = false;
    DBGTRC_STARTING(debug, DDCA_TRC_NONE, "busno=%d, Before serialization:", businfo->busno);
@@ -330,7 +383,7 @@ json_t* serialize_one_i2c_bus(I2C_Bus_Info * businfo) {
    json_t * jbus = json_object();
 
    json_object_set_new(jbus, "busno", json_integer(businfo->busno));
-   json_object_set_new(jbus, "functionality", json_integer(businfo->busno));
+   json_object_set_new(jbus, "functionality", json_integer(businfo->functionality));
    if (businfo->edid) {
       jtmp = serialize_parsed_edid(businfo->edid);
       json_object_set_new(jbus, "edid", jtmp);
@@ -389,7 +442,6 @@ I2C_Bus_Info * deserialize_one_i2c_bus(json_t* jbus) {
    DBGTRC_RET_STRUCT(debug, DDCA_TRC_NONE, I2C_Bus_Info, i2c_dbgrpt_bus_info, businfo);
    return businfo;
 }
-#endif
 
 typedef enum {
    serialize_mode_display,
@@ -411,12 +463,33 @@ char * ddc_serialize_displays_and_buses() {
    json_t* root = json_object();
    json_object_set_new(root, "version", json_integer(1));
 
+   // Bus information is stored only if the configuration is unchanged since
+   // the buses were detected, otherwise it would be labeled with the wrong
+   // fingerprint.
+   char * fingerprint = NULL;
+   if (detected_fingerprint) {
+      fingerprint = ddc_displays_fingerprint();
+      if (!streq(fingerprint, detected_fingerprint)) {
+         SYSLOG2(DDCA_SYSLOG_NOTICE,
+               "Display configuration changed since detection, bus information not cached");
+         free(fingerprint);
+         fingerprint = NULL;
+      }
+   }
+
    GPtrArray* all_displays = ddc_get_all_display_refs();
    json_t* jdisplays = json_array();
 
    for (int ndx = 0; ndx < all_displays->len; ndx++) {
       Display_Ref * dref = g_ptr_array_index(all_displays, ndx);
-      if (dref->flags & DREF_DDC_COMMUNICATION_WORKING) {
+      // With a fingerprint, displays on which DDC does not work are cached as well,
+      // so that they need not be probed.  A busy display is a transient condition.
+      bool covered = fingerprint && dref->io_path.io_mode == DDCA_IO_I2C && dref->detail &&
+                     bus_covered_by_fingerprint(dref->detail);
+      bool cacheable = (covered)
+                          ? (dref->flags & DREF_DDC_COMMUNICATION_CHECKED) && !(dref->flags & DREF_DDC_BUSY)
+                          : (dref->flags & DREF_DDC_COMMUNICATION_WORKING);
+      if (cacheable) {
          json_t* node = serialize_one_display(dref);
          json_array_append(jdisplays, node);
          json_decref(node);
@@ -424,17 +497,22 @@ char * ddc_serialize_displays_and_buses() {
    }
    json_object_set_new(root, "all_displays", jdisplays);
 
-#ifdef CACHE_BUS_INFO
-   GPtrArray* all_buses = i2c_get_all_buses();
-   json_t* jbuses = json_array();
-
-   for (int ndx = 0; ndx < all_buses->len; ndx++) {
-      json_t* node = serialize_one_i2c_bus(g_ptr_array_index(all_buses, ndx));
-      json_array_append(jbuses, node);
-      json_decref(node);
+   if (fingerprint) {
+      json_object_set_new(root, "fingerprint", json_string(fingerprint));
+      GPtrArray* all_buses = all_i2c_buses;
+      json_t* jbuses = json_array();
+
+      for (int ndx = 0; ndx < all_buses->len; ndx++) {
+         I2C_Bus_Info * businfo = g_ptr_array_index(all_buses, ndx);
+         if (bus_covered_by_fingerprint(businfo)) {
+            json_t* node = serialize_one_i2c_bus(businfo);
+            json_array_append(jbuses, node);
+            json_decref(node);
+         }
+      }
+      json_object_set_new(root, "all_buses", jbuses);
+      free(fingerprint);
    }
-   json_object_set_new(root, "all_buses", jbuses);
-#endif
    char * result = json_dumps(root, JSON_INDENT(3));
 
    DBGTRC_RETURNING(debug, TRACE_GROUP, result, "");
@@ -449,10 +527,6 @@ GPtrArray * ddc_deserialize_displays_or_buses(const char * jstring, Serialize_Mo
    DBGTRC_NOPREFIX(debug, DDCA_TRC_DDCIO, "%s", jstring);
    GPtrArray * restored = g_ptr_array_new();
 
-#ifndef CACHE_BUS_INFO
-   assert(mode == serialize_mode_display);
-#endif
-
    json_error_t error;
 
    bool ok = true;
@@ -484,10 +558,8 @@ GPtrArray * ddc_deserialize_displays_or_buses(const char * jstring, Serialize_Mo
    assert(version == 1);
 
    char * all = "all_displays";
-#ifdef CACHE_BUS_INFO
    if (mode == serialize_mode_bus)
       all = "all_buses";
-#endif
 
    json_t* disp_nodes = json_object_get(root, all);
    if (!(disp_nodes && json_is_array(disp_nodes))) {
@@ -512,19 +584,18 @@ GPtrArray * ddc_deserialize_displays_or_buses(const char * jstring, Serialize_Mo
          goto bye;
       }
 
-#ifdef CACHE_BUS_INFO
       if (mode == serialize_mode_display) {
          Display_Ref * dref = deserialize_one_display(one_display_or_bus);
          g_ptr_array_add(restored, dref);
       }
       else {
          I2C_Bus_Info * businfo = deserialize_one_i2c_bus(one_display_or_bus);
+         if (!businfo) {
+            ok = false;
+            goto bye;
+         }
          g_ptr_array_add(restored, businfo);
       }
-#else
-      Display_Ref * dref = deserialize_one_display(one_display_or_bus);
-      g_ptr_array_add(restored, dref);
-#endif
    }
 
 bye:
@@ -567,7 +638,8 @@ bool ddc_store_displays_cache() {
    bool debug = false;
    DBGTRC_STARTING(debug, DDCA_TRC_DDCIO, "Starting");
    bool ok = false;
-   if (ddc_displays_already_detected()) {
+   // a partially detected display list must not be cached
+   if (ddc_displays_already_detected() && !ddc_displays_partially_detected()) {
       char * json_text = ddc_serialize_displays_and_buses();
       char * fn = ddc_displays_cache_file_name();
       if (!fn) {
@@ -601,6 +673,21 @@ bool ddc_store_displays_cache() {
 }
 
 
+static char * deserialize_fingerprint(const char * jstring) {
+   char * result = NULL;
+   json_error_t error;
+   json_t* root = json_loads(jstring, 0, &error);
+   if (root && json_is_object(root)) {
+      json_t* jtmp = json_object_get(root, "fingerprint");
+      if (jtmp && json_is_string(jtmp))
+         result = g_strdup(json_string_value(jtmp));
+   }
+   if (root)
+      json_decref(root);
+   return result;
+}
+
+
 void ddc_restore_displays_cache() {
    bool debug = false;
    DBGTRC_STARTING(debug, DDCA_TRC_DDCIO, "");
@@ -610,32 +697,181 @@ void ddc_restore_displays_cache() {
       char * buf = read_file_single_string(fn, debug);
       // DBGMSF(debug, "buf: |%s|", buf);
       deserialized_displays = ddc_deserialize_displays_or_buses(buf, serialize_mode_display);
-#ifdef CACHE_BUS_INFO
-      deserialized_buses    = ddc_deserialize_displays_or_buses(buf, serialize_mode_bus);
-#endif
+      // bus information is only present in caches written with a fingerprint
+      deserialized_fingerprint = deserialize_fingerprint(buf);
+      if (deserialized_fingerprint)
+         deserialized_buses = ddc_deserialize_displays_or_buses(buf, serialize_mode_bus);
+      else
+         deserialized_buses = g_ptr_array_new();
       free(buf);
    }
    else {
       DBGMSF(debug, "File not found: %s", fn);
-#ifdef CACHE_BUS_INFO
       deserialized_buses    =  g_ptr_array_new();
-#endif
       deserialized_displays =  g_ptr_array_new();
    }
    free(fn);
-#ifdef CACHE_BUS_INFO
-   DBGTRC_DONE(debug, DDCA_TRC_DDCIO, "Restored %d Display_Ref records, %d I2C_Bus_Info records",
-         deserialized_displays->len, deserialized_buses->len);
-#else
-   DBGTRC_DONE(debug, DDCA_TRC_DDCIO, "Restored %d Display_Ref records",
-         deserialized_displays->len);
+   DBGTRC_DONE(debug, DDCA_TRC_DDCIO, "Restored %d Display_Ref records, %d I2C_Bus_Info records, fingerprint=%s",
+         deserialized_displays->len, deserialized_buses->len, deserialized_fingerprint);
    if ( IS_DBGTRC(debug, DDCA_TRC_DDCIO)) {
       for (int ndx = 0; ndx < deserialized_displays->len; ndx++) {
          Display_Ref * dref = g_ptr_array_index(deserialized_displays, ndx);
          DBGMSG(" Display_Ref: %s", dref_repr_t(dref));
       }
    }
-#endif
+}
+
+
+static gint
+compare_connector_names(gconstpointer a, gconstpointer b) {
+   const Sys_Drm_Connector * ca = *(Sys_Drm_Connector **) a;
+   const Sys_Drm_Connector * cb = *(Sys_Drm_Connector **) b;
+   return g_strcmp0(ca->connector_name, cb->connector_name);
+}
+
+
+/** Computes a fingerprint of the display configuration using only
+ *  information in /dev and /sys.  No I2C device is opened.
+ *
+ *  The fingerprint covers:
+ *  - the /dev/i2c buses and the driver for each
+ *  - the DRM connectors, their status, the I2C buses they map to,
+ *    and their EDIDs
+ *
+ *  @return SHA-256 hex string, caller must free
+ */
+char * ddc_displays_fingerprint() {
+   bool debug = false;
+   DBGTRC_STARTING(debug, DDCA_TRC_DDCIO, "");
+
+   GChecksum * checksum = g_checksum_new(G_CHECKSUM_SHA256);
+   char buf[200];
+
+   Bit_Set_256 buses = i2c_detect_attached_buses_as_bitset();
+   Bit_Set_256_Iterator iter = bs256_iter_new(buses);
+   int busno;
+   while ( (busno = bs256_iter_next(iter)) >= 0) {
+      char * driver = get_driver_for_busno(busno);
+      g_snprintf(buf, sizeof(buf), "i2c-%d:%s;", busno, (driver) ? driver : "");
+      g_checksum_update(checksum, (guchar*) buf, -1);
+      free(driver);
+   }
+   bs256_iter_free(iter);
+
+   GPtrArray * connectors = get_sys_drm_connectors(false);
+   if (connectors) {
+      GPtrArray * sorted = g_ptr_array_sized_new(connectors->len);
+      for (int ndx = 0; ndx < connectors->len; ndx++)
+         g_ptr_array_add(sorted, g_ptr_array_index(connectors, ndx));
+      g_ptr_array_sort(sorted, compare_connector_names);
+      for (int ndx = 0; ndx < sorted->len; ndx++) {
+         Sys_Drm_Connector * conn = g_ptr_array_index(sorted, ndx);
+         g_snprintf(buf, sizeof(buf), "%s:%d:%d:%s:", conn->connector_name,
+               conn->i2c_busno, conn->base_busno, (conn->status) ? conn->status : "");
+         g_checksum_update(checksum, (guchar*) buf, -1);
+         if (conn->edid_bytes && conn->edid_size > 0)
+            g_checksum_update(checksum, conn->edid_bytes, conn->edid_size);
+         g_checksum_update(checksum, (guchar*) ";", 1);
+      }
+      g_ptr_array_free(sorted, true);
+   }
+
+   char * result = g_strdup(g_checksum_get_string(checksum));
+   g_checksum_free(checksum);
+
+   DBGTRC_DONE(debug, DDCA_TRC_DDCIO, "Returning: %s", result);
+   return result;
+}
+
+
+static gint
+compare_businfo_busno(gconstpointer a, gconstpointer b) {
+   const I2C_Bus_Info * ba = *(I2C_Bus_Info **) a;
+   const I2C_Bus_Info * bb = *(I2C_Bus_Info **) b;
+   return ba->busno - bb->busno;
+}
+
+
+/** If the current display configuration fingerprint matches the one stored
+ *  with the displays cache, installs the cached I2C bus information as
+ *  #all_i2c_buses, so that buses need not be probed.
+ *
+ *  Only buses covered by the fingerprint are cached.  The remaining
+ *  attached buses are probed.
+ *
+ *  The current fingerprint is retained, to be stored with the cache.
+ *  Cached bus information is consumed, so it is used at most once.
+ *
+ *  @return true if bus information was restored, false if not
+ */
+bool ddc_restore_buses_by_fingerprint() {
+   bool debug = false;
+   DBGTRC_STARTING(debug, DDCA_TRC_DDCIO, "");
+
+   free(detected_fingerprint);
+   detected_fingerprint = ddc_displays_fingerprint();
+   fingerprint_restored_buses = EMPTY_BIT_SET_256;
+   bool restored = false;
+   if (!all_i2c_buses &&
+       deserialized_fingerprint && deserialized_buses && deserialized_buses->len > 0 &&
+       streq(deserialized_fingerprint, detected_fingerprint))
+   {
+      GPtrArray * buses = deserialized_buses;
+      deserialized_buses = NULL;
+      g_ptr_array_set_free_func(buses, (GDestroyNotify) i2c_free_bus_info);
+      for (int ndx = 0; ndx < buses->len; ndx++) {
+         I2C_Bus_Info * businfo = g_ptr_array_index(buses, ndx);
+         fingerprint_restored_buses = bs256_insert(fingerprint_restored_buses, businfo->busno);
+      }
+      Bit_Set_256 probed_buses =
+            bs256_and_not(i2c_detect_attached_buses_as_bitset(), fingerprint_restored_buses);
+      Bit_Set_256_Iterator iter = bs256_iter_new(probed_buses);
+      int busno;
+      while ( (busno = bs256_iter_next(iter)) >= 0) {
+         DBGTRC_NOPREFIX(debug, DDCA_TRC_DDCIO, "bus %d not covered by fingerprint, probing", busno);
+         I2C_Bus_Info * businfo = i2c_new_bus_info(busno);
+         businfo->flags = I2C_BUS_EXISTS | I2C_BUS_VALID_NAME_CHECKED | I2C_BUS_HAS_VALID_NAME;
+         i2c_check_bus(businfo);
+         g_ptr_array_add(buses, businfo);
+      }
+      bs256_iter_free(iter);
+      g_ptr_array_sort(buses, compare_businfo_busno);
+      all_i2c_buses = buses;
+      restored = true;
+   }
+   else if (deserialized_fingerprint && !streq(deserialized_fingerprint, detected_fingerprint)) {
+      // configuration changed, the cached bus information is of no further use
+      SYSLOG2(DDCA_SYSLOG_NOTICE, "Display configuration changed since displays cache was written");
+      free(deserialized_fingerprint);
+      deserialized_fingerprint = NULL;
+   }
+
+   DBGTRC_RET_BOOL(debug, DDCA_TRC_DDCIO, restored, "");
+   return restored;
+}
+
+
+/** Reports whether the information for a bus was restored from the displays
+ *  cache by #ddc_restore_buses_by_fingerprint(), as opposed to being probed.
+ *
+ *  @param  busno  I2C bus number
+ *  @return true/false
+ */
+bool ddc_bus_restored_by_fingerprint(int busno) {
+   return bs256_contains(fingerprint_restored_buses, busno);
+}
+
+
+/** Recomputes the display configuration fingerprint to be stored with the
+ *  displays cache, after the bus information has been brought up to date
+ *  without a full detection, e.g. by incremental redetection.
+ */
+void ddc_update_displays_fingerprint() {
+   bool debug = false;
+   DBGTRC_STARTING(debug, DDCA_TRC_DDCIO, "");
+   free(detected_fingerprint);
+   detected_fingerprint = ddc_displays_fingerprint();
+   DBGTRC_DONE(debug, DDCA_TRC_DDCIO, "detected_fingerprint=%s", detected_fingerprint);
 }
 
 
@@ -671,6 +907,12 @@ void init_ddc_serialize() {
    RTTI_ADD_FUNC(deserialize_parsed_edid);
    RTTI_ADD_FUNC(serialize_one_display);
    RTTI_ADD_FUNC(ddc_find_deserialized_display);
+   RTTI_ADD_FUNC(ddc_displays_fingerprint);
+   RTTI_ADD_FUNC(ddc_restore_buses_by_fingerprint);
+   RTTI_ADD_FUNC(ddc_update_displays_fingerprint);
+
+   deserialized_displays_index = pai_new(busno_edid_hash, busno_edid_equal, g_free,
+                                         busno_edid_dref_key, busno_edid_dref_match);
 }
 
 
@@ -687,5 +929,12 @@ void terminate_ddc_serialize() {
       g_ptr_array_free(deserialized_displays, true);
       deserialized_displays = NULL;
    }
+   free(deserialized_fingerprint);
+   deserialized_fingerprint = NULL;
+   free(detected_fingerprint);
+   detected_fingerprint = NULL;
+   fingerprint_restored_buses = EMPTY_BIT_SET_256;
+   pai_free(deserialized_displays_index);
+   deserialized_displays_index = NULL;
    DBGMSF(debug, "Done");
 }
@@ -18,6 +18,10 @@ bool          ddc_store_displays_cache();
 void          ddc_restore_displays_cache();
 void          ddc_erase_displays_cache();
 Display_Ref * ddc_find_deserialized_display(int busno, Byte* edidbytes);
+char *        ddc_displays_fingerprint();
+bool          ddc_restore_buses_by_fingerprint();
+bool          ddc_bus_restored_by_fingerprint(int busno);
+void          ddc_update_displays_fingerprint();
 void          init_ddc_serialize();
 void          terminate_ddc_serialize();
 
@@ -11,13 +11,16 @@
 /** \cond */
 #include <stdio.h>
 
+#include "util/edid.h"
 #include "util/report_util.h"
 /** \endcond */
 
 #include "base/base_services.h"
+#include "base/ddc_packets.h"
 #include "base/display_retry_data.h"
 #include "base/dsa2.h"
 #include "base/feature_metadata.h"
+#include "base/lock_stats.h"
 #include "base/parms.h"
 #include "base/per_thread_data.h"
 #include "base/rtti.h"
@@ -31,7 +34,9 @@
 #include "dynvcp/dyn_feature_codes.h"
 #include "dynvcp/dyn_feature_files.h"
 
+#include "i2c/i2c_bus_core.h"
 #include "i2c/i2c_services.h"
+#include "i2c/i2c_sysfs.h"
 
 #ifdef ENABLE_USB
 #include "usb/usb_services.h"
@@ -72,6 +77,10 @@ void ddc_reset_stats_main() {
    // ddc_reset_ddc_stats();
    try_data_reset2_all();
    reset_execution_stats();
+   reset_lock_stats();
+   i2c_reset_handle_pool_stats();
+   i2c_reset_edid_read_stats();
+   reset_ddc_packet_alloc_stats();
    ptd_profile_reset_all_stats();
 }
 
@@ -125,6 +134,20 @@ void ddc_report_stats_main(DDCA_Stats_Type  stats,
 
       report_io_call_stats(depth);
       rpt_nl();
+      if (i2c_handle_pool_enabled) {
+         i2c_report_handle_pool_stats(depth);
+         rpt_nl();
+      }
+      report_ddc_packet_alloc_stats(depth);
+      rpt_nl();
+      ddc_report_display_event_stats(depth);
+      rpt_nl();
+      report_drm_connector_cache_stats(depth);
+      rpt_nl();
+      report_parsed_edid_cache_stats(depth);
+      rpt_nl();
+      i2c_report_edid_read_stats(depth);
+      rpt_nl();
       report_sleep_stats(depth);
       rpt_nl();
       report_elapsed_stats(depth);
@@ -136,6 +159,11 @@ void ddc_report_stats_main(DDCA_Stats_Type  stats,
       rpt_nl();
    }
 
+   if (stats & DDCA_STATS_LOCKS) {
+      report_lock_stats(depth);
+      rpt_nl();
+   }
+
    if (show_per_display_stats) {
       rpt_label(depth, "PER-DISPLAY EXECUTION STATISTICS");
       rpt_nl();
@@ -235,7 +263,9 @@ void init_ddc_services() {
 void terminate_ddc_services() {
    bool debug = false;
    DBGTRC_STARTING(debug, DDCA_TRC_DDCIO, "");
+   terminate_ddc_status_events();  // delivers queued events, which may reference display refs
    terminate_ddc_serialize();
+   terminate_ddc_display_selection();
    terminate_ddc_displays();  // must be called before terminate_ddc_packet_io()
    terminate_ddc_packet_io();
    terminate_i2c_display_lock();
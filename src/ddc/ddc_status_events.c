@@ -1,9 +1,29 @@
-/** @file ddc_status_events.c */
+/** @file ddc_status_events.c
+ *
+ *  Display status events are delivered to clients by a dedicated dispatcher
+ *  thread, so that a slow client callback does not delay the watch thread.
+ *  Events are passed to the dispatcher through a bounded lock-free queue
+ *  that supports multiple producers and a single consumer.  If the queue is
+ *  full, the event is dropped and counted.
+ *
+ *  Besides callbacks, clients can receive events as records read from a
+ *  file descriptor.
+ */
 
 // Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+/** \cond */
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <glib-2.0/glib.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+/** \endcond */
 
 #include "public/ddcutil_types.h"
 #include "public/ddcutil_c_api.h"
@@ -11,11 +31,16 @@
 
 #include "config.h"
 
+#include "util/report_util.h"
+#include "util/string_util.h"
+#include "util/sysfs_util.h"
 #include "util/timestamp.h"
 
 #include "base/core.h"
+#include "base/parms.h"
 #include "base/rtti.h"
 
+#include "i2c/i2c_bus_core.h"
 #include "i2c/i2c_sysfs.h"
 
 #include "ddc_status_events.h"
@@ -28,7 +53,11 @@ static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_NONE;
 // Display Status Events
 //
 
-GPtrArray* display_detection_callbacks = NULL;
+GPtrArray*    display_detection_callbacks = NULL;
+static GMutex display_detection_callbacks_mutex;
+
+bool ddc_coalesce_display_events = DEFAULT_COALESCE_DISPLAY_EVENTS;
+int  ddc_double_tap_millisec     = DEFAULT_DOUBLE_TAP_MILLISEC;
 
 /** Registers a display status change event callback
  *
@@ -46,10 +75,11 @@ DDCA_Status ddc_register_display_status_callback(DDCA_Display_Status_Callback_Fu
 
    DDCA_Status result = DDCRC_INVALID_OPERATION;
 #ifdef ENABLE_UDEV
-   if (i2c_all_video_devices_drm() &&
-       generic_register_callback(&display_detection_callbacks, func) )
-   {
-      result = DDCRC_OK;
+   if (i2c_all_video_devices_drm()) {
+      g_mutex_lock(&display_detection_callbacks_mutex);
+      if (generic_register_callback(&display_detection_callbacks, func))
+         result = DDCRC_OK;
+      g_mutex_unlock(&display_detection_callbacks_mutex);
    }
 #endif
 
@@ -73,7 +103,11 @@ DDCA_Status ddc_unregister_display_status_callback(DDCA_Display_Status_Callback_
    DDCA_Status result = DDCRC_INVALID_OPERATION;
 #ifdef ENABLE_UDEV
    if (i2c_all_video_devices_drm() ) {
-       result = generic_register_callback(&display_detection_callbacks, func);
+      g_mutex_lock(&display_detection_callbacks_mutex);
+      bool found = display_detection_callbacks &&
+                   generic_unregister_callback(display_detection_callbacks, func);
+      g_mutex_unlock(&display_detection_callbacks_mutex);
+      result = (found) ? DDCRC_OK : DDCRC_NOT_FOUND;
    }
 #endif
 
@@ -82,6 +116,91 @@ DDCA_Status ddc_unregister_display_status_callback(DDCA_Display_Status_Callback_
 }
 
 
+//
+// Display Ready Events
+//
+
+static GPtrArray* display_ready_callbacks = NULL;
+static GMutex     display_ready_callbacks_mutex;
+
+/** Registers a function to be called as each display's initial checks
+ *  complete during detection.
+ *
+ *  @param  func      function of type DDCA_Display_Ready_Callback_Func
+ *  @retval DDCRC_OK
+ *
+ *  It is not an error if the function is already registered.
+ */
+DDCA_Status ddc_register_display_ready_callback(DDCA_Display_Ready_Callback_Func func) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "func=%p", func);
+
+   g_mutex_lock(&display_ready_callbacks_mutex);
+   generic_register_callback(&display_ready_callbacks, func);
+   g_mutex_unlock(&display_ready_callbacks_mutex);
+   DDCA_Status result = DDCRC_OK;
+
+   DBGTRC_RET_DDCRC(debug, TRACE_GROUP, result, "");
+   return result;
+}
+
+
+/** Unregisters a display ready callback function
+ *
+ *  @param  func      function of type DDCA_Display_Ready_Callback_Func
+ *  @retval DDCRC_OK normal return
+ *  @retval DDCRC_NOT_FOUND function not in list of registered functions
+ */
+DDCA_Status ddc_unregister_display_ready_callback(DDCA_Display_Ready_Callback_Func func) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "func=%p", func);
+
+   g_mutex_lock(&display_ready_callbacks_mutex);
+   bool found = display_ready_callbacks &&
+                generic_unregister_callback(display_ready_callbacks, func);
+   g_mutex_unlock(&display_ready_callbacks_mutex);
+   DDCA_Status result = (found) ? DDCRC_OK : DDCRC_NOT_FOUND;
+
+   DBGTRC_RET_DDCRC(debug, TRACE_GROUP, result, "");
+   return result;
+}
+
+
+/** Reports a display whose initial checks have completed to the
+ *  registered display ready callbacks.  Called in the thread performing
+ *  detection.
+ *
+ *  @param  dref  display reference
+ */
+void ddc_emit_display_ready(Display_Ref * dref) {
+   bool debug = false;
+   bool ddc_working = dref->flags & DREF_DDC_COMMUNICATION_WORKING;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dref=%s, ddc_working=%s", dref_repr_t(dref), sbool(ddc_working));
+
+   GPtrArray * funcs = NULL;
+   g_mutex_lock(&display_ready_callbacks_mutex);
+   if (display_ready_callbacks && display_ready_callbacks->len > 0) {
+      funcs = g_ptr_array_sized_new(display_ready_callbacks->len);
+      for (int ndx = 0; ndx < display_ready_callbacks->len; ndx++)
+         g_ptr_array_add(funcs, g_ptr_array_index(display_ready_callbacks, ndx));
+   }
+   g_mutex_unlock(&display_ready_callbacks_mutex);
+
+   // callbacks are invoked without holding the mutex, they may (un)register
+   int ct = 0;
+   if (funcs) {
+      ct = funcs->len;
+      for (int ndx = 0; ndx < funcs->len; ndx++) {
+         DDCA_Display_Ready_Callback_Func func = g_ptr_array_index(funcs, ndx);
+         func((DDCA_Display_Ref) dref, ddc_working);
+      }
+      g_ptr_array_free(funcs, true);
+   }
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "Executed %d callbacks", ct);
+}
+
+
 const char * ddc_display_event_class_name(DDCA_Display_Event_Class class) {
    char * result = NULL;
    switch(class) {
@@ -153,28 +272,471 @@ ddc_create_display_status_event(
 }
 
 
-/** Performs the actual work of executing the registered callbacks.
+//
+// Event delivery by file descriptor
+//
+
+static GArray * status_event_fds = NULL;     // library ends of socket pairs
+static GMutex   status_event_fds_mutex;
+
+
+/** Creates a file descriptor from which the client reads display status
+ *  events.
+ *
+ *  Each read returns one #DDCA_Display_Status_Event.  The client stops
+ *  receiving events by closing the descriptor.
+ *
+ *  @param  fd_loc  where to return file descriptor
+ *  @retval DDCRC_OK
+ *  @retval DDCRC_INVALID_OPERATION ddcutil not built with UDEV support,
+ *                                  or not all video devices support DRM
+ *  @retval -errno  unable to create socket
+ */
+DDCA_Status ddc_open_display_status_fd(int * fd_loc) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "");
+   *fd_loc = -1;
+
+   DDCA_Status result = DDCRC_INVALID_OPERATION;
+#ifdef ENABLE_UDEV
+   if (i2c_all_video_devices_drm()) {
+      // SOCK_SEQPACKET preserves record boundaries
+      int sv[2];
+      if (socketpair(AF_UNIX, SOCK_SEQPACKET|SOCK_CLOEXEC, 0, sv) < 0) {
+         result = -errno;
+      }
+      else {
+         // the dispatcher must never block on a client that is not reading
+         fcntl(sv[0], F_SETFL, fcntl(sv[0], F_GETFL, 0) | O_NONBLOCK);
+         shutdown(sv[1], SHUT_WR);
+         g_mutex_lock(&status_event_fds_mutex);
+         if (!status_event_fds)
+            status_event_fds = g_array_new(false, false, sizeof(int));
+         g_array_append_val(status_event_fds, sv[0]);
+         g_mutex_unlock(&status_event_fds_mutex);
+         *fd_loc = sv[1];
+         result = DDCRC_OK;
+      }
+   }
+#endif
+
+   DBGTRC_RET_DDCRC(debug, TRACE_GROUP, result, "*fd_loc=%d", *fd_loc);
+   return result;
+}
+
+
+//
+// Dispatcher
+//
+
+// EDID of the display that a connect or disconnect event refers to, captured
+// when the event is queued, while the display ref is known to be valid
+typedef struct {
+   bool  valid;
+   Byte  bytes[128];
+} Event_Edid;
+
+typedef struct {
+   uint64_t                   seqno;    // Vyukov bounded queue sequence number
+   DDCA_Display_Status_Event  evt;
+   Event_Edid                 edid;
+} Event_Queue_Slot;
+
+#define EVENT_QUEUE_MASK (DISPLAY_EVENT_QUEUE_SIZE-1)
+
+static Event_Queue_Slot event_queue[DISPLAY_EVENT_QUEUE_SIZE];
+static uint64_t         event_queue_tail = 0;  // next position to fill, shared by producers
+static uint64_t         event_queue_head = 0;  // next position to take, dispatcher only
+
+// dispatcher_thread, dispatcher_wake_fd and the flush counters are
+// guarded by dispatcher_mutex
+static GThread *  dispatcher_thread = NULL;
+static int        dispatcher_wake_fd = -1;     // eventfd
+static bool       dispatcher_terminate = false;
+static GMutex     dispatcher_mutex;
+static GCond      dispatcher_flushed_cond;
+static uint64_t   flush_requests = 0;          // number of flushes requested
+static uint64_t   flushes_done   = 0;          // number of flushes completed
+
+typedef struct {
+   int queued;
+   int dispatched;
+   int coalesced;
+   int queue_overflows;    // events dropped because the queue was full
+   int fd_overflows;       // records not written because a client fd was full
+} Display_Event_Stats;
+
+static Display_Event_Stats event_stats;
+
+#define INCR_STAT(_field) __atomic_add_fetch(&event_stats._field, 1, __ATOMIC_RELAXED)
+
+
+static bool
+event_queue_push(DDCA_Display_Status_Event * evt, Event_Edid * edid) {
+   uint64_t pos = __atomic_load_n(&event_queue_tail, __ATOMIC_RELAXED);
+   Event_Queue_Slot * slot;
+   while (true) {
+      slot = &event_queue[pos & EVENT_QUEUE_MASK];
+      uint64_t seqno = __atomic_load_n(&slot->seqno, __ATOMIC_ACQUIRE);
+      int64_t diff = (int64_t) seqno - (int64_t) pos;
+      if (diff == 0) {
+         if (__atomic_compare_exchange_n(&event_queue_tail, &pos, pos+1, true,
+                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            break;
+      }
+      else if (diff < 0) {
+         return false;    // full
+      }
+      else {
+         pos = __atomic_load_n(&event_queue_tail, __ATOMIC_RELAXED);
+      }
+   }
+   slot->evt = *evt;
+   slot->edid = *edid;
+   __atomic_store_n(&slot->seqno, pos+1, __ATOMIC_RELEASE);
+   return true;
+}
+
+
+static bool
+event_queue_pop(DDCA_Display_Status_Event * evt, Event_Edid * edid) {
+   Event_Queue_Slot * slot = &event_queue[event_queue_head & EVENT_QUEUE_MASK];
+   uint64_t seqno = __atomic_load_n(&slot->seqno, __ATOMIC_ACQUIRE);
+   if (seqno != event_queue_head+1)
+      return false;   // empty
+   *evt = slot->evt;
+   *edid = slot->edid;
+   __atomic_store_n(&slot->seqno, event_queue_head + DISPLAY_EVENT_QUEUE_SIZE, __ATOMIC_RELEASE);
+   event_queue_head++;
+   return true;
+}
+
+
+/** Performs the actual work of executing the registered callbacks
+ *  and writing the event to client file descriptors.
  *
  *  @param  evt
  */
-void ddc_emit_display_status_record(
-      DDCA_Display_Status_Event  evt)
-{
+STATIC void
+dispatch_display_status_event(DDCA_Display_Status_Event  evt) {
    bool debug = false;
    DBGTRC_STARTING(debug, TRACE_GROUP, "evt=%s", display_status_event_repr_t(evt));
    SYSLOG2(DDCA_SYSLOG_NOTICE, "Emitting %s",  display_status_event_repr_t(evt));
 
-   if (display_detection_callbacks) {
-      for (int ndx = 0; ndx < display_detection_callbacks->len; ndx++)  {
-         DDCA_Display_Status_Callback_Func func = g_ptr_array_index(display_detection_callbacks, ndx);
+   GPtrArray * funcs = NULL;
+   g_mutex_lock(&display_detection_callbacks_mutex);
+   if (display_detection_callbacks && display_detection_callbacks->len > 0) {
+      funcs = g_ptr_array_sized_new(display_detection_callbacks->len);
+      for (int ndx = 0; ndx < display_detection_callbacks->len; ndx++)
+         g_ptr_array_add(funcs, g_ptr_array_index(display_detection_callbacks, ndx));
+   }
+   g_mutex_unlock(&display_detection_callbacks_mutex);
+
+   int ct = 0;
+   if (funcs) {
+      ct = funcs->len;
+      for (int ndx = 0; ndx < funcs->len; ndx++)  {
+         DDCA_Display_Status_Callback_Func func = g_ptr_array_index(funcs, ndx);
          func(evt);
       }
+      g_ptr_array_free(funcs, true);
    }
 
-   SYSLOG2(DDCA_SYSLOG_NOTICE, "Executed %d registered callbacks.",
-         (display_detection_callbacks) ? display_detection_callbacks->len : 0);
-   DBGTRC_DONE(debug, TRACE_GROUP, "Executed %d callbacks",
-         (display_detection_callbacks) ? display_detection_callbacks->len : 0);
+   g_mutex_lock(&status_event_fds_mutex);
+   if (status_event_fds) {
+      int ndx = 0;
+      while (ndx < status_event_fds->len) {
+         int fd = g_array_index(status_event_fds, int, ndx);
+         ssize_t rc = send(fd, &evt, sizeof(evt), MSG_DONTWAIT|MSG_NOSIGNAL);
+         if (rc < 0 && (errno == EPIPE || errno == ECONNRESET)) {
+            DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Client closed fd, closing %d", fd);
+            close(fd);
+            g_array_remove_index(status_event_fds, ndx);
+            continue;
+         }
+         if (rc < 0)
+            INCR_STAT(fd_overflows);
+         ndx++;
+      }
+   }
+   g_mutex_unlock(&status_event_fds_mutex);
+   INCR_STAT(dispatched);
+
+   SYSLOG2(DDCA_SYSLOG_NOTICE, "Executed %d registered callbacks.", ct);
+   DBGTRC_DONE(debug, TRACE_GROUP, "Executed %d callbacks", ct);
+}
+
+
+typedef struct {
+   DDCA_Display_Status_Event evt;
+   Event_Edid                edid;
+   uint64_t                  deadline_nanos;
+} Held_Event;
+
+
+/** Handles an event taken from the queue.  If coalescing is enabled, a
+ *  disconnect event is held for #ddc_double_tap_millisec.  If the same
+ *  display is reconnected to the connector during that time, i.e. the
+ *  connect event has the same EDID and does not name a different display
+ *  ref, only the connect event is dispatched.  Otherwise the held disconnect
+ *  event is dispatched, followed by the connect event.
+ *
+ *  @param  evt   event
+ *  @param  edid  EDID of the display the event refers to
+ *  @param  held  array of #Held_Event
+ */
+static void
+process_queued_event(DDCA_Display_Status_Event evt, Event_Edid edid, GArray * held) {
+   if (!ddc_coalesce_display_events) {
+      dispatch_display_status_event(evt);
+      return;
+   }
+
+   int held_ndx = -1;
+   for (int ndx = 0; ndx < held->len; ndx++) {
+      Held_Event * cur = &g_array_index(held, Held_Event, ndx);
+      if (streq(cur->evt.connector_name, evt.connector_name)) {
+         held_ndx = ndx;
+         break;
+      }
+   }
+
+   if (evt.event_type == DDCA_EVENT_DISPLAY_DISCONNECTED) {
+      if (held_ndx >= 0) {     // repeated disconnect
+         INCR_STAT(coalesced);
+         return;
+      }
+      Held_Event he = {evt, edid, elapsed_time_nanosec() + ddc_double_tap_millisec * (uint64_t)(1000*1000)};
+      g_array_append_val(held, he);
+   }
+   else if (evt.event_type == DDCA_EVENT_DISPLAY_CONNECTED && held_ndx >= 0) {
+      Held_Event he = g_array_index(held, Held_Event, held_ndx);
+      g_array_remove_index(held, held_ndx);
+      bool same_display = he.edid.valid && edid.valid &&
+                          memcmp(he.edid.bytes, edid.bytes, 128) == 0 &&
+                          (!evt.dref || evt.dref == he.evt.dref);
+      if (same_display) {
+         SYSLOG2(DDCA_SYSLOG_NOTICE, "Coalesced disconnect and connect of %s", evt.connector_name);
+         INCR_STAT(coalesced);
+      }
+      else {
+         dispatch_display_status_event(he.evt);
+      }
+      dispatch_display_status_event(evt);
+   }
+   else {
+      dispatch_display_status_event(evt);
+   }
+}
+
+
+/** Dispatches held events whose coalescing window has passed.
+ *
+ *  @param  held  array of #Held_Event
+ *  @param  all   if true, dispatch all held events
+ *  @return milliseconds until the next held event expires, -1 if none
+ */
+static int
+dispatch_expired_events(GArray * held, bool all) {
+   uint64_t now = elapsed_time_nanosec();
+   int timeout_millisec = -1;
+   int ndx = 0;
+   while (ndx < held->len) {
+      Held_Event * cur = &g_array_index(held, Held_Event, ndx);
+      if (all || cur->deadline_nanos <= now) {
+         DDCA_Display_Status_Event evt = cur->evt;
+         g_array_remove_index(held, ndx);
+         dispatch_display_status_event(evt);
+         continue;
+      }
+      int remaining = (cur->deadline_nanos - now + 999999) / (1000*1000);
+      if (timeout_millisec < 0 || remaining < timeout_millisec)
+         timeout_millisec = remaining;
+      ndx++;
+   }
+   return timeout_millisec;
+}
+
+
+static gpointer
+display_event_dispatcher_func(gpointer data) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "");
+   GArray * held = g_array_new(false, false, sizeof(Held_Event));
+   // the descriptor is not closed until this thread has been joined
+   int wake_fd = GPOINTER_TO_INT(data);
+
+   int timeout_millisec = -1;
+   while (true) {
+      struct pollfd pfd = {.fd = wake_fd, .events = POLLIN};
+      int rc = poll(&pfd, 1, timeout_millisec);
+      if (rc > 0) {
+         eventfd_t ct;
+         eventfd_read(wake_fd, &ct);
+      }
+      bool terminate = __atomic_load_n(&dispatcher_terminate, __ATOMIC_ACQUIRE);
+      // read before the queue is drained, so that all events queued
+      // before the flush was requested are dispatched
+      g_mutex_lock(&dispatcher_mutex);
+      uint64_t requested = flush_requests;
+      g_mutex_unlock(&dispatcher_mutex);
+
+      DDCA_Display_Status_Event evt;
+      Event_Edid edid;
+      while (event_queue_pop(&evt, &edid))
+         process_queued_event(evt, edid, held);
+      timeout_millisec = dispatch_expired_events(held, terminate || requested > flushes_done);
+
+      g_mutex_lock(&dispatcher_mutex);
+      if (requested > flushes_done) {
+         flushes_done = requested;
+         g_cond_broadcast(&dispatcher_flushed_cond);
+      }
+      g_mutex_unlock(&dispatcher_mutex);
+
+      if (terminate)
+         break;
+   }
+
+   g_array_free(held, true);
+   DBGTRC_DONE(debug, TRACE_GROUP, "Terminating");
+   return NULL;
+}
+
+
+/** Starts the dispatcher thread if it is not already running.
+ *
+ *  @return true if the dispatcher thread is running
+ */
+static bool
+ensure_dispatcher_started() {
+   bool ok = true;
+   g_mutex_lock(&dispatcher_mutex);
+   if (!dispatcher_thread) {
+      dispatcher_wake_fd = eventfd(0, EFD_CLOEXEC|EFD_NONBLOCK);
+      if (dispatcher_wake_fd < 0) {
+         SYSLOG2(DDCA_SYSLOG_ERROR, "(%s) eventfd() failed: %s", __func__, strerror(errno));
+         ok = false;
+      }
+      else {
+         dispatcher_terminate = false;
+         dispatcher_thread = g_thread_new("event_dispatcher", display_event_dispatcher_func,
+                                          GINT_TO_POINTER(dispatcher_wake_fd));
+      }
+   }
+   g_mutex_unlock(&dispatcher_mutex);
+   return ok;
+}
+
+
+/** Wakes the dispatcher thread, if it is running. */
+static void
+wake_dispatcher() {
+   g_mutex_lock(&dispatcher_mutex);
+   if (dispatcher_wake_fd >= 0)
+      eventfd_write(dispatcher_wake_fd, 1);
+   g_mutex_unlock(&dispatcher_mutex);
+}
+
+
+/** Gets the EDID of the display that a connect or disconnect event refers
+ *  to, from the display ref if there is one, otherwise from the DRM connector.
+ *
+ *  @param  evt   event
+ *  @param  edid  where to return the EDID, not valid if unavailable
+ */
+static void
+get_event_edid(DDCA_Display_Status_Event * evt, Event_Edid * edid) {
+   edid->valid = false;
+   if (evt->event_type != DDCA_EVENT_DISPLAY_CONNECTED &&
+       evt->event_type != DDCA_EVENT_DISPLAY_DISCONNECTED)
+      return;
+   Display_Ref * dref = (Display_Ref *) evt->dref;
+   if (dref && dref->pedid) {
+      memcpy(edid->bytes, dref->pedid->bytes, 128);
+      edid->valid = true;
+   }
+   else if (!dref && strlen(evt->connector_name) > 0) {
+      GByteArray * sysfs_edid = NULL;
+      RPT_ATTR_EDID(-1, &sysfs_edid, "/sys/class/drm", evt->connector_name, "edid");
+      if (sysfs_edid) {
+         if (sysfs_edid->len >= 128) {
+            memcpy(edid->bytes, sysfs_edid->data, 128);
+            edid->valid = true;
+         }
+         g_byte_array_free(sysfs_edid, true);
+      }
+   }
+}
+
+
+/** Queues an event for delivery to clients by the dispatcher thread.
+ *
+ *  If the dispatcher thread cannot be started, the event is delivered
+ *  on the current thread.
+ *
+ *  @param  evt
+ */
+void ddc_emit_display_status_record(
+      DDCA_Display_Status_Event  evt)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "evt=%s", display_status_event_repr_t(evt));
+
+   Event_Edid edid;
+   get_event_edid(&evt, &edid);
+   if (!ensure_dispatcher_started()) {
+      dispatch_display_status_event(evt);
+   }
+   else if (event_queue_push(&evt, &edid)) {
+      INCR_STAT(queued);
+      wake_dispatcher();
+   }
+   else {
+      INCR_STAT(queue_overflows);
+      SYSLOG2(DDCA_SYSLOG_ERROR, "Display status event queue full, dropped %s",
+              display_status_event_repr_t(evt));
+   }
+
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+/** Delivers all queued and held events, waiting until the dispatcher thread
+ *  has done so.  Must be called before display refs are freed, since queued
+ *  events hold pointers to them.
+ *
+ *  Does not wait if called on the dispatcher thread, i.e. from a display
+ *  status callback.
+ */
+void ddc_flush_display_status_events() {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "");
+   g_mutex_lock(&dispatcher_mutex);
+   if (dispatcher_thread && dispatcher_thread != g_thread_self() &&
+       !__atomic_load_n(&dispatcher_terminate, __ATOMIC_ACQUIRE))
+   {
+      uint64_t requested = ++flush_requests;
+      eventfd_write(dispatcher_wake_fd, 1);
+      while (flushes_done < requested)
+         g_cond_wait(&dispatcher_flushed_cond, &dispatcher_mutex);
+   }
+   g_mutex_unlock(&dispatcher_mutex);
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+/** Reports display status event delivery statistics.
+ *
+ *  @param  depth  logical indentation depth
+ */
+void ddc_report_display_event_stats(int depth) {
+   rpt_title("Display status events:", depth);
+   rpt_vstring(depth+1, "Queued:                   %d", __atomic_load_n(&event_stats.queued,          __ATOMIC_RELAXED));
+   rpt_vstring(depth+1, "Dispatched:               %d", __atomic_load_n(&event_stats.dispatched,      __ATOMIC_RELAXED));
+   rpt_vstring(depth+1, "Coalesced:                %d", __atomic_load_n(&event_stats.coalesced,       __ATOMIC_RELAXED));
+   rpt_vstring(depth+1, "Dropped, queue full:      %d", __atomic_load_n(&event_stats.queue_overflows, __ATOMIC_RELAXED));
+   rpt_vstring(depth+1, "Not written, client full: %d", __atomic_load_n(&event_stats.fd_overflows,    __ATOMIC_RELAXED));
 }
 
 
@@ -214,6 +776,11 @@ void ddc_emit_display_status_event(
             event_type, ddc_display_event_type_name(event_type));
    }
 
+   // cached display state and pooled handles must be revalidated
+   // after any change in display state
+   i2c_note_display_state_change();
+   i2c_handle_pool_invalidate((io_path.io_mode == DDCA_IO_I2C) ? io_path.path.i2c_busno : -1);
+
    DDCA_Display_Status_Event evt = ddc_create_display_status_event(
          event_type,
          connector_name,
@@ -233,8 +800,51 @@ void ddc_emit_display_status_event(
 
 
 void init_ddc_status_events() {
+   for (int ndx = 0; ndx < DISPLAY_EVENT_QUEUE_SIZE; ndx++)
+      event_queue[ndx].seqno = ndx;
+
    RTTI_ADD_FUNC(ddc_emit_display_status_event);
    RTTI_ADD_FUNC(ddc_emit_display_status_record);
+   RTTI_ADD_FUNC(ddc_flush_display_status_events);
+   RTTI_ADD_FUNC(dispatch_display_status_event);
+   RTTI_ADD_FUNC(ddc_open_display_status_fd);
    RTTI_ADD_FUNC(ddc_register_display_status_callback);
    RTTI_ADD_FUNC(ddc_unregister_display_status_callback);
+   RTTI_ADD_FUNC(ddc_register_display_ready_callback);
+   RTTI_ADD_FUNC(ddc_unregister_display_ready_callback);
+   RTTI_ADD_FUNC(ddc_emit_display_ready);
+}
+
+
+/** Delivers any queued events, then stops the dispatcher thread and
+ *  closes client file descriptors.
+ */
+void terminate_ddc_status_events() {
+   g_mutex_lock(&dispatcher_mutex);
+   GThread * thread = dispatcher_thread;
+   if (thread) {
+      __atomic_store_n(&dispatcher_terminate, true, __ATOMIC_RELEASE);
+      eventfd_write(dispatcher_wake_fd, 1);
+   }
+   g_mutex_unlock(&dispatcher_mutex);
+
+   // not joined while holding the mutex, which the dispatcher thread
+   // and callbacks emitting events acquire
+   if (thread) {
+      g_thread_join(thread);
+      g_mutex_lock(&dispatcher_mutex);
+      dispatcher_thread = NULL;
+      close(dispatcher_wake_fd);
+      dispatcher_wake_fd = -1;
+      g_mutex_unlock(&dispatcher_mutex);
+   }
+
+   g_mutex_lock(&status_event_fds_mutex);
+   if (status_event_fds) {
+      for (int ndx = 0; ndx < status_event_fds->len; ndx++)
+         close(g_array_index(status_event_fds, int, ndx));
+      g_array_free(status_event_fds, true);
+      status_event_fds = NULL;
+   }
+   g_mutex_unlock(&status_event_fds_mutex);
 }
@@ -13,6 +13,8 @@
 #include "base/displays.h"
 
 // Display Status Events
+extern bool  ddc_coalesce_display_events;
+extern int   ddc_double_tap_millisec;
 DDCA_Status  ddc_register_display_status_callback(DDCA_Display_Status_Callback_Func func);
 DDCA_Status  ddc_unregister_display_status_callback(DDCA_Display_Status_Callback_Func func);
 const char * ddc_display_event_class_name(DDCA_Display_Event_Class class);
@@ -25,11 +27,21 @@ DDCA_Display_Status_Event
                                              Display_Ref*            dref,
                                              DDCA_IO_Path            io_path);
 void         ddc_emit_display_status_record(DDCA_Display_Status_Event  evt);
+void         ddc_flush_display_status_events();
+DDCA_Status  ddc_open_display_status_fd(int * fd_loc);
+void         ddc_report_display_event_stats(int depth);
+
+// Display Ready Events
+DDCA_Status  ddc_register_display_ready_callback(DDCA_Display_Ready_Callback_Func func);
+DDCA_Status  ddc_unregister_display_ready_callback(DDCA_Display_Ready_Callback_Func func);
+void         ddc_emit_display_ready(Display_Ref * dref);
+
 void         ddc_emit_display_status_event(DDCA_Display_Event_Type event_type,
                                               const char *            connector_name,
                                               Display_Ref*            dref,
                                               DDCA_IO_Path            io_path,
                                               GArray*                 queue);
 void init_ddc_status_events();
+void terminate_ddc_status_events();
 
 #endif /* DDC_STATUS_EVENTS_H_ */
@@ -26,6 +26,8 @@
 #include "base/ddc_errno.h"
 #include "base/ddc_packets.h"
 #include "base/displays.h"
+#include "base/execution_stats.h"
+#include "base/per_display_data.h"
 #include "base/rtti.h"
 #include "base/status_code_mgt.h"
 
@@ -137,6 +139,7 @@ ddc_set_nontable_vcp_value(
    DBGTRC_STARTING(debug, TRACE_GROUP,
           "Writing feature 0x%02x , new value = %d, dh=%s",
           feature_code, new_value, dh_repr(dh) );
+   bool optime_started = optime_start(OPTIME_SETVCP);
 
    Public_Status_Code psc = 0;
    Error_Info * ddc_excp = NULL;
@@ -158,6 +161,7 @@ ddc_set_nontable_vcp_value(
 
       free_ddc_packet(request_packet_ptr);
    }
+   pdd_optime_end_by_dh(dh, optime_started);
 
    if ( psc==DDCRC_RETRIES )
       DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Try errors: %s", errinfo_causes_string(ddc_excp));  // needed?
@@ -370,6 +374,7 @@ ddc_set_vcp_value(
    if ( get_output_level() < DDCA_OL_VERBOSE && !debug )
       verbose_msg_dest = NULL;
 
+   bool optime_started = optime_start(OPTIME_SETVCP);
    Error_Info * ddc_excp = NULL;
    if (newval_loc)
       *newval_loc = NULL;
@@ -436,6 +441,7 @@ ddc_set_vcp_value(
                   vrec->val.c_nc.sl);
       }
    }
+   pdd_optime_end_by_dh(dh, optime_started);
 
    DBGTRC_RET_ERRINFO(debug, TRACE_GROUP, ddc_excp, "");
    return ddc_excp;
@@ -568,6 +574,7 @@ ddc_get_nontable_vcp_value(
       }
    }
 
+   bool optime_started = optime_start(OPTIME_GETVCP);
    DDC_Packet * response_packet_ptr = NULL;
    DDC_Packet * request_packet_ptr = create_ddc_getvcp_request_packet(
                                   feature_code, "ddc_get_nontable_vcp_value:request packet");
@@ -645,6 +652,7 @@ ddc_get_nontable_vcp_value(
    free_ddc_packet(request_packet_ptr);
    if (response_packet_ptr)
       free_ddc_packet(response_packet_ptr);
+   pdd_optime_end_by_dh(dh, optime_started);
 
    ASSERT_IFF(excp, !parsed_response); // needed to avoid clang warning
    if (!excp) {
@@ -686,12 +694,14 @@ ddc_get_table_vcp_value(
    DDCA_Output_Level output_level = get_output_level();
    Buffer * paccumulator =  NULL;
 
+   bool optime_started = optime_start(OPTIME_TABLE_READ);
    ddc_excp = multi_part_read_with_retry(
             dh,
             DDC_PACKET_TYPE_TABLE_READ_REQUEST,
             feature_code,
             Write_Read_Flag_All_Zero_Response_Ok | Write_Read_Flag_Table_Read,
             &paccumulator);
+   pdd_optime_end_by_dh(dh, optime_started);
    if (debug || ddc_excp) {
       DBGTRC_NOPREFIX(debug, TRACE_GROUP,
              "multi_part_read_with_retry() returned %s", psc_desc(ddc_excp->status_code));
@@ -6,7 +6,6 @@
 // Copyright (C) 2021-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
-#define _GNU_SOURCE    // for usleep()
 
 #include "config.h"
 #include "public/ddcutil_types.h"
@@ -19,10 +18,14 @@
 #ifdef ENABLE_UDEV
 #include <libudev.h>
 #endif
+#include <poll.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/stat.h>
+#include <sys/timerfd.h>
 #include <unistd.h>
 
 #include "util/coredefs.h"
@@ -61,7 +64,7 @@
 // Trace class for this file
 static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_NONE;
 
-static bool      terminate_watch_thread = false;
+static int       watch_stop_fd = -1;     // eventfd, written to request termination
 static GThread * watch_thread = NULL;
 static DDCA_Display_Event_Class active_classes = DDCA_EVENT_CLASS_NONE;
 static GMutex    watch_thread_mutex;
@@ -69,6 +72,7 @@ static GMutex    watch_thread_mutex;
 DDC_Watch_Mode   ddc_watch_mode = Watch_Mode_Simple_Udev;
 bool             ddc_slow_watch = false;
 int              extra_stabilize_seconds = DEFAULT_EXTRA_STABILIZE_SECS;
+bool             ddc_dpms_event_detection = DEFAULT_DPMS_EVENT_DETECTION;
 
 const char * ddc_watch_mode_name(DDC_Watch_Mode mode) {
    char * result = NULL;
@@ -86,6 +90,7 @@ typedef struct {
    pid_t                    main_process_id;
    pid_t                    main_thread_id;
    DDCA_Display_Event_Class event_classes;
+   int                      stop_fd;     // thread's own descriptor for watch_stop_fd
 // #ifdef OLD_HOTPLUG_VERSION
    Display_Change_Handler display_change_handler;
    Bit_Set_32             drm_card_numbers;
@@ -98,6 +103,8 @@ void free_watch_displays_data(Watch_Displays_Data * wdd) {
    if (wdd) {
       assert( memcmp(wdd->marker, WATCH_DISPLAYS_DATA_MARKER, 4) == 0 );
       wdd->marker[3] = 'x';
+      if (wdd->stop_fd >= 0)
+         close(wdd->stop_fd);
       free(wdd);
    }
 }
@@ -122,6 +129,24 @@ bool check_thread_or_process(pid_t id) {
 }
 
 
+/** Waits until termination of the watch thread is requested or
+ *  a timeout expires.
+ *
+ *  @param  stop_fd   eventfd signalled by #ddc_stop_watch_displays()
+ *  @param  millisec  maximum time to wait
+ *  @return true if termination was requested, false if timed out
+ */
+static bool
+wait_for_stop_request(int stop_fd, int millisec) {
+   struct pollfd pfd = {.fd = stop_fd, .events = POLLIN};
+   int rc;
+   do {
+      rc = poll(&pfd, 1, millisec);
+   } while (rc < 0 && errno == EINTR);
+   return rc > 0;
+}
+
+
 //
 //  Variant Watch_Mode_Full_Poll
 //
@@ -134,10 +159,10 @@ bool check_thread_or_process(pid_t id) {
 void ddc_recheck_bus() {
    bool debug = false;
    DBGTRC_STARTING(debug, DDCA_TRC_NONE, "");
-   // may need to wait on startup
-   while (!all_i2c_buses) {
-      DBGMSF(debug, "Waiting 1 sec for all_i2c_buses");
-      usleep(1000*1000);
+   // on startup, buses may not yet have been detected; check again next time
+   if (!all_i2c_buses) {
+      DBGTRC_DONE(debug, DDCA_TRC_NONE, "all_i2c_buses not yet set");
+      return;
    }
 
    Bit_Set_256  old_attached_buses_bitset  = buses_bitset_from_businfo_array(all_i2c_buses, false);
@@ -310,14 +335,12 @@ gpointer ddc_watch_displays_using_poll(gpointer data) {
    Watch_Displays_Data * wdd = data;
    assert(wdd && memcmp(wdd->marker, WATCH_DISPLAYS_DATA_MARKER, 4) == 0);
 
-   while (!terminate_watch_thread) {
+   int millisec = 3000;
+   if (ddc_slow_watch)
+      millisec *= 5;
+   do {
       ddc_recheck_bus();
-      int microsec = 3000*1000;
-      if (ddc_slow_watch)
-         microsec *= 5;
-      usleep(microsec);
-      // printf("."); fflush(stdout);
-   }
+   } while (!wait_for_stop_request(wdd->stop_fd, millisec));
    DBGTRC_DONE(true, TRACE_GROUP, "Terminating");
    free_watch_displays_data(wdd);
    g_thread_exit(0);
@@ -563,104 +586,105 @@ bool ddc_hotplug_change_handler(
 }
 
 
-/** Repeatedly calls #get_sysfs_drm_connector_names() until the value read
- *  equals the prior value.
+/** Reports whether any displays were disconnected between two
+ *  readings of the DRM connector names.
  *
- *  @oaram prior  initial connector value
- *  @param some_displays_disconnected
- *  @return stabilized value
+ *  @param  prior   earlier connector names
+ *  @param  latest  current connector names
+ *  @return true if some connector that had an EDID no longer has one
  */
-Sysfs_Connector_Names
-stabilized_connector_names(Sysfs_Connector_Names prior,
-                           bool                  some_displays_disconnected) {
+STATIC bool
+some_displays_disconnected(Sysfs_Connector_Names prior, Sysfs_Connector_Names latest) {
+   GPtrArray * connectors_having_edid_removed =
+         gaux_unique_string_ptr_arrays_minus(prior.connectors_having_edid,
+                                             latest.connectors_having_edid);
+   bool result = connectors_having_edid_removed->len > 0;
+   g_ptr_array_free(connectors_having_edid_removed, true);
+   return result;
+}
+
+
+/** Detects displays that were replaced on a connector without the connector
+ *  being seen without an EDID, e.g. by a KVM switch.  Such a change does not
+ *  alter the connector names, but it does change the connector's generation
+ *  number.  Connectors whose generation number is unchanged are skipped.
+ *
+ *  For each replaced display, a disconnect event and a connect event are queued.
+ *
+ *  @param  connectors_having_edid  current connectors with an EDID
+ *  @param  generations             connector name -> generation number when last
+ *                                  checked, replaced by the current values
+ *  @param  events_queue            array to which display status events are appended
+ *  @return true if any event was queued
+ */
+STATIC bool
+ddc_check_replaced_displays(
+      GPtrArray *  connectors_having_edid,
+      GHashTable * generations,
+      GArray *     events_queue)
+{
    bool debug = false;
-   if (IS_DBGTRC(debug, DDCA_TRC_NONE)) {
-      DBGTRC_STARTING(true, DDCA_TRC_NONE,"prior:");
-      dbgrpt_sysfs_connector_names(prior, 2);
+   DBGTRC_STARTING(debug, TRACE_GROUP, "connectors_having_edid: %s",
+                                       join_string_g_ptr_array_t(connectors_having_edid, ", "));
+
+   GPtrArray * replaced = g_ptr_array_new_with_free_func(g_free);
+   GArray * latest = g_array_sized_new(false, false, sizeof(uint64_t), connectors_having_edid->len);
+   for (int ndx = 0; ndx < connectors_having_edid->len; ndx++) {
+      char * connector_name = g_ptr_array_index(connectors_having_edid, ndx);
+      uint64_t generation = i2c_sysfs_drm_connector_generation(connector_name);
+      uint64_t * prior = g_hash_table_lookup(generations, connector_name);
+      if (prior && *prior != 0 && generation != 0 && *prior != generation)
+         g_ptr_array_add(replaced, g_strdup(connector_name));
+      g_array_append_val(latest, generation);
    }
 
-   // Special handling for case of apparently disconnected displays.
-   // It has been observed that in some cases (Samsung U32H750) a disconnect is followed a
-   // few seconds later by a connect. Wait a few seconds to avoid triggering events
-   // in this case.
-   if (some_displays_disconnected) {
-      if (extra_stabilize_seconds > 0) {
-         char * s = g_strdup_printf(
-               "Delaying %d seconds to avoid a false disconnect/connect sequence...", extra_stabilize_seconds);
-         DBGTRC(debug, TRACE_GROUP, "%s", s);
-         SYSLOG2(DDCA_SYSLOG_NOTICE, "%s", s);
-         free(s);
-         usleep(extra_stabilize_seconds * 1000000);
-      }
+   g_hash_table_remove_all(generations);
+   for (int ndx = 0; ndx < connectors_having_edid->len; ndx++) {
+      uint64_t * generation = g_new(uint64_t, 1);
+      *generation = g_array_index(latest, uint64_t, ndx);
+      g_hash_table_replace(generations, g_strdup(g_ptr_array_index(connectors_having_edid, ndx)), generation);
    }
 
-   int stablect = 0;
-   bool stable = false;
-   while (!stable) {
-      usleep(1000*1000);  // 1 second
-      Sysfs_Connector_Names latest = get_sysfs_drm_connector_names();
-      if (sysfs_connector_names_equal(prior, latest))
-            stable = true;
-      free_sysfs_connector_names_contents(prior);
-      prior = latest;
-      stablect++;
-   }
-   if (stablect > 1) {
-      DBGTRC(debug, TRACE_GROUP,   "Required %d extra calls to get_sysfs_drm_connector_names()", stablect+1);
-      SYSLOG2(DDCA_SYSLOG_NOTICE, "%s required %d extra calls to get_sysfs_drm_connector_names()", __func__, stablect-1);
+   bool event_emitted = false;
+   if (replaced->len > 0) {
+      char * s = join_string_g_ptr_array_t(replaced, ", ");
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "connectors with replaced displays: %s", s);
+      SYSLOG2(DDCA_SYSLOG_NOTICE, "DRM connectors with replaced displays: %s", s);
+      event_emitted = ddc_hotplug_change_handler(NULL, NULL, replaced, replaced, events_queue);
    }
+   g_ptr_array_free(replaced, true);
+   g_array_free(latest, true);
 
-   DBGTRC_RET_STRUCT_VALUE(debug, DDCA_TRC_NONE, Sysfs_Connector_Names, dbgrpt_sysfs_connector_names, prior);
-   return prior;
+   DBGTRC_RET_BOOL(debug, TRACE_GROUP, event_emitted, "");
+   return event_emitted;
 }
 
 
-/** Obtains a list of currently connected displays and compares it to the
- *  previously detected list
+/** Compares the stabilized list of DRM connector names to the
+ *  previously reported list.
  *
- *  If any changes were detected, calls the hotplug_change_handler
+ *  If any changes were detected, calls the hotplug_change_handler.
  *
- *  @param prev_displays   GPtrArray of previously detected displays
- *  @return GPtrArray of currently detected monitors
+ *  @param  prev_connector_names  previously reported connector names,
+ *                                contents are freed
+ *  @param  new_connector_names   stabilized current connector names
+ *  @param  events_queue          array to which display status events are appended
+ *  @return new_connector_names
  */
 //static
 Sysfs_Connector_Names ddc_check_displays(
       Sysfs_Connector_Names prev_connector_names,
+      Sysfs_Connector_Names new_connector_names,
       GArray * events_queue)
 {
    bool debug = false;
    if (IS_DBGTRC(debug, DDCA_TRC_NONE)) {
       DBGTRC_STARTING(true, DDCA_TRC_NONE, "prev_connector_names:");
       dbgrpt_sysfs_connector_names(prev_connector_names, 2);
-   }
-
-
-   Sysfs_Connector_Names new_connector_names = get_sysfs_drm_connector_names();
-
-   if (IS_DBGTRC(debug, DDCA_TRC_NONE)) {
       DBGMSG("new_connector_names:");
       dbgrpt_sysfs_connector_names(new_connector_names, 1);
    }
 
-   if (!sysfs_connector_names_equal(prev_connector_names, new_connector_names)) {
-      // Detect need for special handling for case of display disconnected.
-      GPtrArray * connectors_having_edid_removed =
-            gaux_unique_string_ptr_arrays_minus(prev_connector_names.connectors_having_edid,
-                                                 new_connector_names.connectors_having_edid);
-      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "connectors_having_edid_removed: %s",
-               join_string_g_ptr_array_t(connectors_having_edid_removed, ", ") );
-      bool detected_displays_removed = connectors_having_edid_removed->len > 0;
-      g_ptr_array_free(connectors_having_edid_removed, true);
-
-      Sysfs_Connector_Names stabilized_names = stabilized_connector_names(new_connector_names, detected_displays_removed);
-      if (IS_DBGTRC(debug, DDCA_TRC_NONE))  {
-         DBGTRC(true, DDCA_TRC_NONE, "stabilized_names:");
-         dbgrpt_sysfs_connector_names(stabilized_names, 2);
-      }
-      // free_connector_names_arrays(new_connector_names); // done in stabilized_arrays
-      new_connector_names = stabilized_names;
-   }
-
    bool hotplug_change_handler_emitted = false;
    bool connector_names_changed = !sysfs_connector_names_equal(prev_connector_names, new_connector_names);
    DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "connector_names_changed = %s", SBOOL(connector_names_changed));
@@ -718,9 +742,86 @@ Sysfs_Connector_Names ddc_check_displays(
 }
 
 
+/** Compares the current DPMS state of a connector to its prior state,
+ *  and if changed queues a sleep or awake event.
+ *
+ *  @param  connector               DRM connector name
+ *  @param  is_dpms_asleep          current DPMS state
+ *  @param  sleepy_connectors       connectors last seen asleep, updated
+ *  @param  display_status_events   array of DDCA_Display_Status_Event
+ */
+STATIC void
+ddc_note_dpms_state(const char * connector,
+      bool        is_dpms_asleep,
+      GPtrArray * sleepy_connectors,
+      GArray *    display_status_events)
+{
+   bool debug = false;
+   guint found_sleepy_loc = 0;
+   bool last_checked_dpms_asleep = g_ptr_array_find_with_equal_func(
+                        sleepy_connectors, connector, g_str_equal, &found_sleepy_loc);
+   DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "connector =%s, last_checked_dpms_asleep=%s, is_dpms_asleep=%s",
+         connector, sbool (last_checked_dpms_asleep), sbool(is_dpms_asleep));
+
+   if (is_dpms_asleep != last_checked_dpms_asleep) {
+      Display_Ref * dref = DDC_GET_DREF_BY_CONNECTOR(connector, /* ignore_invalid */ true);
+#ifdef REDUNDANT
+      DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "connector = %s, sleep event: %s",
+            connector,
+            (is_dpms_asleep) ? "Asleep" : "Awake");
+#endif
+      DDCA_Display_Status_Event evt;
+      if (!dref) {
+         SYSLOG2(DDCA_SYSLOG_WARNING, "Sleep event. connector=%s, dref not set", connector);
+         int busno = sys_drm_get_busno_by_connector(connector);
+         DDCA_IO_Path io_path = i2c_io_path(busno);
+         evt = ddc_create_display_status_event(
+                     (is_dpms_asleep) ? DDCA_EVENT_DPMS_ASLEEP : DDCA_EVENT_DPMS_AWAKE,
+                     connector,
+                     NULL,
+                     io_path);
+      }
+      else {
+         evt = ddc_create_display_status_event(
+                     (is_dpms_asleep) ? DDCA_EVENT_DPMS_ASLEEP : DDCA_EVENT_DPMS_AWAKE,
+                     connector,
+                     dref,
+                     dref->io_path);
+      }
+      DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Queueing %s", display_status_event_repr_t(evt));
+      g_array_append_val(display_status_events,evt);
+#ifdef OLD
+         ddc_emit_display_status_event(
+               (is_dpms_asleep) ? DDCA_EVENT_DPMS_ASLEEP : DDCA_EVENT_DPMS_AWAKE,
+               connector,
+               dref,
+               dref->io_path);
+#endif
+
+      if (is_dpms_asleep) {
+         DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Adding %s to sleepy_connectors", connector);
+         g_ptr_array_add(sleepy_connectors, g_strdup(connector));
+      }
+      else {
+         DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Removing %s from sleepy_connectors", connector);
+         g_ptr_array_remove_index(sleepy_connectors, found_sleepy_loc);
+      }
+   }
+}
+
+
+/** Checks the DPMS state of active connectors.
+ *
+ *  @param  active_connectors      connectors having a display
+ *  @param  sleepy_connectors      connectors last seen asleep, updated
+ *  @param  display_status_events  array of DDCA_Display_Status_Event
+ *  @param  skip_connectors        if non-NULL, connectors whose DPMS state
+ *                                 need not be read because changes are signalled
+ */
 void  ddc_check_asleep(GPtrArray * active_connectors,
       GPtrArray * sleepy_connectors,
-      GArray* display_status_events) // array of DDCA_Display_Status_Event
+      GArray* display_status_events, // array of DDCA_Display_Status_Event
+      GPtrArray * skip_connectors)
 {
    bool debug = false;
    DBGTRC_STARTING(debug, DDCA_TRC_NONE, "active_connectors =%s",
@@ -758,57 +859,11 @@ void  ddc_check_asleep(GPtrArray * active_connectors,
             active_conn_ndx, active_connectors->len);
 
       char * connector = g_ptr_array_index(active_connectors, active_conn_ndx);
+      if (skip_connectors &&
+          g_ptr_array_find_with_equal_func(skip_connectors, connector, g_str_equal, NULL))
+         continue;
       bool is_dpms_asleep = dpms_check_drm_asleep_by_connector(connector);
-      guint found_sleepy_loc = 0;
-      bool last_checked_dpms_asleep = g_ptr_array_find_with_equal_func(
-                           sleepy_connectors, connector, g_str_equal, &found_sleepy_loc);
-      DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "connector =%s, last_checked_dpms_asleep=%s, is_dpms_asleep=%s",
-            connector, sbool (last_checked_dpms_asleep), sbool(is_dpms_asleep));
-
-      if (is_dpms_asleep != last_checked_dpms_asleep) {
-         Display_Ref * dref = DDC_GET_DREF_BY_CONNECTOR(connector, /* ignore_invalid */ true);
-#ifdef REDUNDANT
-         DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "connector = %s, sleep event: %s",
-               connector,
-               (is_dpms_asleep) ? "Asleep" : "Awake");
-#endif
-         DDCA_Display_Status_Event evt;
-         if (!dref) {
-            SYSLOG2(DDCA_SYSLOG_WARNING, "Sleep event. connector=%s, dref not set", connector);
-            int busno = sys_drm_get_busno_by_connector(connector);
-            DDCA_IO_Path io_path = i2c_io_path(busno);
-            evt = ddc_create_display_status_event(
-                        (is_dpms_asleep) ? DDCA_EVENT_DPMS_ASLEEP : DDCA_EVENT_DPMS_AWAKE,
-                        connector,
-                        NULL,
-                        io_path);
-         }
-         else {
-            evt = ddc_create_display_status_event(
-                        (is_dpms_asleep) ? DDCA_EVENT_DPMS_ASLEEP : DDCA_EVENT_DPMS_AWAKE,
-                        connector,
-                        dref,
-                        dref->io_path);
-         }
-         DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Queueing %s", display_status_event_repr_t(evt));
-         g_array_append_val(display_status_events,evt);
-#ifdef OLD
-            ddc_emit_display_status_event(
-                  (is_dpms_asleep) ? DDCA_EVENT_DPMS_ASLEEP : DDCA_EVENT_DPMS_AWAKE,
-                  connector,
-                  dref,
-                  dref->io_path);
-#endif
-
-         if (is_dpms_asleep) {
-            DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Adding %s to sleepy_connectors", connector);
-            g_ptr_array_add(sleepy_connectors, g_strdup(connector));
-         }
-         else {
-            DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Removing %s from sleepy_connectors", connector);
-            g_ptr_array_remove_index(sleepy_connectors, found_sleepy_loc);
-         }
-      }
+      ddc_note_dpms_state(connector, is_dpms_asleep, sleepy_connectors, display_status_events);
 
       DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "bottom of loop 2, active_connectors->len = %d, sleepy_connectors->len=%d",
             active_connectors->len, sleepy_connectors->len);
@@ -920,6 +975,218 @@ void filter_sleep_events(GArray * events) {
 }
 
 
+/** Emits the display status events that have been queued, after
+ *  removing sleep/wake pairs that cancel each other.
+ *
+ *  @param  deferred_events  array of #DDCA_Display_Status_Event, emptied on return
+ */
+STATIC void
+emit_deferred_events(GArray * deferred_events) {
+   bool debug = false;
+   if (deferred_events->len == 0)
+      return;
+
+   if (deferred_events->len > 1) {  // FUTURE ENHANCMENT, filter out meaningless events
+      // check for cancellation events
+      for (int ndx = 0; ndx < deferred_events->len; ndx++) {
+         DDCA_Display_Status_Event evt = g_array_index(deferred_events, DDCA_Display_Status_Event, ndx);
+         DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Event %d in queue: %s", ndx, display_status_event_repr_t(evt));
+      }
+      filter_sleep_events(deferred_events);
+   }
+   DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Emitting %d deferred events", deferred_events->len);
+   for (int ndx = 0; ndx < deferred_events->len; ndx++) {
+      DDCA_Display_Status_Event evt = g_array_index(deferred_events, DDCA_Display_Status_Event, ndx);
+      DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Emitting deferred event %s", display_status_event_repr_t(evt));
+      ddc_emit_display_status_record(evt);
+   }
+   g_array_remove_range(deferred_events,0, deferred_events->len);
+}
+
+
+/** Sets the expiration of a timerfd.
+ *
+ *  @param  fd        timerfd
+ *  @param  millisec  time until first expiration, 0 to disarm
+ *  @param  periodic  if true, timer repeats at the same interval
+ *  @return true if successful, false if not (the error is logged)
+ */
+static bool
+arm_timer(int fd, int millisec, bool periodic) {
+   struct itimerspec spec = {{0,0},{0,0}};
+   spec.it_value.tv_sec  = millisec / 1000;
+   spec.it_value.tv_nsec = (millisec % 1000) * 1000000L;
+   if (periodic)
+      spec.it_interval = spec.it_value;
+   int rc = timerfd_settime(fd, 0, &spec, NULL);
+   if (rc < 0)
+      SYSLOG2(DDCA_SYSLOG_ERROR, "(%s) timerfd_settime() failed: %s", __func__, strerror(errno));
+   return rc == 0;
+}
+
+
+/** Reads a readable timerfd, so that it is no longer reported as ready. */
+static void
+drain_timer(int fd) {
+   uint64_t expirations;
+   ssize_t ct = read(fd, &expirations, sizeof(expirations));
+   (void) ct;    // EAGAIN if already drained
+}
+
+
+static bool
+add_epoll_fd(int epoll_fd, int fd) {
+   struct epoll_event evt = {.events = EPOLLIN, .data.fd = fd};
+   return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &evt) == 0;
+}
+
+
+/** Watch of the sysfs dpms attribute of a DRM connector */
+typedef struct {
+   char * connector;
+   int    fd;          // open /sys/class/drm/<connector>/dpms
+   bool   signalled;   // driver has notified a change, so POLLPRI is reliable
+   bool   state_read;  // asleep has been read successfully
+   bool   asleep;      // last state read
+} Dpms_Watch;
+
+
+static void
+free_dpms_watch(gpointer data) {
+   Dpms_Watch * watch = data;
+   close(watch->fd);     // also removes fd from epoll set
+   free(watch->connector);
+   free(watch);
+}
+
+
+/** Reads the dpms attribute of a watched connector.  Reading the
+ *  attribute also rearms POLLPRI notification.
+ *
+ *  If the attribute cannot be read, the state is unknown and the
+ *  previously read state is retained.
+ *
+ *  @param  watch        connector watch
+ *  @param  changed_loc  if non-NULL, set to true if the state was read
+ *                       and differs from the previously read state
+ *  @return true if the display is asleep
+ */
+static bool
+read_dpms_watch_asleep(Dpms_Watch * watch, bool * changed_loc) {
+   char buf[20] = {0};
+   bool changed = false;
+   ssize_t ct = pread(watch->fd, buf, sizeof(buf)-1, 0);
+   if (ct > 0) {
+      bool asleep = !str_starts_with(buf, "On");
+      changed = watch->state_read && asleep != watch->asleep;
+      watch->asleep = asleep;
+      watch->state_read = true;
+   }
+   if (changed_loc)
+      *changed_loc = changed;
+   return watch->asleep;
+}
+
+
+static Dpms_Watch *
+find_dpms_watch_by_fd(GPtrArray * watches, int fd) {
+   for (int ndx = 0; ndx < watches->len; ndx++) {
+      Dpms_Watch * cur = g_ptr_array_index(watches, ndx);
+      if (cur->fd == fd)
+         return cur;
+   }
+   return NULL;
+}
+
+
+/** Returns the names of the connectors whose drivers signal DPMS changes.
+ *
+ *  @param  watches  array of #Dpms_Watch
+ *  @return array of connector names, owned by watches
+ */
+static GPtrArray *
+signalled_dpms_connectors(GPtrArray * watches) {
+   GPtrArray * result = g_ptr_array_new();
+   for (int ndx = 0; ndx < watches->len; ndx++) {
+      Dpms_Watch * cur = g_ptr_array_index(watches, ndx);
+      if (cur->signalled)
+         g_ptr_array_add(result, cur->connector);
+   }
+   return result;
+}
+
+
+/** Updates the set of watched dpms attributes to match the connectors
+ *  having a display.
+ *
+ *  @param  watches     array of #Dpms_Watch
+ *  @param  connectors  connectors having an EDID
+ *  @param  epoll_fd    epoll instance of the watch thread
+ *  @return true if a connector was added
+ */
+static bool
+update_dpms_watches(GPtrArray * watches, GPtrArray * connectors, int epoll_fd) {
+   bool debug = false;
+   int ndx = 0;
+   while (ndx < watches->len) {
+      Dpms_Watch * cur = g_ptr_array_index(watches, ndx);
+      if (!g_ptr_array_find_with_equal_func(connectors, cur->connector, g_str_equal, NULL))
+         g_ptr_array_remove_index(watches, ndx);
+      else
+         ndx++;
+   }
+
+   bool added = false;
+   for (int cndx = 0; cndx < connectors->len; cndx++) {
+      char * connector = g_ptr_array_index(connectors, cndx);
+      bool found = false;
+      for (int wndx = 0; wndx < watches->len && !found; wndx++)
+         found = streq(((Dpms_Watch*) g_ptr_array_index(watches, wndx))->connector, connector);
+      if (found)
+         continue;
+
+      char path[PATH_MAX];
+      g_snprintf(path, sizeof(path), "/sys/class/drm/%s/dpms", connector);
+      int fd = open(path, O_RDONLY|O_CLOEXEC);
+      if (fd < 0) {
+         DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Unable to open %s: %s", path, strerror(errno));
+         continue;
+      }
+      Dpms_Watch * watch = calloc(1, sizeof(Dpms_Watch));
+      watch->connector = g_strdup(connector);
+      watch->fd = fd;
+      read_dpms_watch_asleep(watch, NULL);     // notification requires an initial read
+      struct epoll_event evt = {.events = EPOLLPRI|EPOLLERR, .data.fd = fd};
+      if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &evt) < 0) {
+         free_dpms_watch(watch);
+         continue;
+      }
+      g_ptr_array_add(watches, watch);
+      added = true;
+   }
+   return added;
+}
+
+
+/** Watch thread function for #Watch_Mode_Simple_Udev.
+ *
+ *  The thread waits in a single epoll_wait() on:
+ *  - the udev monitor, for DRM connector changes
+ *  - a one shot timerfd, for the deadline at which connector names
+ *    are reread to determine whether they have stabilized
+ *  - a periodic timerfd, only armed if DPMS state changes are watched,
+ *    for rechecking DPMS state
+ *  - a periodic timerfd for checking that the client process still exists
+ *  - if #ddc_dpms_event_detection is set, the sysfs dpms attribute of each
+ *    connector having a display.  Once a connector's driver has signalled
+ *    an actual change of the attribute using POLLPRI, its DPMS state is no
+ *    longer read on a timer.  If all connectors signal, the timer is slowed
+ *    to a fallback interval, at which all connectors are read in case a
+ *    notification is missed.  DRM uevents also trigger a DPMS recheck.
+ *  - the eventfd signalled by #ddc_stop_watch_displays()
+ *
+ *  so it uses no CPU between events and terminates as soon as stop is requested.
+ */
 gpointer ddc_watch_displays_using_udev(gpointer data) {
    bool debug = false;
    Watch_Displays_Data * wdd = data;
@@ -943,12 +1210,10 @@ gpointer ddc_watch_displays_using_udev(gpointer data) {
    // udev_monitor_filter_add_match_subsystem_devtype(mon,  "i2c-dev", NULL);  // does not detect
    //udev_monitor_filter_add_match_subsystem_devtype(mon,  "i2c", NULL); // does not detect
    udev_monitor_enable_receiving(mon);
+   // the monitor socket is non-blocking, udev_monitor_receive_device() returns NULL when drained
+   int mon_fd = udev_monitor_get_fd(mon);
 
-   // make udev_monitor_receive_device() blocking
-   // int fd = udev_monitor_get_fd(mon);
-   // set_fd_blocking(fd);
-
-  Sysfs_Connector_Names current_connector_names = get_sysfs_drm_connector_names();
+  Sysfs_Connector_Names current_connector_names = get_sysfs_drm_connector_names(/*force_rescan=*/false);
   DBGTRC_NOPREFIX(debug, TRACE_GROUP,
         "Initial existing connectors: %s", join_string_g_ptr_array_t(current_connector_names.all_connectors, ", ") );
   DBGTRC_NOPREFIX(debug, TRACE_GROUP,
@@ -957,101 +1222,253 @@ gpointer ddc_watch_displays_using_udev(gpointer data) {
   GArray * deferred_events = g_array_new( false,      // zero_terminated
                                           false,      // clear
                                           sizeof(DDCA_Display_Status_Event));
-   struct udev_device * dev = NULL;
-   while (true) {
-      if (wdd->event_classes & DDCA_EVENT_CLASS_DISPLAY_CONNECTION) {
-         dev = udev_monitor_receive_device(mon);
+
+   // generation numbers of connectors having an EDID, see ddc_check_replaced_displays()
+   GHashTable * connector_generations = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+   bool watch_connections = wdd->event_classes & DDCA_EVENT_CLASS_DISPLAY_CONNECTION;
+   if (watch_connections)
+      ddc_check_replaced_displays(current_connector_names.connectors_having_edid,
+                                  connector_generations, deferred_events);
+
+   // Connector names read after a uevent, waiting to be confirmed unchanged
+   // when stabilize_fd expires
+   Sysfs_Connector_Names pending_connector_names = {0};
+   bool stabilizing = false;
+   int  stabilize_ct = 0;
+
+   int dpms_recheck_millisec = 2000;
+   if (ddc_slow_watch)
+      dpms_recheck_millisec *= 3;
+   int dpms_fallback_millisec = 15 * dpms_recheck_millisec;
+   bool dpms_fallback = false;     // all connectors signal, timer at fallback interval
+
+   int liveness_check_millisec = 2000;
+
+   int dpms_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK|TFD_CLOEXEC);
+   int stabilize_fd  = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK|TFD_CLOEXEC);
+   int liveness_fd   = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK|TFD_CLOEXEC);
+   int epoll_fd      = epoll_create1(EPOLL_CLOEXEC);
+   bool watch_dpms   = wdd->event_classes & DDCA_EVENT_CLASS_DPMS;
+   GPtrArray * dpms_watches = g_ptr_array_new_with_free_func(free_dpms_watch);
+   bool ok = dpms_timer_fd >= 0 && stabilize_fd >= 0 && liveness_fd >= 0 && epoll_fd >= 0;
+   ok = ok && add_epoll_fd(epoll_fd, wdd->stop_fd);
+   ok = ok && add_epoll_fd(epoll_fd, stabilize_fd);
+   ok = ok && add_epoll_fd(epoll_fd, dpms_timer_fd);
+   ok = ok && add_epoll_fd(epoll_fd, liveness_fd);
+   if (ok && watch_connections)
+      ok = add_epoll_fd(epoll_fd, mon_fd);
+   if (!ok) {
+      SYSLOG2(DDCA_SYSLOG_ERROR, "(%s) Unable to initialize watch thread: %s", __func__, strerror(errno));
+      goto bye;
+   }
+   // the client is checked independently of whether DPMS rechecks are armed
+   if (!arm_timer(liveness_fd, liveness_check_millisec, /*periodic*/ true))
+      goto bye;
+   if (watch_dpms) {
+      if (ddc_dpms_event_detection)
+         update_dpms_watches(dpms_watches, current_connector_names.connectors_having_edid, epoll_fd);
+      if (!arm_timer(dpms_timer_fd, dpms_recheck_millisec, /*periodic*/ true))
+         goto bye;
+   }
+
+   bool terminate = false;
+   while (!terminate) {
+      struct epoll_event ready[16];
+      int ready_ct = epoll_wait(epoll_fd, ready, 16, -1);
+      if (ready_ct < 0) {
+         if (errno == EINTR)
+            continue;
+         SYSLOG2(DDCA_SYSLOG_ERROR, "(%s) epoll_wait() failed: %s", __func__, strerror(errno));
+         break;
       }
-      while ( !dev ) {
-         int sleep_secs = 2;   // default sleep time on each loop
-         if (ddc_slow_watch)
-            sleep_secs *= 3;
-         if (debug)
-            DBGTRC_NOPREFIX(true, DDCA_TRC_NONE, "Sleeping for %d seconds", sleep_secs);
-         const int max_sleep_microsec = sleep_secs * 1000000;
-         const int sleep_step_microsec = MIN(200000, max_sleep_microsec);     // .2 sec
-         int slept = 0;
-         for (; slept < max_sleep_microsec && !terminate_watch_thread; slept += sleep_step_microsec)
-            usleep(sleep_step_microsec);
-
-         if (deferred_events->len > 0) {
-            if (deferred_events->len > 1) {  // FUTURE ENHANCMENT, filter out meaningless events
-               // check for cancellation events
-               for (int ndx = 0; ndx < deferred_events->len; ndx++) {
-                  DDCA_Display_Status_Event evt = g_array_index(deferred_events, DDCA_Display_Status_Event, ndx);
-                  DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Event %d in queue: %s", ndx, display_status_event_repr_t(evt));
+
+      for (int ndx = 0; ndx < ready_ct && !terminate; ndx++) {
+         int fd = ready[ndx].data.fd;
+         Dpms_Watch * dpms_watch = NULL;
+
+         if (fd == wdd->stop_fd) {
+            DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Stop requested");
+            terminate = true;
+         }
+
+         else if (fd == mon_fd) {
+            bool event_received = false;
+            struct udev_device * dev = NULL;
+            while ( (dev = udev_monitor_receive_device(mon)) ) {
+               DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "udev event received");
+               if (debug) {
+                  printf("Got Device\n");
+                  dbgrpt_udev_device(dev, 2);
                }
-               filter_sleep_events(deferred_events);
+               DBGTRC_NOPREFIX(debug, TRACE_GROUP,"ACTION: %s, CONNECTOR: %s, DEVNAME: %s, HOTPLUG: %s, sysname: %s",
+                     udev_device_get_property_value(dev, "ACTION"),
+                     udev_device_get_property_value(dev, "CONNECTOR"),
+                     udev_device_get_property_value(dev, "DEVNAME"),
+                     udev_device_get_property_value(dev, "HOTPLUG"),     // "1"
+                     udev_device_get_sysname(dev));
+               udev_device_unref(dev);
+               event_received = true;
             }
-            DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Emitting %d deferred events", deferred_events->len);
-            for (int ndx = 0; ndx < deferred_events->len; ndx++) {
-               DDCA_Display_Status_Event evt = g_array_index(deferred_events, DDCA_Display_Status_Event, ndx);
-               DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Emitting deferred event %s", display_status_event_repr_t(evt));
-               ddc_emit_display_status_record(evt);
+
+            if (event_received)
+               i2c_sysfs_invalidate_drm_connectors();
+
+            // If already stabilizing, the names are reread when stabilize_fd expires
+            if (event_received && !stabilizing) {
+               Sysfs_Connector_Names latest = get_sysfs_drm_connector_names(/*force_rescan=*/false);
+               if (sysfs_connector_names_equal(current_connector_names, latest)) {
+                  free_sysfs_connector_names_contents(latest);
+                  if (ddc_check_replaced_displays(current_connector_names.connectors_having_edid,
+                                                  connector_generations, deferred_events))
+                     emit_deferred_events(deferred_events);
+               }
+               else {
+                  int delay_millisec = 1000;
+                  // Special handling for case of apparently disconnected displays.
+                  // It has been observed that in some cases (Samsung U32H750) a disconnect
+                  // is followed a few seconds later by a connect. Wait a few seconds to
+                  // avoid triggering events in this case.
+                  if (extra_stabilize_seconds > 0 &&
+                      some_displays_disconnected(current_connector_names, latest))
+                  {
+                     char * s = g_strdup_printf(
+                           "Delaying %d seconds to avoid a false disconnect/connect sequence...", extra_stabilize_seconds);
+                     DBGTRC_NOPREFIX(debug, TRACE_GROUP, "%s", s);
+                     SYSLOG2(DDCA_SYSLOG_NOTICE, "%s", s);
+                     free(s);
+                     delay_millisec += extra_stabilize_seconds * 1000;
+                  }
+                  pending_connector_names = latest;
+                  stabilizing = true;
+                  stabilize_ct = 0;
+                  if (!arm_timer(stabilize_fd, delay_millisec, /*periodic*/ false)) {
+                     // without the timer the names would never be confirmed,
+                     // the change is picked up on the next uevent
+                     free_sysfs_connector_names_contents(pending_connector_names);
+                     pending_connector_names = (Sysfs_Connector_Names) {0};
+                     stabilizing = false;
+                  }
+               }
+            }
+            // DPMS changes may be reported by a DRM uevent
+            if (event_received && watch_dpms && ddc_dpms_event_detection) {
+               ddc_check_asleep(current_connector_names.connectors_having_edid,
+                                sleepy_connectors, deferred_events, NULL);
+               emit_deferred_events(deferred_events);
             }
-            g_array_remove_range(deferred_events,0, deferred_events->len);
+            DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "udev events processed");
          }
 
-         if (terminate_watch_thread) {
-            DBGTRC_DONE(debug, TRACE_GROUP, "Terminating thread.  Final polling sleep was %d millisec.", slept/1000);
-            free_watch_displays_data(wdd);
-            free_sysfs_connector_names_contents(current_connector_names);
-            g_thread_exit(0);
-            assert(false);    // avoid clang warning re wdd use after free
+         else if (fd == stabilize_fd) {
+            drain_timer(stabilize_fd);
+            assert(stabilizing);
+            // the names can change without a further uevent
+            Sysfs_Connector_Names latest = get_sysfs_drm_connector_names(/*force_rescan=*/true);
+            stabilize_ct++;
+            bool stable = sysfs_connector_names_equal(pending_connector_names, latest);
+            free_sysfs_connector_names_contents(pending_connector_names);
+            pending_connector_names = (Sysfs_Connector_Names) {0};
+            if (stable) {
+               stabilizing = false;
+               if (stabilize_ct > 1) {
+                  DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Required %d extra calls to get_sysfs_drm_connector_names()", stabilize_ct-1);
+                  SYSLOG2(DDCA_SYSLOG_NOTICE, "Connector names stabilization required %d extra calls to get_sysfs_drm_connector_names()", stabilize_ct-1);
+               }
+               current_connector_names = ddc_check_displays(current_connector_names, latest, deferred_events);
+               ddc_check_replaced_displays(current_connector_names.connectors_having_edid,
+                                           connector_generations, deferred_events);
+               emit_deferred_events(deferred_events);
+               if (watch_dpms && ddc_dpms_event_detection) {
+                  // newly connected displays need to be read until they signal
+                  if (update_dpms_watches(dpms_watches, current_connector_names.connectors_having_edid, epoll_fd)) {
+                     arm_timer(dpms_timer_fd, dpms_recheck_millisec, /*periodic*/ true);
+                     dpms_fallback = false;
+                  }
+               }
+            }
+            else {
+               pending_connector_names = latest;
+               if (!arm_timer(stabilize_fd, 1000, /*periodic*/ false)) {
+                  free_sysfs_connector_names_contents(pending_connector_names);
+                  pending_connector_names = (Sysfs_Connector_Names) {0};
+                  stabilizing = false;
+               }
+            }
          }
 
-         if (wdd->event_classes & DDCA_EVENT_CLASS_DPMS)
-            ddc_check_asleep(current_connector_names.connectors_having_edid, sleepy_connectors, deferred_events);
-
-         // Doesn't work to detect client crash, main thread and process remains for some time.
-         // 11/2020: is this even needed since terminate_watch_thread check added?
-         // #ifdef DOESNT_WORK
-         bool pid_found = check_thread_or_process(cur_pid);
-         if (!pid_found) {
-            DBGMSG("Process %d not found", cur_pid);
-         }
-         bool tid_found = check_thread_or_process(cur_tid);
-         if (!pid_found || !tid_found) {
-            DBGMSG("Thread %d not found", cur_tid);
-            g_thread_exit(GINT_TO_POINTER(-1));
-            break;
+         else if ( (dpms_watch = find_dpms_watch_by_fd(dpms_watches, fd)) ) {
+            // kernel called sysfs_notify() for the dpms attribute
+            bool changed = false;
+            bool is_dpms_asleep = read_dpms_watch_asleep(dpms_watch, &changed);
+            // a notification without a change does not show that changes are notified
+            if (changed && !dpms_watch->signalled) {
+               DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Connector %s signals DPMS changes", dpms_watch->connector);
+               dpms_watch->signalled = true;
+            }
+            ddc_note_dpms_state(dpms_watch->connector, is_dpms_asleep, sleepy_connectors, deferred_events);
+            emit_deferred_events(deferred_events);
          }
-         // #endif
-
-         if (wdd->event_classes & DDCA_EVENT_CLASS_DISPLAY_CONNECTION)
-            dev = udev_monitor_receive_device(mon);
-      }
 
-      DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "udev event received");
+         else if (fd == dpms_timer_fd) {
+            drain_timer(dpms_timer_fd);
+            // Events queued on the prior expiration are emitted now, so that
+            // an asleep/awake pair can be filtered out
+            emit_deferred_events(deferred_events);
+            GPtrArray * signalled = signalled_dpms_connectors(dpms_watches);
+            // at the fallback interval all connectors are read
+            ddc_check_asleep(current_connector_names.connectors_having_edid, sleepy_connectors, deferred_events,
+                             (dpms_fallback) ? NULL : signalled);
+            if (dpms_fallback)     // not held for the next, distant, expiration
+               emit_deferred_events(deferred_events);
+            // Once every display's driver signals DPMS changes, frequent timed reads
+            // are unnecessary.  A slow recheck remains in case a notification is missed.
+            if (ddc_dpms_event_detection && !dpms_fallback &&
+                signalled->len == current_connector_names.connectors_having_edid->len)
+            {
+               DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "All connectors signal DPMS changes, slowing timed rechecks");
+               dpms_fallback = arm_timer(dpms_timer_fd, dpms_fallback_millisec, /*periodic*/ true);
+            }
+            g_ptr_array_free(signalled, true);
+         }
 
-      if (debug) {
-         printf("Got Device\n");
-         dbgrpt_udev_device(dev, 2);
+         else if (fd == liveness_fd) {
+            drain_timer(liveness_fd);
+            // Doesn't work to detect client crash, main thread and process remains for some time.
+            bool pid_found = check_thread_or_process(cur_pid);
+            if (!pid_found) {
+               DBGMSG("Process %d not found", cur_pid);
+            }
+            bool tid_found = check_thread_or_process(cur_tid);
+            if (!pid_found || !tid_found) {
+               DBGMSG("Thread %d not found", cur_tid);
+               terminate = true;
+            }
+         }
       }
-
-      const char * prop_action    = udev_device_get_property_value(dev, "ACTION");
-      const char * prop_connector = udev_device_get_property_value(dev, "CONNECTOR");
-      const char * prop_devname   = udev_device_get_property_value(dev, "DEVNAME");
-      const char * prop_hotplug   = udev_device_get_property_value(dev, "HOTPLUG");
-      const char * attr_sysname   = udev_device_get_sysname(dev);
-
-      DBGTRC_NOPREFIX(debug, TRACE_GROUP,"ACTION: %s, CONNECTOR: %s, DEVNAME: %s, HOTPLUG: %s, sysname: %s",
-            prop_action,
-            prop_connector,
-            prop_devname,
-            prop_hotplug,     // "1"
-            attr_sysname);
-
-      current_connector_names = ddc_check_displays(current_connector_names, deferred_events);
-
-      udev_device_unref(dev);
-
-      DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "udev event processed");
-
-      // printf("."); fflush(stdout);
    }  // while
 
-    return NULL;
+   emit_deferred_events(deferred_events);
+
+bye:
+   if (epoll_fd >= 0)
+      close(epoll_fd);
+   if (stabilize_fd >= 0)
+      close(stabilize_fd);
+   if (liveness_fd >= 0)
+      close(liveness_fd);
+   if (dpms_timer_fd >= 0)
+      close(dpms_timer_fd);
+   g_ptr_array_free(dpms_watches, true);
+   free_sysfs_connector_names_contents(pending_connector_names);
+   free_sysfs_connector_names_contents(current_connector_names);
+   g_array_free(deferred_events, true);
+   g_hash_table_destroy(connector_generations);
+   g_ptr_array_free(sleepy_connectors, true);
+   udev_monitor_unref(mon);
+   udev_unref(udev);
+   DBGTRC_DONE(debug, TRACE_GROUP, "Terminating thread");
+   free_watch_displays_data(wdd);
+   return NULL;
 }
 #endif
 
@@ -1086,10 +1503,16 @@ ddc_start_watch_displays(DDCA_Display_Event_Class event_classes) {
    else if (watch_thread) {
       ddcrc = DDCRC_INVALID_OPERATION;
    }
+   else if ( (watch_stop_fd = eventfd(0, EFD_CLOEXEC|EFD_NONBLOCK)) < 0) {
+      ddcrc = -errno;
+      SYSLOG2(DDCA_SYSLOG_ERROR, "(%s) eventfd() failed: %s", __func__, strerror(errno));
+   }
    else {
-      terminate_watch_thread = false;
       Watch_Displays_Data * data = calloc(1, sizeof(Watch_Displays_Data));
       memcpy(data->marker, WATCH_DISPLAYS_DATA_MARKER, 4);
+      // The watch thread holds its own descriptor for the eventfd, so that
+      // either side can close its descriptor without waiting for the other.
+      data->stop_fd = dup(watch_stop_fd);
 #ifdef OLD_HOTPLUG_VERSION
    // data->display_change_handler = api_display_change_handler;
    // data->display_change_handler = dummy_display_change_handler;
@@ -1111,6 +1534,7 @@ ddc_start_watch_displays(DDCA_Display_Event_Class event_classes) {
 #endif
                        data);
       active_classes = event_classes;
+      i2c_watched_event_classes = event_classes;
       SYSLOG2(DDCA_SYSLOG_NOTICE, "Watch thread started");
    }
    g_mutex_unlock(&watch_thread_mutex);
@@ -1138,15 +1562,20 @@ ddc_stop_watch_displays(bool wait, DDCA_Display_Event_Class* enabled_classes_loc
    g_mutex_lock(&watch_thread_mutex);
 
    if (watch_thread) {
-      terminate_watch_thread = true;  // signal watch thread to terminate
-      // DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Waiting %d millisec for watch thread to terminate...", 4000);
-      // usleep(4000*1000);  // greater than the sleep in watch_displays_using_poll()
-      if (wait)
+      // signal watch thread to terminate, it wakes immediately
+      bool signalled = eventfd_write(watch_stop_fd, 1) == 0;
+      if (!signalled)
+         SYSLOG2(DDCA_SYSLOG_ERROR, "(%s) eventfd_write() failed: %s", __func__, strerror(errno));
+      close(watch_stop_fd);
+      watch_stop_fd = -1;
+      // if the thread was not signalled, waiting for it would hang
+      if (wait && signalled)
          g_thread_join(watch_thread);
 
       //  g_thread_unref(watch_thread);
       watch_thread = NULL;
       *enabled_classes_loc = active_classes;
+      i2c_watched_event_classes = DDCA_EVENT_CLASS_NONE;
       SYSLOG2(DDCA_SYSLOG_NOTICE, "Watch thread terminated.");
    }
    else {
@@ -1194,10 +1623,12 @@ void init_ddc_watch_displays() {
    RTTI_ADD_FUNC(ddc_watch_displays_using_poll);
 #ifdef ENABLE_UDEV
    RTTI_ADD_FUNC(ddc_check_asleep);
-   RTTI_ADD_FUNC(stabilized_connector_names);
+   RTTI_ADD_FUNC(ddc_note_dpms_state);
    RTTI_ADD_FUNC(ddc_check_displays);
+   RTTI_ADD_FUNC(ddc_check_replaced_displays);
    RTTI_ADD_FUNC(ddc_watch_displays_using_udev);
    RTTI_ADD_FUNC(ddc_hotplug_change_handler);
    RTTI_ADD_FUNC(filter_sleep_events);
+   RTTI_ADD_FUNC(emit_deferred_events);
 #endif
 }
@@ -28,6 +28,7 @@ extern DDC_Watch_Mode ddc_watch_mode;
 extern bool           ddc_slow_watch;
 #define DEFAULT_EXTRA_STABILIZE_SECS 6
 extern int            extra_stabilize_seconds;
+extern bool           ddc_dpms_event_detection;
 
 const char * ddc_watch_mode_name(DDC_Watch_Mode mode);
 DDCA_Status  ddc_start_watch_displays(DDCA_Display_Event_Class event_classes);
@@ -49,14 +49,18 @@
 
 #include "base/core.h"
 #include "base/ddc_errno.h"
+#include "base/execution_stats.h"
 #include "base/i2c_bus_base.h"
 #include "base/linux_errno.h"
+#include "base/lock_stats.h"
 #include "base/parms.h"
 #include "base/per_display_data.h"
 #include "base/rtti.h"
 #include "base/sleep.h"
 #include "base/status_code_mgt.h"
+#include "base/timeline.h"
 #include "base/tuned_sleep.h"
+#include "base/work_pool.h"
 
 #ifdef TARGET_BSD
 #include "bsd/i2c-dev.h"
@@ -82,6 +86,7 @@ int  i2c_businfo_async_threshold = DEFAULT_BUS_CHECK_ASYNC_THRESHOLD;
 bool cross_instance_locks_enabled = DEFAULT_ENABLE_FLOCK;
 int  flock_poll_millisec = DEFAULT_FLOCK_POLL_MILLISEC;
 int  flock_max_wait_millisec = DEFAULT_FLOCK_MAX_WAIT_MILLISEC;
+bool flock_blocking_wait = DEFAULT_FLOCK_BLOCKING_WAIT;
 
 
 void i2c_enable_cross_instance_locks(bool yesno) {
@@ -115,6 +120,421 @@ Byte_Value_Array get_i2c_devices_by_existence_test(bool include_ignorable_device
 static GMutex  open_failures_mutex;
 static Bit_Set_256 open_failures_reported;
 
+// When flock() was acquired for each bus, for lock hold time statistics.
+// Access is serialized by the display lock, or for an idle pooled handle
+// by handle_pool_mutex.
+static uint64_t flock_acquired_nanos[I2C_BUS_MAX+1];
+
+
+// Blocking wait for a cross-instance lock.
+//
+// flock() has no timeout, so the blocking call is made by a waiter thread
+// on a duplicate of the file descriptor.  Since the duplicate shares the
+// open file description, a lock it acquires is held by the original
+// descriptor.  Each bus has its own waiter thread, created on first use
+// and reused for subsequent waits, so that a wait on one bus never delays
+// a wait on another.  If a wait times out the request is abandoned.  The
+// caller then fails the open and closes its descriptor, so should the
+// waiter thread subsequently acquire the lock it is the only holder, and
+// it releases the lock.
+
+typedef struct {
+   int      fd;                // duplicate of the waiting thread's descriptor
+   bool     done;
+   bool     abandoned;
+   int      errsv;             // 0 if lock acquired, errno value otherwise
+   uint64_t acquired_nanos;
+} Flock_Wait_Request;
+
+typedef struct {
+   GQueue   pending;           // Flock_Wait_Request *, in order of arrival
+   bool     running;           // waiter thread exists
+} Flock_Waiter;
+
+static Flock_Waiter flock_waiters[I2C_BUS_MAX+1];
+static GMutex       flock_waiters_mutex;     // guards flock_waiters and all requests
+static GCond        flock_waiters_cond;      // request queued or completed
+static bool         flock_waiters_terminating = false;
+
+
+static void
+free_flock_wait_request(Flock_Wait_Request * req) {
+   close(req->fd);
+   free(req);
+}
+
+
+static gpointer
+flock_waiter_thread_func(gpointer data) {
+   Flock_Waiter * waiter = data;
+   g_mutex_lock(&flock_waiters_mutex);
+   while (true) {
+      while (g_queue_is_empty(&waiter->pending) && !flock_waiters_terminating)
+         g_cond_wait(&flock_waiters_cond, &flock_waiters_mutex);
+      Flock_Wait_Request * req = g_queue_pop_head(&waiter->pending);
+      if (!req)
+         break;                // terminating
+      if (req->abandoned) {
+         free_flock_wait_request(req);
+         continue;
+      }
+
+      g_mutex_unlock(&flock_waiters_mutex);
+      int rc = flock(req->fd, LOCK_EX);
+      int errsv = (rc == 0) ? 0 : errno;
+      uint64_t now = cur_realtime_nanosec();
+      g_mutex_lock(&flock_waiters_mutex);
+
+      if (req->abandoned) {
+         // the caller has closed its descriptor, the lock is held only by req->fd
+         if (rc == 0)
+            flock(req->fd, LOCK_UN);
+         free_flock_wait_request(req);
+      }
+      else {
+         req->done = true;
+         req->errsv = errsv;
+         req->acquired_nanos = now;
+         g_cond_broadcast(&flock_waiters_cond);
+      }
+   }
+   waiter->running = false;
+   g_mutex_unlock(&flock_waiters_mutex);
+   return NULL;
+}
+
+
+/** Waits for an exclusive flock() on an open /dev/i2c device without polling,
+ *  so the lock is acquired as soon as the previous holder releases it.
+ *
+ *  If the wait times out, the caller must close **fd** without using it.
+ *
+ *  @param  busno              bus number
+ *  @param  fd                 file descriptor
+ *  @param  max_wait_millisec  maximum wait time
+ *  @param  handoff_nanos_loc  where to return the time between the lock
+ *                             becoming available and this thread resuming
+ *  @retval 0                  lock acquired
+ *  @retval -EWOULDBLOCK       wait timed out
+ *  @retval other              negative errno
+ */
+static Status_Errno
+flock_blocking_wait_for_lock(
+      int        busno,
+      int        fd,
+      uint64_t   max_wait_millisec,
+      uint64_t * handoff_nanos_loc)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "busno=%d, fd=%d, max_wait_millisec=%"PRIu64,
+                                       busno, fd, max_wait_millisec);
+   assert(busno >= 0 && busno <= I2C_BUS_MAX);
+
+   Status_Errno result = 0;
+   *handoff_nanos_loc = 0;
+   Flock_Wait_Request * req = calloc(1, sizeof(Flock_Wait_Request));
+   req->fd = dup(fd);
+   if (req->fd < 0) {
+      result = -errno;
+      free(req);
+      goto bye;
+   }
+
+   gint64 end_time = g_get_monotonic_time() + (gint64) max_wait_millisec * G_TIME_SPAN_MILLISECOND;
+   g_mutex_lock(&flock_waiters_mutex);
+   Flock_Waiter * waiter = &flock_waiters[busno];
+   g_queue_push_tail(&waiter->pending, req);
+   if (!waiter->running) {
+      waiter->running = true;
+      g_thread_unref(g_thread_new("flock_waiter", flock_waiter_thread_func, waiter));
+   }
+   g_cond_broadcast(&flock_waiters_cond);
+   while (!req->done) {
+      if (!g_cond_wait_until(&flock_waiters_cond, &flock_waiters_mutex, end_time))
+         break;
+   }
+   if (req->done) {
+      result = -req->errsv;
+      if (result == 0)
+         *handoff_nanos_loc = cur_realtime_nanosec() - req->acquired_nanos;
+      free_flock_wait_request(req);
+   }
+   else {
+      // the waiter thread frees the request
+      req->abandoned = true;
+      result = -EWOULDBLOCK;
+   }
+   g_mutex_unlock(&flock_waiters_mutex);
+
+bye:
+   DBGTRC_RET_DDCRC(debug, TRACE_GROUP, result, "*handoff_nanos_loc=%"PRIu64, *handoff_nanos_loc);
+   return result;
+}
+
+
+/** Releases the cross-instance lock on an open /dev/i2c device.
+ *
+ *  @param  busno  bus number
+ *  @param  fd     file descriptor
+ */
+static void
+i2c_release_flock(int busno, int fd) {
+   bool debug = false;
+   if (cross_instance_locks_enabled) {
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Calling flock(%d,LOCK_UN)...", fd);
+      int rc = flock(fd, LOCK_UN);
+      if (busno >= 0 && busno <= I2C_BUS_MAX && flock_acquired_nanos[busno] > 0) {
+         lock_stats_record_hold(LOCK_STATS_FLOCK, cur_realtime_nanosec() - flock_acquired_nanos[busno]);
+         flock_acquired_nanos[busno] = 0;
+      }
+      if (rc < 0) {
+         int errsv = errno;
+         DBGTRC_NOPREFIX(true, TRACE_GROUP, "Unexpected error from flock(..,LOCK_UN): %s",
+               psc_desc(-errsv));
+      }
+   }
+}
+
+
+//
+// Handle pool
+//
+// When enabled, a /dev/i2c device opened with CALLOPT_POOLED is not closed
+// by i2c_close_bus().  The display lock is released, but the file descriptor,
+// and with it the flock(), is retained so that the next open of the bus skips
+// open(), flock() and the sysfs connection check.  A pooled handle is closed
+// when a hotplug or DPMS event is reported for its bus, when displays are
+// redetected, and when it has been idle for i2c_handle_pool_idle_millisec,
+// so that other processes can acquire the flock().
+//
+
+typedef struct {
+   int      idle_fd;            // handle available for reuse, -1 if none
+   int      in_use_fd;          // pooled handle currently open, -1 if none
+   bool     discard_in_use;     // invalidated while open, close instead of pooling
+   uint64_t released_nanos;     // when idle_fd was returned to the pool
+} I2C_Pool_Entry;
+
+bool i2c_handle_pool_enabled = DEFAULT_ENABLE_I2C_HANDLE_POOL;
+int  i2c_handle_pool_idle_millisec = DEFAULT_I2C_HANDLE_POOL_IDLE_MILLISEC;
+
+static I2C_Pool_Entry handle_pool[I2C_BUS_MAX+1];
+static GMutex    handle_pool_mutex;
+static GCond     handle_pool_cond;
+static GThread * handle_pool_reaper = NULL;
+static bool      handle_pool_terminating = false;
+
+static int handle_pool_reuse_ct      = 0;
+static int handle_pool_open_ct       = 0;
+static int handle_pool_expire_ct     = 0;
+static int handle_pool_invalidate_ct = 0;
+
+
+// caller holds handle_pool_mutex
+static void
+handle_pool_close_idle(int busno) {
+   I2C_Pool_Entry * entry = &handle_pool[busno];
+   if (entry->idle_fd >= 0) {
+      i2c_release_flock(busno, entry->idle_fd);
+      i2c_forget_slave_addr(entry->idle_fd);
+      RECORD_IO_EVENT(entry->idle_fd, IE_CLOSE, ( close(entry->idle_fd) ) );
+      entry->idle_fd = -1;
+   }
+}
+
+
+static gpointer
+handle_pool_reaper_func(gpointer data) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "");
+   g_mutex_lock(&handle_pool_mutex);
+   while (!handle_pool_terminating) {
+      uint64_t now = cur_realtime_nanosec();
+      uint64_t idle_nanos = (uint64_t) i2c_handle_pool_idle_millisec * (1000*1000);
+      uint64_t next_expiration = 0;
+      for (int busno = 0; busno <= I2C_BUS_MAX; busno++) {
+         I2C_Pool_Entry * entry = &handle_pool[busno];
+         if (entry->idle_fd < 0)
+            continue;
+         uint64_t expiration = entry->released_nanos + idle_nanos;
+         if (expiration <= now) {
+            DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Closing idle handle for /dev/i2c-%d", busno);
+            handle_pool_close_idle(busno);
+            handle_pool_expire_ct++;
+         }
+         else if (next_expiration == 0 || expiration < next_expiration) {
+            next_expiration = expiration;
+         }
+      }
+      if (next_expiration == 0)
+         g_cond_wait(&handle_pool_cond, &handle_pool_mutex);
+      else
+         g_cond_wait_until(&handle_pool_cond, &handle_pool_mutex,
+               g_get_monotonic_time() + (next_expiration - now) / 1000 + 1);
+   }
+   g_mutex_unlock(&handle_pool_mutex);
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+   return NULL;
+}
+
+
+/** Takes an idle pooled handle for a bus.
+ *
+ *  Called with the display lock for the bus held.  If the caller does not
+ *  want a pooled handle, an idle handle is closed so that its flock() does
+ *  not block the caller's own open.
+ *
+ *  @param  busno   bus number
+ *  @param  pooled  caller accepts a pooled handle
+ *  @return file descriptor, -1 if none available
+ */
+static int
+handle_pool_checkout(int busno, bool pooled) {
+   int fd = -1;
+   if (busno >= 0 && busno <= I2C_BUS_MAX) {
+      g_mutex_lock(&handle_pool_mutex);
+      I2C_Pool_Entry * entry = &handle_pool[busno];
+      if (entry->idle_fd >= 0) {
+         if (pooled) {
+            fd = entry->idle_fd;
+            entry->idle_fd = -1;
+            entry->in_use_fd = fd;
+            entry->discard_in_use = false;
+            handle_pool_reuse_ct++;
+         }
+         else {
+            handle_pool_close_idle(busno);
+         }
+      }
+      g_mutex_unlock(&handle_pool_mutex);
+   }
+   return fd;
+}
+
+
+// Records that a newly opened handle is to be retained on close
+static void
+handle_pool_note_opened(int busno, int fd) {
+   if (busno >= 0 && busno <= I2C_BUS_MAX) {
+      g_mutex_lock(&handle_pool_mutex);
+      handle_pool[busno].in_use_fd = fd;
+      handle_pool[busno].discard_in_use = false;
+      handle_pool_open_ct++;
+      g_mutex_unlock(&handle_pool_mutex);
+   }
+}
+
+
+/** Returns a handle to the pool instead of closing it.
+ *
+ *  Called with the display lock for the bus held.
+ *
+ *  @param  busno  bus number
+ *  @param  fd     file descriptor
+ *  @return true if the handle was retained, false if it must be closed
+ */
+static bool
+handle_pool_checkin(int busno, int fd) {
+   bool retained = false;
+   if (busno >= 0 && busno <= I2C_BUS_MAX) {
+      g_mutex_lock(&handle_pool_mutex);
+      I2C_Pool_Entry * entry = &handle_pool[busno];
+      if (entry->in_use_fd == fd) {
+         entry->in_use_fd = -1;
+         if (!entry->discard_in_use && i2c_handle_pool_enabled && !handle_pool_terminating &&
+             i2c_handle_pool_idle_millisec > 0)
+         {
+            assert(entry->idle_fd < 0);
+            entry->idle_fd = fd;
+            entry->released_nanos = cur_realtime_nanosec();
+            if (!handle_pool_reaper)
+               handle_pool_reaper = g_thread_new("i2c_handle_pool", handle_pool_reaper_func, NULL);
+            g_cond_signal(&handle_pool_cond);
+            retained = true;
+         }
+      }
+      g_mutex_unlock(&handle_pool_mutex);
+   }
+   return retained;
+}
+
+
+/** Closes pooled handles whose display state may have changed.
+ *
+ *  Idle handles are closed immediately.  A handle currently open is closed
+ *  instead of being returned to the pool.
+ *
+ *  @param  busno  bus number, -1 for all buses
+ */
+void i2c_handle_pool_invalidate(int busno) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "busno=%d", busno);
+   int first = (busno < 0) ? 0 : busno;
+   int last  = (busno < 0) ? I2C_BUS_MAX : busno;
+   if (last <= I2C_BUS_MAX) {
+      g_mutex_lock(&handle_pool_mutex);
+      for (int ndx = first; ndx <= last; ndx++) {
+         I2C_Pool_Entry * entry = &handle_pool[ndx];
+         if (entry->idle_fd >= 0) {
+            handle_pool_close_idle(ndx);
+            handle_pool_invalidate_ct++;
+         }
+         if (entry->in_use_fd >= 0)
+            entry->discard_in_use = true;
+      }
+      g_mutex_unlock(&handle_pool_mutex);
+   }
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
+/** Reports whether an idle, validated handle is pooled for a bus.
+ *
+ *  @param  busno  bus number
+ *  @return true/false
+ */
+bool i2c_handle_pool_contains(int busno) {
+   bool result = false;
+   if (i2c_handle_pool_enabled && busno >= 0 && busno <= I2C_BUS_MAX) {
+      g_mutex_lock(&handle_pool_mutex);
+      result = handle_pool[busno].idle_fd >= 0;
+      g_mutex_unlock(&handle_pool_mutex);
+   }
+   return result;
+}
+
+
+void i2c_enable_handle_pool(bool yesno) {
+   bool debug = false;
+   i2c_handle_pool_enabled = yesno;
+   if (!yesno)
+      i2c_handle_pool_invalidate(-1);
+   DBGTRC_EXECUTED(debug, TRACE_GROUP, "yesno = %s", SBOOL(yesno));
+}
+
+
+void i2c_report_handle_pool_stats(int depth) {
+   if (!i2c_handle_pool_enabled)
+      return;
+   g_mutex_lock(&handle_pool_mutex);
+   rpt_vstring(depth, "I2C handle pool (idle timeout %d ms):", i2c_handle_pool_idle_millisec);
+   rpt_vstring(depth+1, "Opens using pooled handle:   %6d", handle_pool_reuse_ct);
+   rpt_vstring(depth+1, "Opens of new pooled handle:  %6d", handle_pool_open_ct);
+   rpt_vstring(depth+1, "Handles closed when idle:    %6d", handle_pool_expire_ct);
+   rpt_vstring(depth+1, "Handles closed by events:    %6d", handle_pool_invalidate_ct);
+   g_mutex_unlock(&handle_pool_mutex);
+}
+
+
+void i2c_reset_handle_pool_stats() {
+   g_mutex_lock(&handle_pool_mutex);
+   handle_pool_reuse_ct      = 0;
+   handle_pool_open_ct       = 0;
+   handle_pool_expire_ct     = 0;
+   handle_pool_invalidate_ct = 0;
+   g_mutex_unlock(&handle_pool_mutex);
+}
+
 
 /** Adds a set of bus numbers to the set of bus numbers
  *  whose open failure has already been reported.
@@ -164,12 +584,23 @@ Error_Info * i2c_open_bus(int busno, Byte callopts, int* fd_loc) {
    DDCA_IO_Path dpath;
    dpath.io_mode = DDCA_IO_I2C;
    dpath.path.i2c_busno = busno;
+   bool pooled = i2c_handle_pool_enabled &&
+                 (callopts & CALLOPT_POOLED) && !(callopts & CALLOPT_RDONLY);
+   bool reused = false;
+   int fd = -1;
    master_error = lock_display_by_dpath(dpath, ddisp_flags);
    if (master_error) {
       goto bye;
    }
 
-   int fd = -1;
+   fd = handle_pool_checkout(busno, pooled);
+   if (fd >= 0) {
+      // pooled handle already holds the flock()
+      DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Using pooled handle, fd=%d", fd);
+      reused = true;
+      goto bye;
+   }
+
    snprintf(filename, 19, "/dev/"I2C"-%d", busno);
    RECORD_IO_EVENT(
          -1,
@@ -186,6 +617,7 @@ Error_Info * i2c_open_bus(int busno, Byte callopts, int* fd_loc) {
       assert(!err);    // avoid coverity warning
       goto bye;
    }
+   i2c_forget_slave_addr(fd);   // descriptor number may have been used before
 
    if (cross_instance_locks_enabled) {
       int operation = LOCK_EX|LOCK_NB;
@@ -196,12 +628,18 @@ Error_Info * i2c_open_bus(int busno, Byte callopts, int* fd_loc) {
             flock_poll_millisec, flock_max_wait_millisec, max_wait_millisec);
       Status_Errno lockrc = 0;
       int flock_call_ct = 0;
+      uint64_t flock_start = cur_realtime_nanosec();
+      uint64_t prev_attempt_nanos = 0;
       while(true) {
          DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Calling flock(%d,0x%04x)...", fd, operation);
          flock_call_ct++;
          int flockrc = flock(fd, operation);
          if (flockrc == 0)  {
             DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "flock succeeded");
+            // when polling, the lock was released at some point since the
+            // previous attempt, so this is an upper bound
+            if (prev_attempt_nanos > 0)
+               lock_stats_record_handoff(LOCK_STATS_FLOCK, cur_realtime_nanosec() - prev_attempt_nanos);
 #ifdef EXPLORING
             int inode = get_inode_by_fd(fd);
             intmax_t pid = get_process_id();
@@ -239,7 +677,24 @@ Error_Info * i2c_open_bus(int busno, Byte callopts, int* fd_loc) {
            if (now < max_nanos) {
               // DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Resource locked. Sleeping");
               if (flock_call_ct == 1)
-                 MSG_W_SYSLOG(DDCA_SYSLOG_NOTICE, "%s locked.  Retrying...", filename);
+                 MSG_W_SYSLOG(DDCA_SYSLOG_NOTICE, "%s locked.  %s...", filename,
+                              (flock_blocking_wait) ? "Waiting" : "Retrying");
+              if (flock_blocking_wait && busno >= 0 && busno <= I2C_BUS_MAX) {
+                 uint64_t handoff_nanos;
+                 lockrc = flock_blocking_wait_for_lock(busno, fd, (max_nanos - now) / (1000*1000), &handoff_nanos);
+                 if (lockrc == 0) {
+                    lock_stats_record_handoff(LOCK_STATS_FLOCK, handoff_nanos);
+                    break;
+                 }
+                 if (lockrc == -EWOULDBLOCK) {
+                    // Do not try again on fd.  The abandoned wait may still
+                    // acquire the lock, and would then release it.
+                    MSG_W_SYSLOG(DDCA_SYSLOG_WARNING, "Max wait exceeded for %s", filename);
+                    lockrc = DDCRC_FLOCKED;
+                 }
+                 break;
+              }
+              prev_attempt_nanos = now;
               usleep(poll_microsec);
               continue;
            }
@@ -290,6 +745,11 @@ Error_Info * i2c_open_bus(int busno, Byte callopts, int* fd_loc) {
             break;
         }
      }
+      uint64_t flock_end = cur_realtime_nanosec();
+      const char * waiter = optime_current_operation_name();
+      lock_stats_record_wait(LOCK_STATS_FLOCK, (waiter) ? waiter : "other", flock_end - flock_start);
+      if (lockrc == 0 && busno >= 0 && busno <= I2C_BUS_MAX)
+         flock_acquired_nanos[busno] = flock_end;
       if (lockrc != 0) {
          DBGTRC_NOPREFIX(true, TRACE_GROUP, "Cross instance locking failed");
          close(fd);
@@ -304,6 +764,8 @@ bye:
    }
    else {
       *fd_loc = fd;
+      if (pooled && !reused)
+         handle_pool_note_opened(busno, fd);
       // DBGTRC_DONE(debug, TRACE_GROUP, "busno=%d, Returning file descriptor: %d", busno, fd);
    }
 
@@ -331,14 +793,12 @@ Status_Errno i2c_close_bus(int busno, int fd, Call_Options callopts) {
    Status_Errno result = 0;
    int rc = 0;
 
-   if (cross_instance_locks_enabled) {
-      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Calling flock(%d,LOCK_UN)...", fd);
-      int rc = flock(fd, LOCK_UN);
-      if (rc < 0) {
-         int errsv = errno;
-         DBGTRC_NOPREFIX(true, TRACE_GROUP, "Unexpected error from flock(..,LOCK_UN): %s",
-               psc_desc(-errsv));
-      }
+   bool retained = handle_pool_checkin(busno, fd);
+   if (retained) {
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Handle retained in pool");
+   }
+   else {
+      i2c_release_flock(busno, fd);
    }
    DDCA_IO_Path dpath;
    dpath.io_mode = DDCA_IO_I2C;
@@ -353,17 +813,20 @@ Status_Errno i2c_close_bus(int busno, int fd, Call_Options callopts) {
       errinfo_free(erec);
    }
 
-   RECORD_IO_EVENT(fd, IE_CLOSE, ( rc = close(fd) ) );
-   assert( rc == 0 || rc == -1);   // per documentation
-   int errsv = errno;
-   if (rc < 0) {
-      // EBADF (9)  fd isn't a valid open file descriptor
-      // EINTR (4)  close() interrupted by a signal
-      // EIO   (5)  I/O error
-      if (callopts & CALLOPT_ERR_MSG)
-         f0printf(ferr(), "Close failed for %s, errno=%s\n",
-                          filename_for_fd_t(fd), linux_errno_desc(errsv));
-      result = -errsv;
+   if (!retained) {
+      i2c_forget_slave_addr(fd);
+      RECORD_IO_EVENT(fd, IE_CLOSE, ( rc = close(fd) ) );
+      assert( rc == 0 || rc == -1);   // per documentation
+      int errsv = errno;
+      if (rc < 0) {
+         // EBADF (9)  fd isn't a valid open file descriptor
+         // EINTR (4)  close() interrupted by a signal
+         // EIO   (5)  I/O error
+         if (callopts & CALLOPT_ERR_MSG)
+            f0printf(ferr(), "Close failed for %s, errno=%s\n",
+                             filename_for_fd_t(fd), linux_errno_desc(errsv));
+         result = -errsv;
+      }
    }
    assert(result <= 0);
    DBGTRC_RET_DDCRC(debug, TRACE_GROUP, result, "fd=%d",fd);
@@ -537,6 +1000,8 @@ Error_Info * i2c_check_open_bus_alive(Display_Handle * dh) {
          result = ERRINFO_NEW(DDCRC_DPMS_ASLEEP,
                "/dev/i2c-%d", dh->dref->io_path.path.i2c_busno);
    }
+   if (result)
+      i2c_handle_pool_invalidate(businfo->busno);
    DBGTRC_RET_ERRINFO(debug, TRACE_GROUP, result, "");
    return result;
 }
@@ -595,6 +1060,75 @@ i2c_detect_x37(int fd) {
 }
 
 
+//
+// EDID read statistics, by source
+//
+
+// EDIDs taken from the connector scan are counted separately, since no
+// read occurs at the time; the cost is part of the connector scan.
+typedef enum {
+   EDID_READ_SYSFS_SCAN,
+   EDID_READ_SYSFS,
+   EDID_READ_I2C,
+   EDID_READ_SOURCE_CT
+} Edid_Read_Source;
+
+typedef struct {
+   int      read_ct;
+   int      found_ct;
+   uint64_t total_nanos;
+   uint64_t max_nanos;
+} Edid_Read_Stats;
+
+static GMutex          edid_read_stats_mutex;
+static Edid_Read_Stats edid_read_stats[EDID_READ_SOURCE_CT];
+
+
+static void
+record_edid_read(Edid_Read_Source source, bool found, uint64_t nanos) {
+   g_mutex_lock(&edid_read_stats_mutex);
+   Edid_Read_Stats * stats = &edid_read_stats[source];
+   stats->read_ct++;
+   if (found)
+      stats->found_ct++;
+   stats->total_nanos += nanos;
+   if (nanos > stats->max_nanos)
+      stats->max_nanos = nanos;
+   g_mutex_unlock(&edid_read_stats_mutex);
+}
+
+
+/** Reports the number and duration of EDID reads during bus inspection,
+ *  by source.  Source "scan" is an EDID taken from the most recent
+ *  /sys/class/drm connector scan, whose time covers only the lookup,
+ *  "sysfs" is a read of the connector's edid attribute.
+ *
+ *  @param depth  logical indentation depth
+ */
+void i2c_report_edid_read_stats(int depth) {
+   static const char * source_names[EDID_READ_SOURCE_CT] = {"scan", "sysfs", "I2C"};
+   g_mutex_lock(&edid_read_stats_mutex);
+   rpt_vstring(depth, "EDID reads during bus inspection:");
+   for (int ndx = 0; ndx < EDID_READ_SOURCE_CT; ndx++) {
+      Edid_Read_Stats * stats = &edid_read_stats[ndx];
+      rpt_vstring(depth+1,
+            "%-6s reads: %4d, found: %4d, total: %8.3f ms, average: %7.3f ms, max: %7.3f ms",
+            source_names[ndx], stats->read_ct, stats->found_ct,
+            stats->total_nanos / 1e6,
+            (stats->read_ct > 0) ? (stats->total_nanos / 1e6) / stats->read_ct : 0.0,
+            stats->max_nanos / 1e6);
+   }
+   g_mutex_unlock(&edid_read_stats_mutex);
+}
+
+
+void i2c_reset_edid_read_stats() {
+   g_mutex_lock(&edid_read_stats_mutex);
+   memset(edid_read_stats, 0, sizeof(edid_read_stats));
+   g_mutex_unlock(&edid_read_stats_mutex);
+}
+
+
 /** Inspects an I2C bus.
  *
  *  Takes the number of the bus to be inspected from the #I2C_Bus_Info struct passed
@@ -628,13 +1162,15 @@ void i2c_check_bus(I2C_Bus_Info * bus_info) {
          if (!force_read_edid) {
             DBGTRC_NOPREFIX(debug, TRACE_GROUP,
                           "Getting edid from sysfs for connector %s", bus_info->drm_connector_name);
-            GByteArray*  edid_bytes = NULL;
-            // int d = IS_DBGTRC(debug, TRACE_GROUP) ? 1 : -1;
-            int d = -1;
-            RPT_ATTR_EDID(d, &edid_bytes, "/sys/class/drm", bus_info->drm_connector_name, "edid");
-            if (edid_bytes && edid_bytes->len >= 128) {
+            Byte edid_bytes[128];
+            uint64_t start_nanos = cur_realtime_nanosec();
+            bool from_scan = false;
+            bool found = get_sysfs_drm_edid(bus_info->drm_connector_name, edid_bytes, &from_scan);
+            record_edid_read((from_scan) ? EDID_READ_SYSFS_SCAN : EDID_READ_SYSFS,
+                             found, cur_realtime_nanosec() - start_nanos);
+            if (found) {
                DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Got edid from sysfs");
-               bus_info->edid = create_parsed_edid2(edid_bytes->data, "SYSFS");
+               bus_info->edid = create_parsed_edid2(edid_bytes, "SYSFS");
                if (debug) {
                   if (bus_info->edid)
                      report_parsed_edid(bus_info->edid, false /* verbose */, 0);
@@ -647,8 +1183,6 @@ void i2c_check_bus(I2C_Bus_Info * bus_info) {
                   // memcpy(bus_info->edid->edid_source, "SYSFS", 6); // redundant
                }
             }
-            if (edid_bytes)
-               g_byte_array_free(edid_bytes,true);
          }
       }
 
@@ -671,7 +1205,9 @@ void i2c_check_bus(I2C_Bus_Info * bus_info) {
 #endif
 
           if (!bus_info->edid) {
+             uint64_t start_nanos = cur_realtime_nanosec();
              DDCA_Status ddcrc = i2c_get_parsed_edid_by_fd(fd, &bus_info->edid);
+             record_edid_read(EDID_READ_I2C, ddcrc == 0, cur_realtime_nanosec() - start_nanos);
 #ifdef TEST
              if (!result) {
                 if (bus_info->busno == 6 || bus_info->busno == 8) {
@@ -761,7 +1297,7 @@ void i2c_check_bus(I2C_Bus_Info * bus_info) {
 }
 
 
-STATIC void *
+STATIC void
 threaded_initial_checks_by_businfo(gpointer data) {
    bool debug = false;
 
@@ -770,43 +1306,39 @@ threaded_initial_checks_by_businfo(gpointer data) {
    DBGTRC_STARTING(debug, TRACE_GROUP, "bus = /dev/i2c-%d", businfo->busno );
 
    i2c_check_bus(businfo);
-   // g_thread_exit(NULL);
-   DBGTRC_DONE(debug, TRACE_GROUP, "Returning NULL. bus=/dev/i2c-%d", businfo->busno );
-   return NULL;
+   DBGTRC_DONE(debug, TRACE_GROUP, "bus=/dev/i2c-%d", businfo->busno );
 }
 
 
-/** Spawns threads to perform initial checks and waits for them all to complete.
+/** Performs initial checks using the shared worker pool and waits for
+ *  them all to complete.
  *
- *  @param all_displays #GPtrArray of pointers to #I2c_Bus_Info
+ *  @param i2c_buses   #GPtrArray of pointers to #I2C_Bus_Info
+ *  @param func        if non-NULL, called in the current thread for each
+ *                     bus as soon as its checks complete
+ *  @param func_data   passed to **func**
  */
 STATIC void
-i2c_async_scan(GPtrArray * i2c_buses) {
+i2c_async_scan(GPtrArray * i2c_buses, I2C_Bus_Checked_Func func, gpointer func_data) {
    bool debug = false;
    DBGTRC_STARTING(debug, TRACE_GROUP, "i2c_buses=%p, bus count=%d",
                                        i2c_buses, i2c_buses->len);
 
-   GPtrArray * threads = g_ptr_array_new();
+   Work_Batch * batch = work_batch_new("i2c_async_scan", threaded_initial_checks_by_businfo);
    for (int ndx = 0; ndx < i2c_buses->len; ndx++) {
       I2C_Bus_Info * businfo = g_ptr_array_index(i2c_buses, ndx);
       TRACED_ASSERT( memcmp(businfo->marker, I2C_BUS_INFO_MARKER, 4) == 0 );
-
-      char buf[16];
-      g_snprintf(buf, 16, "/dev/i2c-%d", businfo->busno);
-      GThread * th =
-      g_thread_new(
-            buf,                // thread name
-            threaded_initial_checks_by_businfo,
-            businfo);                            // pass pointer to display ref as data
-      g_ptr_array_add(threads, th);
+      work_batch_add(batch, businfo);
    }
-   DBGMSF(debug, "Started %d threads", threads->len);
-   for (int ndx = 0; ndx < threads->len; ndx++) {
-      GThread * thread = g_ptr_array_index(threads, ndx);
-      g_thread_join(thread);  // implicitly unrefs the GThread
+   DBGMSF(debug, "Queued %d buses", i2c_buses->len);
+   I2C_Bus_Info * businfo = NULL;
+   while ( (businfo = work_batch_next_completed(batch)) ) {
+      DBGTRC_NOPREFIX(debug, TRACE_GROUP, "Checks complete for /dev/i2c-%d, flags=%s",
+            businfo->busno, i2c_interpret_bus_flags_t(businfo->flags));
+      if (func)
+         func(businfo, func_data);
    }
-   DBGMSF(debug, "Threads joined");
-   g_ptr_array_free(threads, true);
+   work_batch_free(batch);
 
    DBGTRC_DONE(debug, TRACE_GROUP, "");
 }
@@ -814,10 +1346,12 @@ i2c_async_scan(GPtrArray * i2c_buses) {
 
 /** Loops through a list of I2C_Bus_Info, performing initial checks on each.
  *
- *  @param i2c_buses #GPtrArray of pointers to #I2C_Bus_Info
+ *  @param i2c_buses   #GPtrArray of pointers to #I2C_Bus_Info
+ *  @param func        if non-NULL, called for each bus once its checks complete
+ *  @param func_data   passed to **func**
  */
-void
-i2c_non_async_scan(GPtrArray * i2c_buses) {
+STATIC void
+i2c_non_async_scan(GPtrArray * i2c_buses, I2C_Bus_Checked_Func func, gpointer func_data) {
    bool debug = false;
    DBGTRC_STARTING(debug, TRACE_GROUP, "checking %d buses", i2c_buses->len);
 
@@ -825,6 +1359,8 @@ i2c_non_async_scan(GPtrArray * i2c_buses) {
       I2C_Bus_Info * businfo = g_ptr_array_index(i2c_buses, ndx);
       DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "Calling i2c_check_bus() synchronously for bus %d", businfo->busno);
       i2c_check_bus(businfo);
+      if (func)
+         func(businfo, func_data);
    }
    DBGTRC_DONE(debug, TRACE_GROUP, "");
 }
@@ -869,12 +1405,12 @@ void i2c_check_attached_buses() {
 #endif
 
 
-/** Detect all currently attached buses and checks each to see if a display
- *  is connected, i.e. if an EDID is present
+/** Detect all currently attached buses, without checking them.
  *
  *  @return  array of #I2C_Bus_Info for all attached buses
  */
-GPtrArray * i2c_detect_buses0() {
+static GPtrArray *
+new_bus_infos_for_attached_buses() {
    bool debug = false;
    DBGTRC_STARTING(debug, DDCA_TRC_I2C, "");
 
@@ -894,13 +1430,32 @@ GPtrArray * i2c_detect_buses0() {
    }
    bva_free(i2c_bus_bva);
 
+   DBGTRC_DONE(debug, DDCA_TRC_I2C,
+         "Returning: %p containing %d I2C_Bus_Info records", buses, buses->len);
+   return buses;
+}
+
+
+/** Checks each bus in an array to see if a display is connected,
+ *  i.e. if an EDID is present
+ *
+ *  @param   buses       array of #I2C_Bus_Info
+ *  @param   func        if non-NULL, called for each bus as soon as its
+ *                       checks complete, in order of completion
+ *  @param   func_data   passed to **func**
+ */
+static void
+check_buses(GPtrArray * buses, I2C_Bus_Checked_Func func, gpointer func_data) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, DDCA_TRC_I2C, "buses->len = %d", buses->len);
+
    DBGTRC_NOPREFIX(debug, DDCA_TRC_NONE, "buses->len = %d, i2c_businfo_async_threhold=%d",
          buses->len, i2c_businfo_async_threshold);
    if (buses->len < i2c_businfo_async_threshold) {
-      i2c_non_async_scan(buses);
+      i2c_non_async_scan(buses, func, func_data);
    }
    else {
-      i2c_async_scan(buses);
+      i2c_async_scan(buses, func, func_data);
    }
 
    if (debug) {
@@ -920,8 +1475,18 @@ GPtrArray * i2c_detect_buses0() {
       }
    }
 
-   DBGTRC_DONE(debug, DDCA_TRC_I2C,
-         "Returning: %p containing %d I2C_Bus_Info records", buses, buses->len);
+   DBGTRC_DONE(debug, DDCA_TRC_I2C, "");
+}
+
+
+/** Detect all currently attached buses and checks each to see if a display
+ *  is connected, i.e. if an EDID is present
+ *
+ *  @return  array of #I2C_Bus_Info for all attached buses
+ */
+GPtrArray * i2c_detect_buses0() {
+   GPtrArray * buses = new_bus_infos_for_attached_buses();
+   check_buses(buses, NULL, NULL);
    return buses;
 }
 
@@ -954,20 +1519,34 @@ Bit_Set_256 buses_bitset_from_businfo_array(GPtrArray * businfo_array, bool only
 }
 
 
-/** Detect buses if not already detected.
+/** Detect buses if not already detected, reporting each bus to a callback
+ *  as soon as its checks complete.  This allows the caller to start using
+ *  the buses checked first while others are still being checked.
  *
- *  Stores the result in global array all_i2c_buses and also
- *  the bitset connected_buses.
+ *  Stores the result in global array all_i2c_buses.
  *
+ *  @param  func       called in the current thread for each bus, in order of
+ *                     completion; if the buses were already detected, called
+ *                     for each in turn
+ *  @param  func_data  passed to **func**
  *  @return number of i2c buses
  */
-int i2c_detect_buses() {
+int i2c_detect_buses_with_callback(I2C_Bus_Checked_Func func, gpointer func_data) {
    bool debug = false;
    DBGTRC_STARTING(debug, DDCA_TRC_I2C, "all_i2c_buses = %p", all_i2c_buses);
 
    if (!all_i2c_buses) {
-      all_i2c_buses = i2c_detect_buses0();
+      uint64_t span_start = timeline_span_start();
+      // published before checking, since the callback may start using
+      // buses that have been checked while others are still being checked
+      all_i2c_buses = new_bus_infos_for_attached_buses();
       g_ptr_array_set_free_func(all_i2c_buses, (GDestroyNotify) i2c_free_bus_info);
+      check_buses(all_i2c_buses, func, func_data);
+      timeline_span_end("i2c_detect_buses", "detect", span_start, -1, "buses", all_i2c_buses->len);
+   }
+   else if (func) {
+      for (int ndx = 0; ndx < all_i2c_buses->len; ndx++)
+         func(g_ptr_array_index(all_i2c_buses, ndx), func_data);
    }
    int result = all_i2c_buses->len;
    DBGTRC_DONE(debug, DDCA_TRC_I2C, "Returning: %d", result);
@@ -975,6 +1554,23 @@ int i2c_detect_buses() {
 }
 
 
+/** Detect buses if not already detected.
+ *
+ *  Stores the result in global array all_i2c_buses and also
+ *  the bitset connected_buses.
+ *
+ *  @return number of i2c buses
+ */
+int i2c_detect_buses() {
+   bool debug = false;
+   DBGTRC_STARTING(debug, DDCA_TRC_I2C, "all_i2c_buses = %p", all_i2c_buses);
+
+   int result = i2c_detect_buses_with_callback(NULL, NULL);
+   DBGTRC_DONE(debug, DDCA_TRC_I2C, "Returning: %d", result);
+   return result;
+}
+
+
 /** Discard all known buses */
 void i2c_discard_buses() {
    bool debug = false;
@@ -1224,11 +1820,17 @@ static void init_i2c_bus_core_func_name_table() {
    RTTI_ADD_FUNC(i2c_check_open_bus_alive);
    RTTI_ADD_FUNC(i2c_close_bus);
    RTTI_ADD_FUNC(i2c_detect_buses);
+   RTTI_ADD_FUNC(i2c_detect_buses_with_callback);
    RTTI_ADD_FUNC(i2c_detect_single_bus);
    RTTI_ADD_FUNC(i2c_detect_x37);
    RTTI_ADD_FUNC(i2c_discard_buses);
    RTTI_ADD_FUNC(i2c_enable_cross_instance_locks);
+   RTTI_ADD_FUNC(i2c_enable_handle_pool);
+   RTTI_ADD_FUNC(i2c_handle_pool_invalidate);
+   RTTI_ADD_FUNC(handle_pool_reaper_func);
    RTTI_ADD_FUNC(i2c_open_bus);
+   RTTI_ADD_FUNC(flock_blocking_wait_for_lock);
+   RTTI_ADD_FUNC(flock_waiter_thread_func);
    RTTI_ADD_FUNC(i2c_report_active_bus);
    RTTI_ADD_FUNC(is_laptop_drm_connector_name);
    RTTI_ADD_FUNC(threaded_initial_checks_by_businfo);
@@ -1245,5 +1847,34 @@ void init_i2c_bus_core() {
    open_failures_reported = EMPTY_BIT_SET_256;
    // attached_buses = EMPTY_BIT_SET_256;
    // connected_buses = EMPTY_BIT_SET_256;
+   handle_pool_terminating = false;
+   flock_waiters_terminating = false;
+   for (int busno = 0; busno <= I2C_BUS_MAX; busno++) {
+      handle_pool[busno].idle_fd = -1;
+      handle_pool[busno].in_use_fd = -1;
+   }
+}
+
+
+/** Stops the handle pool reaper thread and the flock() waiter threads,
+ *  and closes all pooled handles.
+ */
+void terminate_i2c_bus_core() {
+   g_mutex_lock(&handle_pool_mutex);
+   handle_pool_terminating = true;
+   GThread * reaper = handle_pool_reaper;
+   handle_pool_reaper = NULL;
+   g_cond_signal(&handle_pool_cond);
+   g_mutex_unlock(&handle_pool_mutex);
+   if (reaper)
+      g_thread_join(reaper);
+   i2c_handle_pool_invalidate(-1);
+
+   // A waiter thread blocked in flock() cannot be interrupted.  Idle waiter
+   // threads exit, a blocked one exits once its flock() returns.
+   g_mutex_lock(&flock_waiters_mutex);
+   flock_waiters_terminating = true;
+   g_cond_broadcast(&flock_waiters_cond);
+   g_mutex_unlock(&flock_waiters_mutex);
 }
 
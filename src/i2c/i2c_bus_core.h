@@ -2,7 +2,7 @@
  *
  *  I2C bus detection and inspection
  */
-// Copyright (C) 2014-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2014-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #ifndef I2C_BUS_CORE_H_
@@ -37,6 +37,9 @@ extern int  i2c_businfo_async_threshold;
 extern bool cross_instance_locks_enabled;
 extern int  flock_poll_millisec;
 extern int  flock_max_wait_millisec;
+extern bool flock_blocking_wait;
+extern bool i2c_handle_pool_enabled;
+extern int  i2c_handle_pool_idle_millisec;
 
 void i2c_enable_cross_instance_locks(bool yesno);
 
@@ -48,14 +51,26 @@ void             include_open_failures_reported(int busno);
 Error_Info *     i2c_open_bus(int busno, Byte callopts, int * fd_loc);
 Status_Errno     i2c_close_bus(int busno, int fd, Call_Options callopts);
 
+// Handle pool
+void             i2c_enable_handle_pool(bool yesno);
+void             i2c_handle_pool_invalidate(int busno);
+bool             i2c_handle_pool_contains(int busno);
+void             i2c_report_handle_pool_stats(int depth);
+void             i2c_reset_handle_pool_stats();
+
 // Bus inspection
 void             i2c_check_bus(I2C_Bus_Info * bus_info);
+void             i2c_report_edid_read_stats(int depth);
+void             i2c_reset_edid_read_stats();
 Error_Info *     i2c_check_open_bus_alive(Display_Handle * dh);
 
 // Bus inventory - detect and probe buses
 Bit_Set_256      buses_bitset_from_businfo_array(GPtrArray * buses, bool only_connected);   // buses: array of I2C_Bus_Info
+/** Called as the checks of each bus complete */
+typedef void (*I2C_Bus_Checked_Func)(I2C_Bus_Info * businfo, gpointer data);
 GPtrArray *      i2c_detect_buses0();
 int              i2c_detect_buses();            // creates internal array of Bus_Info for I2C buses
+int              i2c_detect_buses_with_callback(I2C_Bus_Checked_Func func, gpointer func_data);
 void             i2c_discard_buses();
 I2C_Bus_Info *   i2c_detect_single_bus(int busno);
 
@@ -65,5 +80,6 @@ void             i2c_report_active_bus(I2C_Bus_Info * businfo, int depth);
 // Initialization
 void             subinit_i2c_bus_core();
 void             init_i2c_bus_core();
+void             terminate_i2c_bus_core();
 
 #endif /* I2C_BUS_CORE_H_ */
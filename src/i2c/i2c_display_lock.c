@@ -20,6 +20,13 @@
  *  Only the io path to the display is checked.
  */
 
+/* 2024:
+ *
+ * Each lock record has its own mutex and condition variable.  Threads
+ * waiting for one display do not block threads using other displays,
+ * and waiters are served in order of arrival.
+ */
+
 /* 5/2023:
  *
  * This method of locking is vestigial from the time that there could be more
@@ -41,8 +48,12 @@
 #include "util/linux_util.h"
 #include "util/report_util.h"
 #include "util/string_util.h"
+#include "util/timestamp.h"
 
 #include "base/displays.h"
+#include "base/execution_stats.h"
+#include "base/lock_stats.h"
+#include "base/parms.h"
 #include "base/rtti.h"
 #include "base/status_code_mgt.h"
 
@@ -76,7 +87,8 @@ static bool lock_rec_matches_dref(Display_Lock_Record * ddesc, Display_Ref * dre
 
 static GPtrArray * lock_records = NULL;   // array of Diaplay_Lock_Record *
 static GMutex descriptors_mutex;          // single threads access to lock records
-static GMutex master_display_lock_mutex;
+
+int display_lock_max_wait_millisec = DEFAULT_DISPLAY_LOCK_MAX_WAIT_MILLISEC;
 
 
 // must be called when lock not held by current thread, o.w. deadlock
@@ -111,7 +123,9 @@ get_display_lock_record_by_dpath(DDCA_IO_Path io_path) {
       Display_Lock_Record * new_desc = calloc(1, sizeof(Display_Lock_Record));
       memcpy(new_desc->marker, DISPLAY_LOCK_MARKER, 4);
       new_desc->io_path           = io_path;
-      g_mutex_init(&new_desc->display_mutex);
+      g_mutex_init(&new_desc->state_mutex);
+      g_cond_init(&new_desc->state_changed);
+      new_desc->waiters = g_queue_new();
       g_ptr_array_add(lock_records, new_desc);
       result = new_desc;
    }
@@ -137,52 +151,94 @@ get_display_lock_record_by_dref(Display_Ref * dref) {
 #endif
 
 
-/** Locks a distinct display.
+typedef struct {
+   GThread * thread;
+} Display_Lock_Waiter;
+
+
+/** Locks a distinct display, waiting at most a specified time.
  *
- *  \param  id                 distinct display identifier
+ *  Waiters are served in order of arrival.
+ *  Only the lock record for the display is locked while waiting, so
+ *  threads using different displays do not block each other.
+ *
+ *  \param  ddesc              lock record
  *  \param  flags              if **DDISP_WAIT** set, wait for locking
+ *  \param  max_wait_millisec  maximum time to wait, 0 for no limit
  *  \retval NULL               success
  *  \retval Error_Info(DDCRC_LOCKED)       locking failed, display already locked by another
- *                                         thread and DDISP_WAIT not set
+ *                                         thread and DDISP_WAIT not set, or wait timed out
  *  \retval Error_Info(DDCRC_ALREADY_OPEN) display already locked in current thread
  */
 Error_Info *
-lock_display(
+lock_display_timed(
       Display_Lock_Record * ddesc,
-      Display_Lock_Flags flags)
+      Display_Lock_Flags    flags,
+      int                   max_wait_millisec)
 {
    bool debug = false;
-   DBGTRC_STARTING(debug, TRACE_GROUP, "ddesc=%p -> %s", ddesc, lockrec_repr_t(ddesc));
+   DBGTRC_STARTING(debug, TRACE_GROUP, "ddesc=%p -> %s, flags=0x%02x, max_wait_millisec=%d",
+                                       ddesc, lockrec_repr_t(ddesc), flags, max_wait_millisec);
 
    Error_Info * err = NULL;
    // TODO:  If this function is exposed in API, change assert to returning illegal argument status code
    TRACED_ASSERT(memcmp(ddesc->marker, DISPLAY_LOCK_MARKER, 4) == 0);
-   bool self_thread = false;
-   g_mutex_lock(&master_display_lock_mutex);  //wrong - will hold lock during wait
-   if (ddesc->display_mutex_thread == g_thread_self() )
-      self_thread = true;
-   g_mutex_unlock(&master_display_lock_mutex);
-   if (self_thread) {
+   GThread * self = g_thread_self();
+   uint64_t wait_start = cur_realtime_nanosec();
+
+   g_mutex_lock(&ddesc->state_mutex);
+   if (ddesc->owner_thread == self) {
+      g_mutex_unlock(&ddesc->state_mutex);
       MSG_W_SYSLOG(DDCA_SYSLOG_ERROR, "Attempting to lock display already locked by current thread, tid=%jd", get_thread_id());
       err = errinfo_new(DDCRC_ALREADY_OPEN, __func__,   // is there a better status code?
             "Attempting to lock display already locked by current thread"); // poor
       goto bye;
    }
 
-   bool locked = true;
-   if (flags & DDISP_WAIT) {
-      g_mutex_lock(&ddesc->display_mutex);
+   bool locked = false;
+   if (!ddesc->owner_thread && g_queue_is_empty(ddesc->waiters)) {
+      locked = true;
+   }
+   else if (!(flags & DDISP_WAIT)) {
+      err = errinfo_new(DDCRC_LOCKED, __func__, "Locking failed");
    }
    else {
-      locked = g_mutex_trylock(&ddesc->display_mutex);
-      if (!locked)
-         err = errinfo_new(DDCRC_LOCKED, __func__, "Locking failed");
+      Display_Lock_Waiter waiter;
+      waiter.thread = self;
+      g_queue_push_tail(ddesc->waiters, &waiter);
+
+      gint64 end_time = g_get_monotonic_time() + (gint64) max_wait_millisec * G_TIME_SPAN_MILLISECOND;
+      while (ddesc->owner_thread || g_queue_peek_head(ddesc->waiters) != &waiter) {
+         if (max_wait_millisec <= 0) {
+            g_cond_wait(&ddesc->state_changed, &ddesc->state_mutex);
+         }
+         else if (!g_cond_wait_until(&ddesc->state_changed, &ddesc->state_mutex, end_time)) {
+            if (!ddesc->owner_thread && g_queue_peek_head(ddesc->waiters) == &waiter)
+               break;   // became available just as the wait expired
+            err = errinfo_new(DDCRC_LOCKED, __func__,
+                  "Wait for display lock exceeded %d milliseconds", max_wait_millisec);
+            break;
+         }
+      }
+      g_queue_remove(ddesc->waiters, &waiter);
+      if (err)
+         g_cond_broadcast(&ddesc->state_changed);   // the next waiter may now be at the head
+      else
+         locked = true;
    }
 
+   uint64_t wait_end = cur_realtime_nanosec();
    if (locked) {  // note that this thread owns the lock
-       ddesc->display_mutex_thread = g_thread_self();
+       ddesc->owner_thread = self;
        ddesc->linux_thread_id = get_thread_id();
+       ddesc->locked_at_nanos = wait_end;
    }
+   g_mutex_unlock(&ddesc->state_mutex);
+
+   // the operation in progress identifies the waiter better than the
+   // low level function that opens the device
+   const char * waiter_name = optime_current_operation_name();
+   lock_stats_record_wait(LOCK_STATS_DISPLAY, (waiter_name) ? waiter_name : "other", wait_end - wait_start);
 
 bye:
    // need a new DDC status code
@@ -193,6 +249,26 @@ bye:
 }
 
 
+/** Locks a distinct display.
+ *
+ *  If **DDISP_WAIT** is set, waits at most #display_lock_max_wait_millisec.
+ *
+ *  \param  ddesc              lock record
+ *  \param  flags              if **DDISP_WAIT** set, wait for locking
+ *  \retval NULL               success
+ *  \retval Error_Info(DDCRC_LOCKED)       locking failed, display already locked by another
+ *                                         thread and DDISP_WAIT not set, or wait timed out
+ *  \retval Error_Info(DDCRC_ALREADY_OPEN) display already locked in current thread
+ */
+Error_Info *
+lock_display(
+      Display_Lock_Record * ddesc,
+      Display_Lock_Flags flags)
+{
+   return lock_display_timed(ddesc, flags, display_lock_max_wait_millisec);
+}
+
+
 #ifdef UNUSED
 /** Locks a display.
  *
@@ -255,17 +331,21 @@ unlock_display(Display_Lock_Record * ddesc) {
    Error_Info * err = NULL;
    // TODO:  If this function is exposed in API, change assert to returning illegal argument status code
    TRACED_ASSERT(memcmp(ddesc->marker, DISPLAY_LOCK_MARKER, 4) == 0);
-   g_mutex_lock(&master_display_lock_mutex);
-   if (ddesc->display_mutex_thread != g_thread_self()) {
+   uint64_t hold_nanos = 0;
+   g_mutex_lock(&ddesc->state_mutex);
+   if (ddesc->owner_thread != g_thread_self()) {
       SYSLOG2(DDCA_SYSLOG_ERROR, "Attempting to unlock display lock owned by different thread");
       err = errinfo_new(DDCRC_LOCKED, __func__, "Attempting to unlock display lock owned by different thread");
    }
    else {
-      ddesc->display_mutex_thread = NULL;
+      ddesc->owner_thread = NULL;
       ddesc->linux_thread_id = 0;
-      g_mutex_unlock(&ddesc->display_mutex);
+      hold_nanos = cur_realtime_nanosec() - ddesc->locked_at_nanos;
+      g_cond_broadcast(&ddesc->state_changed);
    }
-   g_mutex_unlock(&master_display_lock_mutex);
+   g_mutex_unlock(&ddesc->state_mutex);
+   if (!err)
+      lock_stats_record_hold(LOCK_STATS_DISPLAY, hold_nanos);
    DBGTRC_RET_ERRINFO(debug, TRACE_GROUP, err, "ddesc=%p -> %s", ddesc, lockrec_repr_t(ddesc));
    return err;
 }
@@ -342,25 +422,39 @@ dbgrpt_display_locks(int depth) {
    rpt_vstring(depth, "display_descriptors@%p", lock_records);
    g_mutex_lock(&descriptors_mutex);
    int d1 = depth+1;
-   rpt_label(depth,"index  lock-record-ptr  dpath                         display_mutex_thread");
+   rpt_label(depth,"index  lock-record-ptr  dpath                         owner_thread");
    for (int ndx=0; ndx < lock_records->len; ndx++) {
       Display_Lock_Record * cur = g_ptr_array_index(lock_records, ndx);
-      rpt_vstring(d1, "%2d - %p  %-28s  thread ptr=%p, thread id=%jd",
+      g_mutex_lock(&cur->state_mutex);
+      rpt_vstring(d1, "%2d - %p  %-28s  thread ptr=%p, thread id=%jd, waiters=%d",
                        ndx, cur,
                        dpath_repr_t(&cur->io_path),
-                       (void*) &cur->display_mutex_thread, cur->linux_thread_id );
+                       (void*) cur->owner_thread, cur->linux_thread_id,
+                       g_queue_get_length(cur->waiters));
+      g_mutex_unlock(&cur->state_mutex);
    }
    g_mutex_unlock(&descriptors_mutex);
 }
 
 
+static void
+free_display_lock_record(void * data) {
+   Display_Lock_Record * rec = data;
+   g_mutex_clear(&rec->state_mutex);
+   g_cond_clear(&rec->state_changed);
+   g_queue_free(rec->waiters);
+   free(rec);
+}
+
+
 /** Initializes this module */
 void
 init_i2c_display_lock(void) {
-   lock_records= g_ptr_array_new_with_free_func(g_free);
+   lock_records= g_ptr_array_new_with_free_func(free_display_lock_record);
 
    RTTI_ADD_FUNC(get_display_lock_record_by_dpath);
    RTTI_ADD_FUNC(lock_display);
+   RTTI_ADD_FUNC(lock_display_timed);
    RTTI_ADD_FUNC(lock_display_by_dpath);
    RTTI_ADD_FUNC(unlock_display);
    RTTI_ADD_FUNC(unlock_display_by_dpath);
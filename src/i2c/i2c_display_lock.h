@@ -1,7 +1,7 @@
 /* @file i2c_display_lock.h
  */
 
-// Copyright (C) 2018-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2018-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #ifndef DDC_DISPLAY_LOCK_H_
@@ -18,21 +18,28 @@
 
 typedef enum {
    DDISP_NONE  = 0x00,     ///< No flags set
-   DDISP_WAIT  = 0x01      ///< If true, #lock_distinct_display() should wait
+   DDISP_WAIT  = 0x01      ///< If true, #lock_display() should wait
 } Display_Lock_Flags;
 
+extern int display_lock_max_wait_millisec;
+
 #define DISPLAY_LOCK_MARKER "DDSC"
 typedef struct {
    char         marker[4];
    DDCA_IO_Path io_path;
-   GMutex       display_mutex;
-   GThread *    display_mutex_thread;     // thread owning mutex
+   GMutex       state_mutex;              // guards the following fields
+   GCond        state_changed;
+   GThread *    owner_thread;             // thread holding the lock, NULL if none
    intmax_t     linux_thread_id;
+   GQueue *     waiters;                  // Display_Lock_Waiter *, in order of service
+   uint64_t     locked_at_nanos;          // for lock hold time statistics
 } Display_Lock_Record;
 
 void                  init_i2c_display_lock(void);
 void                  terminate_i2c_display_lock();
 Error_Info *          lock_display(Display_Lock_Record * id, Display_Lock_Flags flags);
+Error_Info *          lock_display_timed(Display_Lock_Record * id, Display_Lock_Flags flags,
+                                         int max_wait_millisec);
 Error_Info *          lock_display_by_dpath(DDCA_IO_Path dpath, Display_Lock_Flags flags);
 Error_Info *          unlock_display(Display_Lock_Record * id);
 Error_Info *          unlock_display_by_dpath(DDCA_IO_Path dpath);
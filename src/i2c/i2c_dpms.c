@@ -111,8 +111,11 @@ bool dpms_check_drm_asleep_by_connector(const char * drm_connector_name) {
    char * status  = NULL;
    int d = (IS_DBGTRC(debug, DDCA_TRC_NONE)) ? 1 : -1;
    RPT_ATTR_TEXT(d, &dpms,    "/sys/class/drm", drm_connector_name, "dpms");
-   RPT_ATTR_TEXT(d, &enabled, "/sys/class/drm", drm_connector_name, "enabled");
-   RPT_ATTR_TEXT(d, &status,  "/sys/class/drm", drm_connector_name, "status");
+   // only dpms determines the result, avoid extra sysfs reads on each recheck
+   if (d >= 0) {
+      RPT_ATTR_TEXT(d, &enabled, "/sys/class/drm", drm_connector_name, "enabled");
+      RPT_ATTR_TEXT(d, &status,  "/sys/class/drm", drm_connector_name, "status");
+   }
    // Nvidia driver reports enabled value as "disabled"
    // asleep = !( streq(dpms, "On") && streq(enabled, "enabled") );
    bool asleep = !streq(dpms, "On");
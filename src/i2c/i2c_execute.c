@@ -56,6 +56,23 @@ static DDCA_Trace_Group TRACE_GROUP = DDCA_TRC_I2C;
  */
 bool i2c_forceable_slave_addr_flag = false;
 
+// Slave address most recently set on each open /dev/i2c file descriptor,
+// so that redundant I2C_SLAVE ioctls can be skipped.  0 if not known.
+// Use of a descriptor is serialized by the display lock.
+#define SLAVE_ADDR_TRACKED_FD_MAX 1024
+static uint16_t current_slave_addr[SLAVE_ADDR_TRACKED_FD_MAX];
+
+
+/** Discards the slave address recorded for a file descriptor.
+ *  Must be called when a /dev/i2c device is opened or closed.
+ *
+ *  @param  fd  file descriptor
+ */
+void i2c_forget_slave_addr(int fd) {
+   if (fd >= 0 && fd < SLAVE_ADDR_TRACKED_FD_MAX)
+      current_slave_addr[fd] = 0;
+}
+
 
 Status_Errno
 i2c_set_addr0(int fd, uint16_t op, int addr) {
@@ -73,6 +90,13 @@ i2c_set_addr0(int fd, uint16_t op, int addr) {
    int ioctl_rc = 0;
    int errsv = 0;
 
+   bool tracked = (fd >= 0 && fd < SLAVE_ADDR_TRACKED_FD_MAX);
+   if (tracked && current_slave_addr[fd] == addr && !force_pseudo_failure) {
+      log_io_call_avoided(IE_OTHER);
+      DBGTRC_RET_DDCRC(debug, TRACE_GROUP, result, "Slave address already set");
+      return result;
+   }
+
    if (force_pseudo_failure && op == I2C_SLAVE) {
       DBGTRC_NOPREFIX(true, TRACE_GROUP, "Forcing pseudo failure");
       ioctl_rc = -1;
@@ -81,6 +105,8 @@ i2c_set_addr0(int fd, uint16_t op, int addr) {
    else {
       RECORD_IO_EVENT(-1, IE_OTHER, ( ioctl_rc = ioctl(fd, op, addr) ) );
    }
+   if (tracked)
+      current_slave_addr[fd] = (ioctl_rc < 0) ? 0 : addr;
 
    if (ioctl_rc < 0) {
       errsv = errno;
@@ -17,6 +17,7 @@
 extern bool i2c_forceable_slave_addr_flag;
 
 Status_Errno i2c_set_addr(int fd, int addr);
+void         i2c_forget_slave_addr(int fd);
 
 /** Function template for I2C write function */
 typedef Status_Errno_DDC (*I2C_Writer)(
@@ -22,5 +22,6 @@ void init_i2c_services() {
 }
 
 void terminate_i2c_services() {
+   terminate_i2c_bus_core();
    terminate_i2c_sysfs();
 }
@@ -620,6 +620,47 @@ void dbgrpt_sys_bus_i2c(int depth) {
 GPtrArray * sys_drm_connectors = NULL;  // Sys_Drm_Connector
 GPtrArray * sys_drm_connectors_fixedinfo = NULL;  // future
 
+// Lookup indexes for sys_drm_connectors, see find_sys_drm_connector()
+static Ptr_Array_Index * connector_busno_index = NULL;
+static Ptr_Array_Index * connector_edid_index  = NULL;
+static Ptr_Array_Index * connector_name_index  = NULL;
+
+static bool connector_busno_key(gconstpointer element, gpointer * key_loc) {
+   const Sys_Drm_Connector * conn = element;
+   *key_loc = GINT_TO_POINTER(conn->i2c_busno);
+   return conn->i2c_busno >= 0;
+}
+
+static bool connector_busno_match(gconstpointer element, gconstpointer key) {
+   const Sys_Drm_Connector * conn = element;
+   return conn->i2c_busno >= 0 && conn->i2c_busno == GPOINTER_TO_INT(key);
+}
+
+static bool connector_edid_key(gconstpointer element, gpointer * key_loc) {
+   const Sys_Drm_Connector * conn = element;
+   if (conn->edid_size < 128)
+      return false;
+   *key_loc = g_malloc(128);
+   memcpy(*key_loc, conn->edid_bytes, 128);
+   return true;
+}
+
+static bool connector_edid_match(gconstpointer element, gconstpointer key) {
+   const Sys_Drm_Connector * conn = element;
+   return conn->edid_size >= 128 && memcmp(key, conn->edid_bytes, 128) == 0;
+}
+
+static bool connector_name_key(gconstpointer element, gpointer * key_loc) {
+   const Sys_Drm_Connector * conn = element;
+   *key_loc = g_strdup(conn->connector_name);
+   return true;
+}
+
+static bool connector_name_match(gconstpointer element, gconstpointer key) {
+   const Sys_Drm_Connector * conn = element;
+   return streq(conn->connector_name, key);
+}
+
 
 /** Frees a Sys_Drm_Connector instance
  *
@@ -675,6 +716,9 @@ void free_sys_drm_connectors() {
    if (sys_drm_connectors)
       g_ptr_array_free(sys_drm_connectors, true);
    sys_drm_connectors = NULL;
+   pai_reset(connector_busno_index);
+   pai_reset(connector_edid_index);
+   pai_reset(connector_name_index);
 }
 
 // future simplified version
@@ -742,6 +786,115 @@ void report_one_sys_drm_display_fixedinfo(int depth, Sys_Drm_Connector_FixedInfo
 }
 
 
+/** Reads a text attribute relative to a sysfs directory descriptor.
+ *
+ *  @param  dirfd    directory descriptor opened by #sysfs_open_dir_at()
+ *  @param  relpath  attribute name relative to **dirfd**
+ *  @return attribute value, NULL if not found,
+ *          caller is responsible for freeing
+ */
+static inline char *
+dup_attr_at(int dirfd, const char * relpath) {
+   char buf[200];
+   return g_strdup(sysfs_read_attr_at_r(dirfd, relpath, buf, sizeof(buf)));
+}
+
+
+/** Fills in a #Sys_Drm_Connector for a single connector directory of
+ *  /sys/class/drm without reporting.
+ *
+ *  The connector directory is opened once, and all attributes are read
+ *  relative to it, avoiding path assembly and resolution for each attribute.
+ *  Equivalent to #one_drm_connector() when no report is requested.
+ *
+ *  @param  dirname  /sys/class/drm
+ *  @param  fn       connector name, e.g. card0-DP-1
+ *  @param  cur      instance to fill in
+ */
+static void
+read_drm_connector_at(
+      const char *        dirname,
+      const char *        fn,
+      Sys_Drm_Connector * cur)
+{
+   bool debug = false;
+   DBGTRC_STARTING(debug, TRACE_GROUP, "dirname=%s, fn=%s", dirname, fn);
+
+   char connector_path[PATH_MAX];
+   g_snprintf(connector_path, PATH_MAX, "%s/%s", dirname, fn);
+   int cfd = sysfs_open_dir_at(AT_FDCWD, connector_path);
+   if (cfd < 0) {
+      DBGTRC_DONE(debug, TRACE_GROUP, "Unable to open %s: %s", connector_path, strerror(-cfd));
+      return;
+   }
+
+   char path_buf[PATH_MAX];
+   char i2cN_buf[40];        // i2c-N
+   cur->connector_path = realpath(connector_path, NULL);
+   cur->enabled = dup_attr_at(cfd, "enabled");
+   cur->status  = dup_attr_at(cfd, "status");
+
+   Byte edid_buf[4096];
+   int edid_ct = sysfs_read_binary_attr_at_r(cfd, "edid", edid_buf, sizeof(edid_buf));
+   if (edid_ct > 0) {
+      cur->edid_size = edid_ct;
+      cur->edid_bytes = g_malloc(edid_ct);
+      memcpy(cur->edid_bytes, edid_buf, edid_ct);
+   }
+   else if (edid_ct == -EOVERFLOW) {
+      GByteArray * edid_byte_array = NULL;
+      GET_ATTR_EDID(&edid_byte_array, connector_path, "edid");
+      if (edid_byte_array) {
+         cur->edid_size = edid_byte_array->len;
+         cur->edid_bytes = g_byte_array_free(edid_byte_array, false);
+      }
+   }
+
+   char * driver = (cur->connector_path)
+                        ? find_adapter_and_get_driver(cur->connector_path, -1)
+                        : NULL;
+   DBGTRC_NOPREFIX(debug, TRACE_GROUP, "driver=%s", driver);
+   if (!(streq(driver, "nvidia") ))  {
+      cur->is_aux_channel =
+            sysfs_find_subdir_at_r(cfd, ".", "drm_dp_aux", i2cN_buf, sizeof(i2cN_buf));
+      if (sysfs_find_subdir_at_r(cfd, ".", "i2c-", i2cN_buf, sizeof(i2cN_buf))) {  // DP
+         cur->i2c_busno = i2c_name_to_busno(i2cN_buf);
+         g_snprintf(path_buf, PATH_MAX, "%s/name", i2cN_buf);
+         cur->name = dup_attr_at(cfd, path_buf);
+         g_snprintf(path_buf, PATH_MAX, "%s/i2c-dev/%s/dev", i2cN_buf, i2cN_buf);
+         cur->dev = dup_attr_at(cfd, path_buf);
+
+         // Examine ddc subdirectory - does not exist on Nvidia driver
+         if (sysfs_dir_exists_at(cfd, "ddc")) {
+            g_snprintf(path_buf, PATH_MAX, "%s/ddc", connector_path);
+            cur->ddc_dir_path = realpath(path_buf, NULL);
+            cur->base_name = dup_attr_at(cfd, "ddc/name");
+            if (sysfs_find_subdir_at_r(cfd, "ddc/i2c-dev", "i2c-", i2cN_buf, sizeof(i2cN_buf))) {
+               cur->base_busno = i2c_name_to_busno(i2cN_buf);
+               g_snprintf(path_buf, PATH_MAX, "ddc/i2c-dev/%s/dev", i2cN_buf);
+               cur->base_dev = dup_attr_at(cfd, path_buf);
+            }
+         }
+      }
+      else {   // not DP
+         g_snprintf(path_buf, PATH_MAX, "%s/ddc", connector_path);
+         cur->ddc_dir_path = realpath(path_buf, NULL);
+         if (cur->ddc_dir_path) {
+            cur->name = dup_attr_at(cfd, "ddc/name");
+            if (sysfs_find_subdir_at_r(cfd, "ddc/i2c-dev", "i2c-", i2cN_buf, sizeof(i2cN_buf))) {
+               cur->i2c_busno = i2c_name_to_busno(i2cN_buf);
+               g_snprintf(path_buf, PATH_MAX, "ddc/i2c-dev/%s/dev", i2cN_buf);
+               cur->base_dev = dup_attr_at(cfd, path_buf);
+            }
+         }
+      }
+   }
+   free(driver);
+   close(cfd);
+   DBGTRC_DONE(debug, TRACE_GROUP, "");
+}
+
+
 /** Scans a single connector directory of /sys/class/drm.
  *
  *  Has typedef Dir_Foreach_Func
@@ -765,6 +918,12 @@ void one_drm_connector(
    cur->base_busno = -1;
    g_ptr_array_add(drm_displays, cur);
    cur->connector_name = g_strdup(fn);   // e.g. card0-DP-1
+   if (d0 < 0) {
+      read_drm_connector_at(dirname, fn, cur);
+      DBGTRC_DONE(debug, TRACE_GROUP, "");
+      return;
+   }
+
    RPT_ATTR_REALPATH(d0, &cur->connector_path,
                                        dirname, fn);
    RPT_ATTR_TEXT(d0, &cur->enabled, dirname, fn, "enabled");   // e.g. /sys/class/drm/card0-DP-1/enabled
@@ -1031,6 +1190,107 @@ void one_drm_connector_fixedinfo(
 }
 
 
+//
+// Cache validation for DRM connector scans
+//
+// Scanning /sys/class/drm reads several attributes, including the EDID,
+// of every connector.  Changes to connector state are accompanied by a
+// uevent, which increments /sys/kernel/uevent_seqnum.  A scan is therefore
+// reused as long as the sequence number is unchanged and the cache has not
+// been explicitly invalidated, e.g. by the watch thread on receipt of a
+// DRM uevent.  Any uevent, not only a DRM uevent, causes a rescan.
+//
+
+static uint64_t drm_connectors_seqnum    = 0;   // seqnum when sys_drm_connectors scanned, 0 = invalid
+static uint64_t drm_connector_generation = 0;   // incremented when a connector's state changes
+
+// updated atomically, scans can be performed by any thread
+typedef struct {
+   int scans;
+   int scans_avoided;
+} Drm_Scan_Stats;
+
+#define INCR_SCAN_STAT(_stats, _field) __atomic_add_fetch(&(_stats)._field, 1, __ATOMIC_RELAXED)
+#define GET_SCAN_STAT(_stats, _field)  __atomic_load_n(&(_stats)._field, __ATOMIC_RELAXED)
+
+static Drm_Scan_Stats connector_scan_stats;
+static Drm_Scan_Stats connector_name_scan_stats;
+
+
+/** Reads the kernel uevent sequence number.
+ *
+ *  @return sequence number, 0 if unavailable
+ */
+static uint64_t
+read_uevent_seqnum() {
+#ifdef TARGET_BSD
+   return 0;
+#else
+   uint64_t result = 0;
+   char * s = file_get_first_line("/sys/kernel/uevent_seqnum", /*verbose*/ false);
+   if (s) {
+      result = g_ascii_strtoull(s, NULL, 10);
+      free(s);
+   }
+   return result;
+#endif
+}
+
+
+/** Tests whether a cached scan taken at a given uevent sequence number
+ *  is still current.
+ *
+ *  @param  scan_seqnum  seqnum at the time of the scan, 0 if none
+ *  @param  cur_seqnum   current seqnum, 0 if unavailable
+ */
+static inline bool
+drm_scan_is_current(uint64_t scan_seqnum, uint64_t cur_seqnum) {
+   return scan_seqnum != 0 && cur_seqnum != 0 && scan_seqnum == cur_seqnum;
+}
+
+
+/** Assigns generation numbers to newly scanned connectors.  A connector
+ *  whose status and EDID are unchanged from the prior scan keeps its
+ *  generation number.
+ *
+ *  @param  new_connectors  newly scanned #Sys_Drm_Connector instances
+ *  @param  old_connectors  prior scan, may be NULL
+ */
+static void
+assign_drm_connector_generations(GPtrArray * new_connectors, GPtrArray * old_connectors) {
+   for (int ndx = 0; ndx < new_connectors->len; ndx++) {
+      Sys_Drm_Connector * cur = g_ptr_array_index(new_connectors, ndx);
+      Sys_Drm_Connector * old = NULL;
+      for (int ondx = 0; old_connectors && ondx < old_connectors->len && !old; ondx++) {
+         Sys_Drm_Connector * o = g_ptr_array_index(old_connectors, ondx);
+         if (streq(o->connector_name, cur->connector_name))
+            old = o;
+      }
+      // a connector from a scan that did not assign generations gets one
+      bool unchanged = old && old->generation != 0 &&
+                       g_strcmp0(old->status, cur->status) == 0 &&
+                       old->edid_size == cur->edid_size &&
+                       (cur->edid_size == 0 || memcmp(old->edid_bytes, cur->edid_bytes, cur->edid_size) == 0);
+      cur->generation = (unchanged) ? old->generation : ++drm_connector_generation;
+   }
+}
+
+
+/** Reports how often scans of /sys/class/drm were performed and avoided.
+ *
+ *  @param  depth  logical indentation depth
+ */
+void report_drm_connector_cache_stats(int depth) {
+   rpt_title("DRM connector scans:", depth);
+   rpt_vstring(depth+1, "Connector details:  performed: %4d, avoided: %4d",
+         GET_SCAN_STAT(connector_scan_stats, scans),
+         GET_SCAN_STAT(connector_scan_stats, scans_avoided));
+   rpt_vstring(depth+1, "Connector names:    performed: %4d, avoided: %4d",
+         GET_SCAN_STAT(connector_name_scan_stats, scans),
+         GET_SCAN_STAT(connector_name_scan_stats, scans_avoided));
+}
+
+
 /** Collects information from all connector subdirectories of /sys/class/drm,
  *  optionally emitting a report.
  *
@@ -1080,18 +1340,56 @@ GPtrArray * scan_sys_drm_connectors_fixedinfo(int depth) {
  *  @param rescan free the existing data structure
  *
  *  If sys_drm_connectors == NULL or rescan was set,
- *  scan the /sys/class/drm/<connector> directories
+ *  scan the /sys/class/drm/<connector> directories.
+ *  A rescan is skipped if no uevent has occurred since the prior scan.
  */
 GPtrArray* get_sys_drm_connectors(bool rescan) {
-   if (sys_drm_connectors && rescan) {
-      g_ptr_array_free(sys_drm_connectors, true);
-      sys_drm_connectors = NULL;
-   }
-   if (!sys_drm_connectors)
+   uint64_t cur_seqnum = read_uevent_seqnum();
+   if (sys_drm_connectors && rescan &&
+       drm_scan_is_current(__atomic_load_n(&drm_connectors_seqnum, __ATOMIC_RELAXED), cur_seqnum))
+   {
+      // nothing has changed since the last scan
+      INCR_SCAN_STAT(connector_scan_stats, scans_avoided);
+      return sys_drm_connectors;
+   }
+   if (!sys_drm_connectors || rescan) {
+      GPtrArray * old_connectors = sys_drm_connectors;
       sys_drm_connectors = scan_sys_drm_connectors(-1);
+      assign_drm_connector_generations(sys_drm_connectors, old_connectors);
+      if (old_connectors)
+         g_ptr_array_free(old_connectors, true);
+      __atomic_store_n(&drm_connectors_seqnum, cur_seqnum, __ATOMIC_RELAXED);
+      INCR_SCAN_STAT(connector_scan_stats, scans);
+   }
    return sys_drm_connectors;
 }
 
+
+/** Discards cached DRM connector scans, forcing the next query to
+ *  rescan /sys/class/drm.
+ */
+void i2c_sysfs_invalidate_drm_connectors() {
+   __atomic_store_n(&drm_connectors_seqnum, 0, __ATOMIC_RELAXED);
+   sysfs_connector_names_invalidate();
+}
+
+
+/** Returns the generation number of a DRM connector, which changes
+ *  whenever the connector's status or EDID changes.
+ *
+ *  @param  connector_name  e.g. card0-DP-1
+ *  @return generation number, 0 if connector not found
+ *
+ *  @remark
+ *  Rescans /sys/class/drm only if a uevent has occurred since the prior scan.
+ */
+uint64_t i2c_sysfs_drm_connector_generation(const char * connector_name) {
+   get_sys_drm_connectors(/*rescan=*/true);
+   Sys_Drm_Connector * conn = find_sys_drm_connector(-1, NULL, connector_name);
+   return (conn) ? conn->generation : 0;
+}
+
+
 // future simplified variant
 GPtrArray* get_sys_drm_connectors_fixedinfo(bool rescan) {
    if (sys_drm_connectors_fixedinfo && rescan) {
@@ -1164,6 +1462,10 @@ void report_sys_drm_connectors_fixedinfo(int depth) {
  *  @param  connector_name  e.g. card0-HDMI-A-1
  *
  *  Scans /sys/class/drm if global #sys_class_drm not already set
+ *
+ *  The first connector that satisfies any of the criteria is returned.
+ *  If only a single criterion is specified, the lookup uses an index of
+ *  #sys_drm_connectors.
  */
 Sys_Drm_Connector *
 find_sys_drm_connector(int busno, Byte * edid, const char * connector_name) {
@@ -1171,27 +1473,44 @@ find_sys_drm_connector(int busno, Byte * edid, const char * connector_name) {
    DBGTRC_STARTING(debug, DDCA_TRC_I2C, "busno=%d, edid=%p, connector_name=%s",
                                         busno, (void*)edid, connector_name);
    if (!sys_drm_connectors)
-     sys_drm_connectors = scan_sys_drm_connectors(-1);
+     get_sys_drm_connectors(/*rescan=*/false);
    assert(sys_drm_connectors);
    Sys_Drm_Connector * result = NULL;
-   for (int ndx = 0; ndx < sys_drm_connectors->len; ndx++) {
-      Sys_Drm_Connector * cur = g_ptr_array_index(sys_drm_connectors, ndx);
-      // DBGMSG("cur->busno = %d", cur->i2c_busno);
-      if (busno >= 0 && cur->i2c_busno == busno) {
-         DBGTRC(debug, DDCA_TRC_NONE, "Matched by bus number");
-         result = cur;
-         break;
+   int criteria_ct = (busno >= 0) + (edid != NULL) + (connector_name != NULL);
+   if (criteria_ct > 1) {
+      for (int ndx = 0; ndx < sys_drm_connectors->len; ndx++) {
+         Sys_Drm_Connector * cur = g_ptr_array_index(sys_drm_connectors, ndx);
+         if (busno >= 0 && cur->i2c_busno == busno) {
+            DBGTRC(debug, DDCA_TRC_NONE, "Matched by bus number");
+            result = cur;
+            break;
+         }
+         if (edid && cur->edid_size >= 128 && (memcmp(edid, cur->edid_bytes,128) == 0)) {
+            DBGTRC(debug, DDCA_TRC_NONE, "Matched by edid");
+            result = cur;
+            break;
+         }
+         if (connector_name && streq(connector_name, cur->connector_name)) {
+            DBGTRC(debug, DDCA_TRC_NONE, "Matched by connector_name");
+            result = cur;
+            break;
+         }
       }
-      if (edid && cur->edid_size >= 128 && (memcmp(edid, cur->edid_bytes,128) == 0)) {
+   }
+   else if (busno >= 0) {
+      result = pai_lookup(connector_busno_index, sys_drm_connectors, GINT_TO_POINTER(busno));
+      if (result)
+         DBGTRC(debug, DDCA_TRC_NONE, "Matched by bus number");
+   }
+   else if (edid) {
+      result = pai_lookup(connector_edid_index, sys_drm_connectors, edid);
+      if (result)
          DBGTRC(debug, DDCA_TRC_NONE, "Matched by edid");
-         result = cur;
-         break;
-      }
-      if (connector_name && streq(connector_name, cur->connector_name)) {
+   }
+   else if (connector_name) {
+      result = pai_lookup(connector_name_index, sys_drm_connectors, connector_name);
+      if (result)
          DBGTRC(debug, DDCA_TRC_NONE, "Matched by connector_name");
-         result = cur;
-         break;
-      }
    }
    DBGTRC_DONE(debug, DDCA_TRC_I2C, "Returning: %p", (void*) result);
    return result;
@@ -1292,6 +1611,57 @@ Sys_Drm_Connector * find_sys_drm_connector_by_connector_name(const char * name)
 }
 
 
+/** Gets the first 128 bytes of the EDID that sysfs reports for a DRM connector.
+ *
+ *  If no uevent has occurred since #sys_drm_connectors was scanned, the EDID
+ *  recorded by that scan is used.  Otherwise the connector's edid attribute
+ *  is read.
+ *
+ *  @param  connector_name  e.g. card0-DP-1
+ *  @param  edidbuf         buffer of at least 128 bytes
+ *  @param  from_scan_loc   if non-NULL, set to true if the EDID recorded by
+ *                          the connector scan was used, false if the edid
+ *                          attribute was read
+ *  @return true if an EDID was found, false if not
+ */
+bool get_sysfs_drm_edid(const char * connector_name, Byte * edidbuf, bool * from_scan_loc) {
+   bool debug = false;
+   DBGTRC_STARTING(debug, DDCA_TRC_I2C, "connector_name=%s", connector_name);
+
+   bool found = false;
+   Sys_Drm_Connector * conn = NULL;
+   if (sys_drm_connectors &&
+       drm_scan_is_current(__atomic_load_n(&drm_connectors_seqnum, __ATOMIC_RELAXED),
+                           read_uevent_seqnum()))
+   {
+      conn = find_sys_drm_connector_by_connector_name(connector_name);
+   }
+   if (conn) {
+      if (conn->edid_size >= 128) {
+         memcpy(edidbuf, conn->edid_bytes, 128);
+         found = true;
+      }
+   }
+   else {
+      char connector_path[PATH_MAX];
+      g_snprintf(connector_path, PATH_MAX, "/sys/class/drm/%s", connector_name);
+      int cfd = sysfs_open_dir_at(AT_FDCWD, connector_path);
+      if (cfd >= 0) {
+         // -EOVERFLOW for EDIDs with extension blocks, first 128 bytes are read
+         int rc = sysfs_read_binary_attr_at_r(cfd, "edid", edidbuf, 128);
+         found = (rc == 128 || rc == -EOVERFLOW);
+         close(cfd);
+      }
+   }
+
+   if (from_scan_loc)
+      *from_scan_loc = (conn != NULL);
+   DBGTRC_DONE(debug, DDCA_TRC_I2C, "Returning %s, %s", SBOOL(found),
+                                    (conn) ? "from connector scan" : "from edid attribute");
+   return found;
+}
+
+
 //
 //  Scan for conflicting modules/drivers: Struct Sys_Conflicting_Driver
 //
@@ -1580,13 +1950,35 @@ Sysfs_I2C_Info *  get_i2c_info(int busno, int depth) {
    g_snprintf(bus_path, 40, "/sys/bus/i2c/devices/i2c-%d", busno);
    Sysfs_I2C_Info * result = calloc(1, sizeof(Sysfs_I2C_Info));
    result->busno = busno;
-   RPT_ATTR_TEXT(depth, &result->name, bus_path, "name");
-   char * adapter_path  = find_adapter(bus_path, depth);
-   if (adapter_path) {
-      result->adapter_path = adapter_path;
-      RPT_ATTR_TEXT(             depth, &result->adapter_class,  adapter_path, "class");
-      RPT_ATTR_REALPATH_BASENAME(depth, &result->driver,         adapter_path, "driver");
-      RPT_ATTR_TEXT(             depth, &result->driver_version, adapter_path, "driver/module/version");
+   char * adapter_path = NULL;
+   if (depth < 0) {
+      // no report, read attributes relative to opened directories
+      int bfd = sysfs_open_dir_at(AT_FDCWD, bus_path);
+      if (bfd >= 0) {
+         result->name = dup_attr_at(bfd, "name");
+         close(bfd);
+      }
+      adapter_path = find_adapter(bus_path, depth);
+      if (adapter_path) {
+         result->adapter_path = adapter_path;
+         int afd = sysfs_open_dir_at(AT_FDCWD, adapter_path);
+         if (afd >= 0) {
+            result->adapter_class  = dup_attr_at(afd, "class");
+            result->driver_version = dup_attr_at(afd, "driver/module/version");
+            close(afd);
+         }
+         GET_ATTR_REALPATH_BASENAME(&result->driver, adapter_path, "driver");
+      }
+   }
+   else {
+      RPT_ATTR_TEXT(depth, &result->name, bus_path, "name");
+      adapter_path  = find_adapter(bus_path, depth);
+      if (adapter_path) {
+         result->adapter_path = adapter_path;
+         RPT_ATTR_TEXT(             depth, &result->adapter_class,  adapter_path, "class");
+         RPT_ATTR_REALPATH_BASENAME(depth, &result->driver,         adapter_path, "driver");
+         RPT_ATTR_TEXT(             depth, &result->driver_version, adapter_path, "driver/module/version");
+      }
    }
 
    result->conflicting_driver_names = g_ptr_array_new_with_free_func(g_free);
@@ -2180,7 +2572,7 @@ void get_sysfs_drm_add_one_connector_name(
  * @remark
  * Note the result is returned on the stack, not the heap
  */
-Sysfs_Connector_Names get_sysfs_drm_connector_names() {
+static Sysfs_Connector_Names scan_sysfs_drm_connector_names() {
    bool debug = false;
    char * dname =
  #ifdef TARGET_BSD
@@ -2210,6 +2602,48 @@ Sysfs_Connector_Names get_sysfs_drm_connector_names() {
  }
 
 
+static Sysfs_Connector_Names cached_connector_names = {NULL, NULL};
+static uint64_t              cached_connector_names_seqnum = 0;
+static GMutex                cached_connector_names_mutex;
+
+
+/** Discards the cached connector names. */
+void sysfs_connector_names_invalidate() {
+   g_mutex_lock(&cached_connector_names_mutex);
+   cached_connector_names_seqnum = 0;
+   g_mutex_unlock(&cached_connector_names_mutex);
+}
+
+
+/** Returns the DRM connector names, rescanning /sys/class/drm only if a
+ *  uevent has occurred since the prior scan.
+ *
+ *  @param  force_rescan  always rescan, e.g. when rereading the names to
+ *                        determine whether they have stabilized, since
+ *                        the names can change without a further uevent
+ *  @return struct Sysfs_Connector_Names, caller must free the contents
+ *
+ *  @remark
+ *  Note the result is returned on the stack, not the heap
+ */
+Sysfs_Connector_Names get_sysfs_drm_connector_names(bool force_rescan) {
+   uint64_t cur_seqnum = read_uevent_seqnum();
+   g_mutex_lock(&cached_connector_names_mutex);
+   if (!force_rescan && drm_scan_is_current(cached_connector_names_seqnum, cur_seqnum)) {
+      INCR_SCAN_STAT(connector_name_scan_stats, scans_avoided);
+   }
+   else {
+      free_sysfs_connector_names_contents(cached_connector_names);
+      cached_connector_names = scan_sysfs_drm_connector_names();
+      cached_connector_names_seqnum = cur_seqnum;
+      INCR_SCAN_STAT(connector_name_scan_stats, scans);
+   }
+   Sysfs_Connector_Names result = copy_sysfs_connector_names_struct(cached_connector_names);
+   g_mutex_unlock(&cached_connector_names_mutex);
+   return result;
+}
+
+
 /** Tests if two Sysfs_Connector_Names instances have the same lists
  *  for all connectors and for connectors having a valid EDID
  *
@@ -2343,6 +2777,7 @@ void init_i2c_sysfs() {
 
    // Sys_Drm_Connector
    RTTI_ADD_FUNC(one_drm_connector);
+   RTTI_ADD_FUNC(read_drm_connector_at);
    RTTI_ADD_FUNC(scan_sys_drm_connectors);
    RTTI_ADD_FUNC(report_sys_drm_connectors);
    RTTI_ADD_FUNC(find_sys_drm_connector);
@@ -2350,6 +2785,7 @@ void init_i2c_sysfs() {
    RTTI_ADD_FUNC(find_sys_drm_connector_by_busno);
 #endif
    RTTI_ADD_FUNC(find_sys_drm_connector_by_edid);
+   RTTI_ADD_FUNC(get_sysfs_drm_edid);
    RTTI_ADD_FUNC(get_drm_connector_name_by_busno);
 
    // conflicting drivers
@@ -2380,6 +2816,13 @@ void init_i2c_sysfs() {
 
    RTTI_ADD_FUNC(get_drm_connector_name_by_edid);
    RTTI_ADD_FUNC(get_drm_connector_name_by_busno);
+
+   connector_busno_index = pai_new(g_direct_hash, g_direct_equal, NULL,
+                                   connector_busno_key, connector_busno_match);
+   connector_edid_index  = pai_new(edid_bytes_hash, edid_bytes_equal, g_free,
+                                   connector_edid_key, connector_edid_match);
+   connector_name_index  = pai_new(g_str_hash, g_str_equal, g_free,
+                                   connector_name_key, connector_name_match);
 }
 
 
@@ -2387,5 +2830,14 @@ void init_i2c_sysfs() {
 void terminate_i2c_sysfs() {
    if (all_i2c_info)
       g_ptr_array_free(all_i2c_info, true);
+   free_sysfs_connector_names_contents(cached_connector_names);
+   cached_connector_names = (Sysfs_Connector_Names) {NULL, NULL};
+   cached_connector_names_seqnum = 0;
+   pai_free(connector_busno_index);
+   pai_free(connector_edid_index);
+   pai_free(connector_name_index);
+   connector_busno_index = NULL;
+   connector_edid_index  = NULL;
+   connector_name_index  = NULL;
 }
 
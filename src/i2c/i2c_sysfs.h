@@ -10,6 +10,7 @@
 #define I2C_SYSFS_H_
 
 #include <glib-2.0/glib.h>
+#include <inttypes.h>
 #include <stdbool.h>
 
 #include "util/coredefs_base.h"
@@ -77,6 +78,7 @@ typedef struct {
    gsize  edid_size;
    char * enabled;
    char * status;
+   uint64_t generation;     // changes when status or EDID changes
 } Sys_Drm_Connector;
 
 GPtrArray*          get_sys_drm_connectors(bool rescan);
@@ -87,6 +89,9 @@ Sys_Drm_Connector * find_sys_drm_connector_by_edid(Byte * raw_edid);
 void                free_sys_drm_connectors();
 Sys_Drm_Connector * i2c_check_businfo_connector(I2C_Bus_Info * bus_info);
 int                 sys_drm_get_busno_by_connector(const char * connector_name);
+void                i2c_sysfs_invalidate_drm_connectors();
+uint64_t            i2c_sysfs_drm_connector_generation(const char * connector_name);
+void                report_drm_connector_cache_stats(int depth);
 
 
 // Simplified Sys_Drm_Connector for production use
@@ -171,6 +176,7 @@ bool   i2c_all_video_devices_drm();
 char * get_drm_connector_name_by_busno(int busno);
 char * get_drm_connector_name_by_edid(Byte * edid_bytes);
 Sys_Drm_Connector * find_sys_drm_connector_by_connector_name(const char * name);
+bool                get_sysfs_drm_edid(const char * connector_name, Byte * edidbuf, bool * from_scan_loc);
 bool   is_drm_display_by_busno(int busno);
 
 
@@ -182,7 +188,8 @@ typedef struct {
 // Sysfs_Connector_Names sysfs_drm_connector_names;
 
 
-Sysfs_Connector_Names get_sysfs_drm_connector_names();
+Sysfs_Connector_Names get_sysfs_drm_connector_names(bool force_rescan);
+void sysfs_connector_names_invalidate();
 bool sysfs_connector_names_equal(Sysfs_Connector_Names cn1, Sysfs_Connector_Names cn2);
 
 void free_sysfs_connector_names_contents(Sysfs_Connector_Names names_struct);
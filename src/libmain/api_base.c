@@ -24,6 +24,7 @@
 #include "util/file_util.h"
 #include "util/report_util.h"
 #include "util/sysfs_filter_functions.h"
+#include "util/timestamp.h"
 #include "util/xdg_util.h"
 
 #include "base/base_services.h"
@@ -31,10 +32,12 @@
 #include "base/core_per_thread_settings.h"
 #include "base/core.h"
 #include "base/dsa2.h"
+#include "base/flight_recorder.h"
 #include "base/parms.h"
 #include "base/per_display_data.h"
 #include "base/per_thread_data.h"
 #include "base/rtti.h"
+#include "base/timeline.h"
 #include "base/trace_control.h"
 #include "base/tuned_sleep.h"
 
@@ -607,6 +610,8 @@ ddci_init(const char *      libopts,
       debug = true;
 
    DBGF(debug, "Starting. library_initialized=%s", sbool(library_initialized));
+   // timeline recording is not enabled until options are parsed
+   uint64_t init_start_nanos = cur_realtime_nanosec();
 
    if (infomsg_loc)
       *infomsg_loc = NULL;
@@ -697,8 +702,11 @@ ddci_init(const char *      libopts,
       library_initialization_failed = true;
    }
    else {
-      i2c_detect_buses();
-      ddc_ensure_displays_detected();
+      // in lazy detection mode displays are detected when first requested
+      if (!ddc_lazy_display_detection) {
+         i2c_detect_buses();
+         ddc_ensure_displays_detected();
+      }
 #ifdef OUT
       if (parsed_cmd->flags&CMD_FLAG_WATCH_DISPLAY_HOTPLUG_EVENTS) {
          ddc_start_watch_displays(DDCA_EVENT_CLASS_DISPLAY_CONNECTION | DDCA_EVENT_CLASS_DPMS);
@@ -711,6 +719,7 @@ ddci_init(const char *      libopts,
       SYSLOG2(DDCA_SYSLOG_NOTICE, "Library initialization complete.");
    }
    free_parsed_cmd(parsed_cmd);
+   timeline_span_end("ddci_init", "init", init_start_nanos, -1, NULL, 0);
 
    DBGF(debug, "Done.    Returning: %s", psc_desc(ddcrc));
 
@@ -749,6 +758,7 @@ ddca_start_watch_displays(DDCA_Display_Event_Class enabled_classes) {
       ERRINFO_FREE(err);
       save_thread_error_detail(public_error_detail);
    }
+   ddc_ensure_displays_detected();   // complete detection if lazy
    ddcrc = ddc_start_watch_displays(enabled_classes);
    API_EPILOG(debug, ddcrc, "");
 }
@@ -802,6 +812,8 @@ ddca_free_error_detail(DDCA_Error_Detail * ddca_erec) {
 void
 ddca_report_error_detail(DDCA_Error_Detail * ddca_erec, int depth) {
    report_error_detail(ddca_erec, depth);
+   if (ddca_erec)
+      frec_report(depth+1);
 }
 
 
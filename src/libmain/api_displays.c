@@ -281,7 +281,8 @@ ddca_get_display_ref(
    API_PRECOND_W_EPILOG(dref_loc);
    *dref_loc = NULL;
    DDCA_Status rc = 0;
-   ddc_ensure_displays_detected();
+   // displays are detected by get_display_ref_for_display_identifier(),
+   // in lazy detection mode only the requested display
 
    Display_Identifier * pdid = (Display_Identifier *) did;
    if (!pdid || memcmp(pdid->marker, DISPLAY_IDENTIFIER_MARKER, 4) != 0 )  {
@@ -545,7 +546,7 @@ ddca_open_display3(
           "library_initialized=%s, ddc_displays_already_detected() = %ld",
           sbool(library_initialized), ddc_displays_already_detected());
    TRACED_ASSERT(library_initialized);
-   TRACED_ASSERT(ddc_displays_already_detected());
+   TRACED_ASSERT(ddc_displays_already_detected() || ddc_display_detection_in_progress());
 
    API_PRECOND_W_EPILOG(dh_loc);
    Display_Ref * dref = NULL;
@@ -1363,6 +1364,46 @@ ddca_unregister_display_status_callback(DDCA_Display_Status_Callback_Func func)
 }
 
 
+DDCA_Status
+ddca_register_display_ready_callback(DDCA_Display_Ready_Callback_Func func) {
+   bool debug = false;
+   free_thread_error_detail();
+   API_PROLOGX(debug, "func=%p", func);
+
+   DDCA_Status result = ddc_register_display_ready_callback(func);
+
+   API_EPILOG(debug, result, "");
+   return result;
+}
+
+
+DDCA_Status
+ddca_unregister_display_ready_callback(DDCA_Display_Ready_Callback_Func func) {
+   bool debug = false;
+   free_thread_error_detail();
+   API_PROLOGX(debug, "func=%p", func);
+
+   DDCA_Status result = ddc_unregister_display_ready_callback(func);
+
+   API_EPILOG(debug, result, "");
+   return result;
+}
+
+
+DDCA_Status
+ddca_open_display_status_fd(int * fd_loc) {
+   bool debug = false;
+   free_thread_error_detail();
+   API_PROLOGX(debug, "fd_loc=%p", fd_loc);
+   API_PRECOND_W_EPILOG(fd_loc);
+
+   DDCA_Status result = ddc_open_display_status_fd(fd_loc);
+
+   API_EPILOG(debug, result, "*fd_loc=%d", *fd_loc);
+   return result;
+}
+
+
 const char *
    ddca_display_event_type_name(DDCA_Display_Event_Type event_type) {
       return ddc_display_event_type_name(event_type);
@@ -1461,6 +1502,9 @@ void init_api_displays() {
    RTTI_ADD_FUNC(ddca_redetect_displays);
    RTTI_ADD_FUNC(ddca_report_display_by_dref);
    RTTI_ADD_FUNC(ddca_register_display_status_callback);
+   RTTI_ADD_FUNC(ddca_register_display_ready_callback);
+   RTTI_ADD_FUNC(ddca_unregister_display_ready_callback);
+   RTTI_ADD_FUNC(ddca_open_display_status_fd);
    RTTI_ADD_FUNC(ddca_unregister_display_status_callback);
    RTTI_ADD_FUNC(validate_ddca_display_ref);
    RTTI_ADD_FUNC(ddca_validate_display_ref);
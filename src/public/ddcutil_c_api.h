@@ -133,6 +133,8 @@ ddca_build_options(void);
   *
   *  @remark
   *  This is a convenience function.
+  *  @remark
+  *  The report is followed by a list of the most recent DDC exchanges.
   */
  void
  ddca_report_error_detail(
@@ -609,6 +611,11 @@ ddca_report_displays(
  *  - rescans i2c buses
  *  - redetects displays
  *
+ *  If libddcutil was initialized with option --enable-incremental-redetect,
+ *  only buses whose DRM connector status or EDID changed are reexamined.
+ *  Display refs for unchanged displays remain valid, as do their display
+ *  numbers.
+ *
  *  @since 1.2.0
  */
 DDCA_Status
@@ -747,6 +754,12 @@ ddca_did_repr(
  *  @retval     DDCRC_ARG             did is not a valid display identifier handle
  *  @retval     DDCRC_INVALID_DISPLAY display not found
  *
+ *  @remark
+ *  If libddcutil was initialized with option --enable-lazy-detection and
+ *  the identifier specifies an I2C bus number or EDID, only the display on
+ *  that bus is detected.  All displays are detected when a function that
+ *  reports or lists displays is called.
+ *
  *  @since 0.9.5
  *  @ingroup api_display_spec
  */
@@ -1723,6 +1736,61 @@ ddca_register_display_status_callback(DDCA_Display_Status_Callback_Func func);
 DDCA_Status
 ddca_unregister_display_status_callback(DDCA_Display_Status_Callback_Func func);
 
+/** Registers a function to be called during display detection as each
+ *  display's initial checks complete.  It is not an error if the function
+ *  is already registered.
+ *
+ *  The function is called in the thread performing detection, before the
+ *  function that triggered detection returns.  It may call API functions
+ *  that operate on the display reference it is passed, e.g.
+ *  #ddca_get_display_info() or #ddca_open_display2().  It must not call
+ *  functions that list displays or trigger detection, e.g.
+ *  #ddca_get_display_refs() or #ddca_redetect_displays().
+ *
+ *  Detection is performed by #ddca_init() (unless lazy detection is enabled),
+ *  #ddca_redetect_displays(), and the first call of a function that lists
+ *  displays.  To receive reports for the initial detection, initialize the
+ *  library with option --enable-lazy-detection, register the function,
+ *  then call e.g. #ddca_get_display_refs().
+ *
+ *  @param[in] func   function of type #DDCA_Display_Ready_Callback_Func()
+ *  @retval    DDCRC_OK
+ *
+ *  @since 2.1.1
+ */
+DDCA_Status
+ddca_register_display_ready_callback(DDCA_Display_Ready_Callback_Func func);
+
+/** Removes a function from the list of registered display ready callbacks
+ *
+ *  @param[in] func            function that has already been registered
+ *  @retval    DDCRC_OK        function removed from list
+ *  @retval    DDCRC_NOT_FOUND function not registered
+ *
+ *  @since 2.1.1
+ */
+DDCA_Status
+ddca_unregister_display_ready_callback(DDCA_Display_Ready_Callback_Func func);
+
+/** Creates a file descriptor from which display status events can be read,
+ *  as an alternative to registering a callback.  The descriptor can be
+ *  monitored using poll() or epoll in the client's own event loop.
+ *
+ *  Each read() returns exactly one #DDCA_Display_Status_Event.  To stop
+ *  receiving events, close the descriptor.  If the client does not read
+ *  events quickly enough, events are dropped.
+ *
+ *  @param[out] fd_loc  where to return the file descriptor
+ *  @retval     DDCRC_OK
+ *  @retval     DDCRC_INVALID_OPERATION not all video devices support DRM,
+ *                                      or libddcutil built without UDEV support
+ *  @retval     -errno  unable to create file descriptor
+ *
+ *  @since 2.1.1
+ */
+DDCA_Status
+ddca_open_display_status_fd(int * fd_loc);
+
 /** Returns the name of a #DDCA_Display_Event_Class
  *
  *  @param  event_class event class id
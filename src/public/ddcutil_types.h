@@ -151,6 +151,7 @@ typedef enum {
    DDCA_STATS_ERRORS   = 0x02,    ///< error statistics
    DDCA_STATS_CALLS    = 0x04,    ///< system calls
    DDCA_STATS_ELAPSED  = 0x08,    ///< total elapsed time
+   DDCA_STATS_LOCKS    = 0x10,    ///< lock wait and hold times
    DDCA_STATS_ALL      = 0xFF     ///< indicates all statistics types
 } DDCA_Stats_Type;
 
@@ -598,6 +599,30 @@ typedef
 void (*DDCA_Display_Status_Callback_Func)(DDCA_Display_Status_Event event);
 
 
+/** Signature of a function to be invoked by the shared library during display
+ *  detection, as soon as the initial checks for a display have completed.
+ *
+ *  Displays are reported in the order their checks complete, so a display
+ *  that responds quickly is reported without waiting for slower displays.
+ *  Displays that may turn out to be phantom displays, i.e. ones on which
+ *  DDC does not work, or non-MST displays when a DisplayPort MST bus exists,
+ *  are reported once all checks are complete and phantom displays have been
+ *  filtered out.  Phantom displays are not reported.  The function is invoked
+ *  on the thread performing detection, before the function that triggered
+ *  detection returns.
+ *
+ *  If **ddc_working** is true, the display reference can be used immediately,
+ *  e.g. to open the display, even though detection of other displays is still
+ *  in progress.  The display number is assigned when detection completes.
+ *  See #ddca_register_display_ready_callback() for the API functions that
+ *  may be called.
+ *
+ *  @since 2.1.1
+ */
+typedef
+void (*DDCA_Display_Ready_Callback_Func)(DDCA_Display_Ref dref, bool ddc_working);
+
+
 
 #ifdef __cplusplus
 }
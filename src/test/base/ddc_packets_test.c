@@ -0,0 +1,158 @@
+/** @file ddc_packets_test.c
+ *
+ *  Checks of DDC packet size limits.
+ *
+ *  A DDC_Packet contains fixed size storage for its bytes, and packets are
+ *  reused from a per-thread free list.  These checks exercise the largest
+ *  packets that can be created, the rejection of responses that are too
+ *  large, the reuse of a large packet for a small one, and that repeated
+ *  request and response cycles perform no heap allocation.
+ */
+
+// Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "util/data_structures.h"
+
+#include "base/core.h"
+#include "base/ddc_errno.h"
+#include "base/ddc_packets.h"
+
+#include "ddc_packets_test.h"
+
+
+// Builds the bytes read from the display for a response with data_ct data
+// bytes, i.e. without the implicit destination address byte.
+static void
+build_response_bytes(int data_ct, Byte * response_bytes) {
+   Byte packet_bytes[MAX_DDC_PACKET_SIZE+8];
+   packet_bytes[0] = 0x6f;
+   packet_bytes[1] = 0x6e;
+   packet_bytes[2] = 0x80 | data_ct;
+   packet_bytes[3] = DDC_PACKET_TYPE_TABLE_READ_RESPONSE;
+   for (int ndx = 1; ndx < data_ct; ndx++)
+      packet_bytes[3+ndx] = ndx;
+   packet_bytes[3+data_ct] = ddc_checksum(packet_bytes, 3+data_ct, true);
+   memcpy(response_bytes, packet_bytes+1, 3+data_ct);
+}
+
+
+// Builds the bytes read from the display for a getvcp response,
+// i.e. without the implicit destination address byte.
+static void
+build_getvcp_response_bytes(Byte vcp_code, Byte * response_bytes) {
+   Byte packet_bytes[12];
+   packet_bytes[0] = 0x6f;
+   packet_bytes[1] = 0x6e;
+   packet_bytes[2] = 0x88;
+   packet_bytes[3] = DDC_PACKET_TYPE_QUERY_VCP_RESPONSE;
+   packet_bytes[4] = 0x00;      // result code: no error
+   packet_bytes[5] = vcp_code;
+   packet_bytes[6] = 0x00;      // VCP type: set parameter
+   packet_bytes[7] = 0x00;      // max value
+   packet_bytes[8] = 0x64;
+   packet_bytes[9] = 0x00;      // current value
+   packet_bytes[10] = 0x32;
+   packet_bytes[11] = ddc_checksum(packet_bytes, 11, true);
+   memcpy(response_bytes, packet_bytes+1, 11);
+}
+
+
+// Creates and frees a getvcp request packet and a getvcp response packet.
+// Returns true if the response was parsed.
+static bool
+getvcp_packet_cycle(Byte * getvcp_response_bytes, int response_size) {
+   DDC_Packet * request = create_ddc_getvcp_request_packet(0x10, "getvcp request");
+   DDC_Packet * response = NULL;
+   Status_DDC rc = create_ddc_getvcp_response_packet(
+         getvcp_response_bytes, response_size, 0x10, "getvcp response", &response);
+   bool ok = (rc == 0 && response &&
+              response->parsed.nontable_response->valid_response &&
+              response->parsed.nontable_response->sl == 0x32);
+   free_ddc_packet(response);
+   free_ddc_packet(request);
+   return ok;
+}
+
+
+/** Checks that packets of the maximum size can be created, that a response
+ *  exceeding it is rejected, that reusing a maximum size packet for a
+ *  smaller one leaves no stale bytes or length, and that once the free list
+ *  is primed, getvcp request and response packets require no heap allocation.
+ */
+void test_ddc_packet_size_bounds() {
+   tc_checks_start("DDC packet size bounds");
+
+   Byte response_bytes[MAX_DDC_PACKET_SIZE+8] = {0};
+   DDC_Packet * packet = NULL;
+
+   build_response_bytes(MAX_DDC_DATA_SIZE, response_bytes);
+   Status_DDC rc = create_ddc_base_response_packet(
+         response_bytes, sizeof(response_bytes), "max size response", &packet);
+   tc_check(rc == 0 && packet, "Response with MAX_DDC_DATA_SIZE data bytes accepted");
+   if (packet) {
+      tc_check(get_packet_len(packet) == MAX_DDC_PACKET_SIZE,
+            "Response packet length is MAX_DDC_PACKET_SIZE");
+      tc_check(get_data_len(packet) == MAX_DDC_DATA_SIZE,
+            "Response data length is MAX_DDC_DATA_SIZE");
+      tc_check(memcmp(get_packet_start(packet)+1, response_bytes, MAX_DDC_PACKET_SIZE-1) == 0,
+            "Response bytes copied intact");
+      free_ddc_packet(packet);
+      packet = NULL;
+   }
+
+   memset(response_bytes, 0, sizeof(response_bytes));
+   build_response_bytes(MAX_DDC_DATA_SIZE, response_bytes);
+   response_bytes[1] = 0x80 | (MAX_DDC_DATA_SIZE+1);
+   rc = create_ddc_base_response_packet(
+         response_bytes, sizeof(response_bytes), "oversize response", &packet);
+   tc_check(rc == DDCRC_DDC_DATA && !packet,
+         "Response with MAX_DDC_DATA_SIZE+1 data bytes rejected");
+
+   // largest request: 4 byte header plus 28 bytes of table data
+   Byte table_bytes[28];
+   for (int ndx = 0; ndx < sizeof(table_bytes); ndx++)
+      table_bytes[ndx] = 0xff;
+   packet = create_ddc_multi_part_write_request_packet(
+         DDC_PACKET_TYPE_TABLE_WRITE_REQUEST, 0x73, 0,
+         table_bytes, sizeof(table_bytes), "max size request");
+   tc_check(get_data_len(packet) == 4 + sizeof(table_bytes),
+         "Request with 32 data bytes created");
+   tc_check(packet->raw_bytes->len <= packet->raw_bytes->buffer_size &&
+            packet->raw_bytes->buffer_size <= MAX_DDC_PACKET_SIZE,
+         "Request length within packet storage");
+   free_ddc_packet(packet);
+
+   // the packet just freed is reused
+   packet = create_ddc_getvcp_request_packet(0x10, "reused packet");
+   tc_check(get_packet_len(packet) == 6, "Reused packet has getvcp request length");
+   tc_check(packet->raw_bytes->buffer_size == 6, "Reused packet has getvcp request buffer size");
+   bool stale = false;
+   for (int ndx = get_packet_len(packet); ndx < MAX_DDC_PACKET_SIZE; ndx++) {
+      if (packet->raw_bytes_storage[ndx] != 0)
+         stale = true;
+   }
+   tc_check(!stale, "Reused packet has no stale bytes");
+   free_ddc_packet(packet);
+
+   // steady state getvcp exchanges on this thread reuse freed packets
+   Byte getvcp_response_bytes[MAX_DDC_PACKET_SIZE] = {0};
+   build_getvcp_response_bytes(0x10, getvcp_response_bytes);
+   bool all_parsed = getvcp_packet_cycle(getvcp_response_bytes, sizeof(getvcp_response_bytes));
+   int created_before, heap_alloc_before;
+   get_ddc_packet_alloc_stats(&created_before, &heap_alloc_before);
+   for (int ndx = 0; ndx < 100; ndx++) {
+      if (!getvcp_packet_cycle(getvcp_response_bytes, sizeof(getvcp_response_bytes)))
+         all_parsed = false;
+   }
+   int created_after, heap_alloc_after;
+   get_ddc_packet_alloc_stats(&created_after, &heap_alloc_after);
+   tc_check(all_parsed, "Getvcp responses parsed");
+   tc_check(created_after - created_before >= 200, "Getvcp request and response packets created");
+   tc_check(heap_alloc_after == heap_alloc_before, "No heap allocation in getvcp cycles");
+
+   tc_checks_done();
+}
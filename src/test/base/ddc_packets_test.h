@@ -0,0 +1,14 @@
+/** @file ddc_packets_test.h
+ *
+ *  Checks of DDC packet size limits.
+ */
+
+// Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef DDC_PACKETS_TEST_H_
+#define DDC_PACKETS_TEST_H_
+
+void test_ddc_packet_size_bounds();
+
+#endif /* DDC_PACKETS_TEST_H_ */
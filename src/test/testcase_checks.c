@@ -0,0 +1,49 @@
+/** @file testcase_checks.c
+ *
+ *  Reporting of individual checks within a test case.
+ *
+ *  A test case calls tc_checks_start(), then tc_check() for each condition
+ *  verified, then tc_checks_done(), which reports the number of failures.
+ */
+
+// Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "testcase_checks.h"
+
+
+static int failure_ct = 0;
+
+/** Starts a series of checks.
+ *
+ *  @param  title  reported before the checks
+ */
+void tc_checks_start(const char * title) {
+   printf("%s:\n", title);
+   failure_ct = 0;
+}
+
+
+/** Reports the result of a single check.
+ *
+ *  @param  ok    true if the check succeeded
+ *  @param  desc  description of what was checked
+ */
+void tc_check(bool ok, const char * desc) {
+   printf("   %-60s %s\n", desc, (ok) ? "ok" : "FAILED");
+   if (!ok)
+      failure_ct++;
+}
+
+
+/** Ends a series of checks, reporting the number of failures.
+ *
+ *  @return number of failed checks
+ */
+int tc_checks_done() {
+   printf("%d failures\n", failure_ct);
+   return failure_ct;
+}
@@ -0,0 +1,18 @@
+/** @file testcase_checks.h
+ *
+ *  Reporting of individual checks within a test case.
+ */
+
+// Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef TESTCASE_CHECKS_H_
+#define TESTCASE_CHECKS_H_
+
+#include <stdbool.h>
+
+void tc_checks_start(const char * title);
+void tc_check(bool ok, const char * desc);
+int  tc_checks_done();
+
+#endif /* TESTCASE_CHECKS_H_ */
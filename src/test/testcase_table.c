@@ -23,9 +23,14 @@
 
 #include "config.h"
 
+#include "test/base/ddc_packets_test.h"
+#include "test/util/ptr_array_index_test.h"
+
 #include "testcase_table.h"
 
 Testcase_Descriptor testcase_catalog[] = {
+      {"test_ddc_packet_size_bounds",       DisplayRefNone, test_ddc_packet_size_bounds, NULL, NULL, NULL},
+      {"test_ptr_array_index",              DisplayRefNone, test_ptr_array_index, NULL, NULL, NULL},
  //   {"get_luminosity_sample_code",        DisplayRefBus,  NULL, get_luminosity_sample_code, NULL, NULL},
  //     {"demo_p2411_problem",                DisplayRefBus,  NULL, demo_p2411_problem, NULL, NULL}
 };
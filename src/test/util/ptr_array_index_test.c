@@ -0,0 +1,119 @@
+/** @file ptr_array_index_test.c
+ *
+ *  Checks of Ptr_Array_Index lookups.
+ *
+ *  A Ptr_Array_Index is not informed when the indexed array changes.  These
+ *  checks modify the array in the ways its users do - appending, removing,
+ *  changing the key of an element in place, replacing the array - and verify
+ *  that lookups still find the right element, and that lookups of absent
+ *  keys do not rebuild the index.
+ */
+
+// Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <glib-2.0/glib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "util/data_structures.h"
+#include "util/string_util.h"
+
+#include "ptr_array_index_test.h"
+
+
+typedef struct {
+   char name[20];
+   int  id;
+} Test_Element;
+
+static bool test_element_key(gconstpointer element, gpointer * key_loc) {
+   const Test_Element * elem = element;
+   if (elem->id < 0)
+      return false;
+   *key_loc = g_strdup(elem->name);
+   return true;
+}
+
+static bool test_element_match(gconstpointer element, gconstpointer key) {
+   const Test_Element * elem = element;
+   return elem->id >= 0 && streq(elem->name, key);
+}
+
+static Test_Element *
+new_test_element(const char * name, int id) {
+   Test_Element * elem = g_new0(Test_Element, 1);
+   g_strlcpy(elem->name, name, sizeof(elem->name));
+   elem->id = id;
+   return elem;
+}
+
+
+/** Checks #pai_lookup() as the indexed array is modified. */
+void test_ptr_array_index() {
+   tc_checks_start("Ptr_Array_Index lookups");
+
+   Ptr_Array_Index * pai = pai_new(g_str_hash, g_str_equal, g_free,
+                                   test_element_key, test_element_match);
+   GPtrArray * array = g_ptr_array_new_with_free_func(g_free);
+   g_ptr_array_add(array, new_test_element("alpha", 1));
+   g_ptr_array_add(array, new_test_element("beta",  2));
+   g_ptr_array_add(array, new_test_element("gamma", 3));
+
+   Test_Element * elem = pai_lookup(pai, array, "beta");
+   tc_check(elem && elem->id == 2, "Element found");
+   tc_check(pai->rebuild_ct == 1, "Index built on first lookup");
+
+   elem = pai_lookup(pai, array, "gamma");
+   tc_check(elem && elem->id == 3, "Second element found");
+   tc_check(pai->rebuild_ct == 1 && pai->hit_ct == 2, "Second lookup uses index");
+
+   elem = pai_lookup(pai, array, "delta");
+   tc_check(!elem, "Absent key not found");
+   tc_check(pai->rebuild_ct == 1 && pai->miss_ct == 1, "Absent key does not rebuild index");
+
+   g_ptr_array_add(array, new_test_element("delta", 4));
+   elem = pai_lookup(pai, array, "delta");
+   tc_check(elem && elem->id == 4, "Appended element found");
+   tc_check(pai->rebuild_ct == 2, "Index rebuilt after append");
+
+   g_ptr_array_remove_index(array, 0);    // alpha, positions shift
+   elem = pai_lookup(pai, array, "gamma");
+   tc_check(elem && elem->id == 3, "Element found after positions shift");
+   elem = pai_lookup(pai, array, "alpha");
+   tc_check(!elem, "Removed element not found");
+
+   elem = g_ptr_array_index(array, 0);    // beta
+   g_strlcpy(elem->name, "epsilon", sizeof(elem->name));
+   elem = pai_lookup(pai, array, "epsilon");
+   tc_check(elem && elem->id == 2, "Element found after key changed in place");
+   elem = pai_lookup(pai, array, "beta");
+   tc_check(!elem, "Old key of changed element not found");
+
+   elem = g_ptr_array_index(array, 0);    // epsilon
+   elem->id = -1;
+   elem = pai_lookup(pai, array, "epsilon");
+   tc_check(!elem, "Element excluded by key function not found");
+
+   g_ptr_array_add(array, new_test_element("gamma", 5));
+   elem = pai_lookup(pai, array, "gamma");
+   tc_check(elem && elem->id == 3, "First of duplicate keys found");
+
+   GPtrArray * array2 = g_ptr_array_new_with_free_func(g_free);
+   g_ptr_array_add(array2, new_test_element("gamma", 6));
+   elem = pai_lookup(pai, array2, "gamma");
+   tc_check(elem && elem->id == 6, "Element found in replacement array");
+
+   pai_reset(pai);
+   elem = pai_lookup(pai, array, "delta");
+   tc_check(elem && elem->id == 4, "Element found after reset");
+   tc_check(pai_duplicate_key_ct(pai) == 1, "Duplicate key counted");
+
+   tc_check(!pai_lookup(pai, NULL, "gamma"), "Lookup in NULL array returns NULL");
+
+   g_ptr_array_free(array2, true);
+   g_ptr_array_free(array, true);
+   pai_free(pai);
+
+   tc_checks_done();
+}
@@ -0,0 +1,14 @@
+/** @file ptr_array_index_test.h
+ *
+ *  Checks of Ptr_Array_Index lookups.
+ */
+
+// Copyright (C) 2024 Sanford Rockowitz <rockowitz@minsoft.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef PTR_ARRAY_INDEX_TEST_H_
+#define PTR_ARRAY_INDEX_TEST_H_
+
+void test_ptr_array_index();
+
+#endif /* PTR_ARRAY_INDEX_TEST_H_ */
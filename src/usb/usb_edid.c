@@ -3,7 +3,7 @@
  *  Functions to get EDID for USB connected monitors
  */
 
-// Copyright (C) 2014-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2014-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <config.h>
@@ -277,7 +277,6 @@ get_fallback_hiddev_edid(int fd, struct hiddev_devinfo * dev_info) {
                           dev_info->busnum, dev_info->devnum, dev_info->vendor, dev_info->product);
 
    Parsed_Edid * parsed_edid = NULL;
-   char * edid_source;
    struct model_sn_pair * model_sn = NULL;
 
    // Special handling for Eizo monitors
@@ -296,8 +295,8 @@ get_fallback_hiddev_edid(int fd, struct hiddev_devinfo * dev_info) {
                                   DISPSEL_NONE);
          if (bus_info) {
             DBGMSG("Using EDID for /dev/i2c-%d", bus_info->busno);
-            parsed_edid = bus_info->edid;
-            edid_source = "I2C";
+            // shared reference, released when the Usb_Monitor_Info is freed
+            parsed_edid = copy_parsed_edid(bus_info->edid);
             // STRLCPY(parsed_edid->edid_source, "I2C", EDID_SOURCE_FIELD_SIZE);
             // result = NULL;   // for testing - both i2c and X11 methods work
          }
@@ -327,15 +326,12 @@ get_fallback_hiddev_edid(int fd, struct hiddev_devinfo * dev_info) {
 
 #ifdef USE_X11
    if (!parsed_edid && model_sn) {
-      parsed_edid = get_x11_edid_by_model_sn(model_sn->model, model_sn->sn);
-      edid_source = "X11";
+      parsed_edid = get_x11_edid_by_model_sn(model_sn->model, model_sn->sn);   // source "X11"
    }
 #endif
 
    if (model_sn)
       free_model_sn_pair(model_sn);
-   if (parsed_edid)
-      STRLCPY(parsed_edid->edid_source, edid_source, EDID_SOURCE_FIELD_SIZE);
    DBGTRC_DONE(debug, TRACE_GROUP, "Returning: %p", parsed_edid);
    return parsed_edid;
 }
@@ -1,6 +1,6 @@
 /** @file data_structures.c  General purpose data structures */
 
-// Copyright (C) 2014-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2014-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 /** \cond */
@@ -1928,3 +1928,189 @@ bool generic_unregister_callback(GPtrArray* registered_callbacks, void *func) {
      return found;
 }
 
+
+
+//
+// Ptr_Array_Index - Keyed lookup of GPtrArray elements
+//
+
+/** Creates an index that maps keys to the positions of elements in a
+ *  #GPtrArray.
+ *
+ *  The index does not own the array, nor is it informed when the array is
+ *  modified. Instead, every position found is verified using **match_func**.
+ *  When the index yields no match, the array is searched linearly, and the
+ *  index is rebuilt only if that search finds the element, i.e. only if the
+ *  index was stale.  Arrays that change rarely relative to the number of
+ *  lookups are thus searched in constant time, without requiring every code
+ *  path that modifies the array to maintain the index.  Lookups of keys that
+ *  are not present cost one pass of **match_func** over the array, as
+ *  without an index, but do not rebuild it.
+ *
+ *  @param  hash_func        key hash function
+ *  @param  equal_func       key equality function
+ *  @param  key_destroy_func if non-NULL, frees keys returned by **key_func**
+ *  @param  key_func         extracts the key of an array element
+ *  @param  match_func       tests whether an array element matches a key
+ *  @return newly allocated #Ptr_Array_Index
+ *
+ *  @remark
+ *  **key_func** and **match_func** must agree: an element for which
+ *  **key_func** returns false must not satisfy **match_func**.
+ *  If multiple elements have the same key, the first is found.
+ */
+Ptr_Array_Index *
+pai_new(
+      GHashFunc      hash_func,
+      GEqualFunc     equal_func,
+      GDestroyNotify key_destroy_func,
+      Pai_Key_Func   key_func,
+      Pai_Match_Func match_func)
+{
+   Ptr_Array_Index * pai = calloc(1, sizeof(Ptr_Array_Index));
+   memcpy(pai->marker, PTR_ARRAY_INDEX_MARKER, 4);
+   pai->positions = g_hash_table_new_full(hash_func, equal_func, key_destroy_func, NULL);
+   pai->key_destroy_func = key_destroy_func;
+   pai->key_func = key_func;
+   pai->match_func = match_func;
+   g_mutex_init(&pai->mutex);
+   return pai;
+}
+
+
+/** Frees a #Ptr_Array_Index.  The indexed array is not affected.
+ *
+ *  @param  pai  index to free, may be NULL
+ */
+void
+pai_free(Ptr_Array_Index * pai) {
+   if (pai) {
+      assert(memcmp(pai->marker, PTR_ARRAY_INDEX_MARKER, 4) == 0);
+      g_hash_table_destroy(pai->positions);
+      g_mutex_clear(&pai->mutex);
+      pai->marker[3] = 'x';
+      free(pai);
+   }
+}
+
+
+static void
+pai_rebuild(Ptr_Array_Index * pai, GPtrArray * array) {
+   g_hash_table_remove_all(pai->positions);
+   pai->array = array;
+   pai->duplicate_key_ct = 0;
+   for (guint ndx = 0; ndx < array->len; ndx++) {
+      gpointer key;
+      if (pai->key_func(g_ptr_array_index(array, ndx), &key)) {
+         if (g_hash_table_contains(pai->positions, key)) {
+            pai->duplicate_key_ct++;
+            if (pai->key_destroy_func)
+               pai->key_destroy_func(key);
+         }
+         else {
+            g_hash_table_insert(pai->positions, key, GUINT_TO_POINTER(ndx));
+         }
+      }
+   }
+   pai->rebuild_ct++;
+}
+
+
+static gint
+pai_find_linear(Ptr_Array_Index * pai, GPtrArray * array, gconstpointer key) {
+   for (guint ndx = 0; ndx < array->len; ndx++) {
+      if (pai->match_func(g_ptr_array_index(array, ndx), key))
+         return ndx;
+   }
+   return -1;
+}
+
+
+static gpointer
+pai_find_position(Ptr_Array_Index * pai, GPtrArray * array, gconstpointer key) {
+   gpointer result = NULL;
+   gpointer pos;
+   if (g_hash_table_lookup_extended(pai->positions, key, NULL, &pos)) {
+      guint ndx = GPOINTER_TO_UINT(pos);
+      if (ndx < array->len) {
+         gpointer element = g_ptr_array_index(array, ndx);
+         if (pai->match_func(element, key))
+            result = element;
+      }
+   }
+   return result;
+}
+
+
+/** Looks up an element of a #GPtrArray by key.
+ *
+ *  @param  pai    index
+ *  @param  array  array to search, may be NULL
+ *  @param  key    key value
+ *  @return matching element, NULL if none
+ *
+ *  @remark
+ *  If the index yields no match, the array is searched linearly.  The index
+ *  is rebuilt only if that search finds an element, or if the index was
+ *  built for a different array.
+ */
+gpointer
+pai_lookup(Ptr_Array_Index * pai, GPtrArray * array, gconstpointer key) {
+   assert(pai && memcmp(pai->marker, PTR_ARRAY_INDEX_MARKER, 4) == 0);
+   gpointer result = NULL;
+   if (array) {
+      g_mutex_lock(&pai->mutex);
+      if (pai->array != array)
+         pai_rebuild(pai, array);
+      result = pai_find_position(pai, array, key);
+      if (result) {
+         pai->hit_ct++;
+      }
+      else {
+         gint ndx = pai_find_linear(pai, array, key);
+         if (ndx >= 0) {
+            // index is stale
+            result = g_ptr_array_index(array, ndx);
+            pai_rebuild(pai, array);
+         }
+         else {
+            pai->miss_ct++;
+         }
+      }
+      g_mutex_unlock(&pai->mutex);
+   }
+   return result;
+}
+
+
+/** Discards the contents of an index, e.g. when the indexed array is freed.
+ *
+ *  @param  pai  index, may be NULL
+ */
+void
+pai_reset(Ptr_Array_Index * pai) {
+   if (pai) {
+      g_mutex_lock(&pai->mutex);
+      g_hash_table_remove_all(pai->positions);
+      pai->array = NULL;
+      pai->duplicate_key_ct = 0;
+      g_mutex_unlock(&pai->mutex);
+   }
+}
+
+
+/** Returns the number of array elements that were not indexed when the
+ *  index was last built, because an earlier element had the same key.
+ *  Allows callers whose keys should be unique to check that they are.
+ *
+ *  @param  pai  index
+ *  @return number of duplicate keys
+ */
+int
+pai_duplicate_key_ct(Ptr_Array_Index * pai) {
+   assert(pai && memcmp(pai->marker, PTR_ARRAY_INDEX_MARKER, 4) == 0);
+   g_mutex_lock(&pai->mutex);
+   int result = pai->duplicate_key_ct;
+   g_mutex_unlock(&pai->mutex);
+   return result;
+}
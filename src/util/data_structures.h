@@ -2,7 +2,7 @@
  *  General purpose data structures
  */
 
-// Copyright (C) 2014-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2014-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #ifndef DATA_STRUCTURES_H
@@ -259,6 +259,48 @@ bool store_bytehex_list(char * start, int len, void * data_struct, Byte_Appender
 bool generic_register_callback(GPtrArray** registered_callbacks_loc, void * func);
 bool generic_unregister_callback(GPtrArray* registered_callbacks, void *func);
 
+//
+// Ptr_Array_Index - Keyed lookup of GPtrArray elements
+//
+
+/** Extracts the key of an array element.
+ *  Returns false if the element is not to be indexed.  Otherwise sets
+ *  *key_loc to a newly allocated key, or to a value encoded using e.g.
+ *  GINT_TO_POINTER().
+ */
+typedef bool (*Pai_Key_Func)(gconstpointer element, gpointer * key_loc);
+
+/** Returns true if an array element is the one sought for a key */
+typedef bool (*Pai_Match_Func)(gconstpointer element, gconstpointer key);
+
+#define PTR_ARRAY_INDEX_MARKER "PAIX"
+/** Index of GPtrArray element positions by key, see #pai_new() */
+typedef struct {
+   char           marker[4];         ///< always "PAIX"
+   GHashTable *   positions;         ///< key -> array position
+   GPtrArray *    array;             ///< array as of last rebuild
+   GDestroyNotify key_destroy_func;  ///< frees keys, may be NULL
+   Pai_Key_Func   key_func;          ///< extracts key from element
+   Pai_Match_Func match_func;        ///< verifies element found
+   GMutex         mutex;             ///< serializes lookups
+   uint64_t       hit_ct;            ///< lookups satisfied without rebuild
+   uint64_t       miss_ct;           ///< lookups of keys not in the array
+   uint64_t       rebuild_ct;        ///< number of rebuilds
+   int            duplicate_key_ct;  ///< elements not indexed at last rebuild
+                                     ///< because an earlier element had the same key
+} Ptr_Array_Index;
+
+Ptr_Array_Index * pai_new(
+      GHashFunc      hash_func,
+      GEqualFunc     equal_func,
+      GDestroyNotify key_destroy_func,
+      Pai_Key_Func   key_func,
+      Pai_Match_Func match_func);
+void              pai_free(Ptr_Array_Index * pai);
+gpointer          pai_lookup(Ptr_Array_Index * pai, GPtrArray * array, gconstpointer key);
+void              pai_reset(Ptr_Array_Index * pai);
+int               pai_duplicate_key_ct(Ptr_Array_Index * pai);
+
 
 
 #ifdef __cplusplus
@@ -10,11 +10,12 @@
  *  to **ddcutil** are interpreted.
  */
 
-// Copyright (C) 2014-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2014-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 /** \cond */
 #include <assert.h>
+#include <glib-2.0/glib.h>
 #include <inttypes.h>  // printf() format macros for stdint.h
 #include <string.h>
 #include <syslog.h>
@@ -54,6 +55,31 @@ bool is_valid_edid_checksum(const Byte * edidbytes) {
 }
 
 
+/** Hashes the first 128 bytes of an EDID.
+ *
+ *  @param  edidbytes  pointer to 128 byte EDID
+ *  @return hash value
+ */
+unsigned int edid_bytes_hash(const void * edidbytes) {
+   const Byte * edid = edidbytes;
+   unsigned int hash = 5381;
+   for (int ndx = 0; ndx < 128; ndx++)
+      hash = hash * 33 + edid[ndx];
+   return hash;
+}
+
+
+/** Compares the first 128 bytes of two EDIDs.
+ *
+ *  @param  edidbytes1  pointer to 128 byte EDID
+ *  @param  edidbytes2  pointer to 128 byte EDID
+ *  @return non-zero if equal, 0 if not
+ */
+int edid_bytes_equal(const void * edidbytes1, const void * edidbytes2) {
+   return memcmp(edidbytes1, edidbytes2, 128) == 0;
+}
+
+
 bool is_valid_edid_header(const Byte * edidbytes) {
    bool debug = false;
    bool result = true;
@@ -207,20 +233,13 @@ static void get_edid_descriptor_strings(
 }
 
 
-/** Parses an EDID.
+/** Parses an EDID into a newly allocated Parsed_Edid.
  *
  * @param edidbytes   pointer to 128 byte EDID block
- *
  * @return pointer to newly allocated Parsed_Edid struct,
  *         or NULL if the bytes could not be parsed.
- *         It is the responsibility of the caller to free this memory.
- *
- * @remark
- * The bytes pointed to by **edidbytes** are copied into the newly
- * allocated Parsed_Edid.  If they were previously malloc'd they
- * need to free'd.
  */
-Parsed_Edid * create_parsed_edid(const Byte* edidbytes) {
+static Parsed_Edid * parse_edid(const Byte* edidbytes) {
    assert(edidbytes);
    // bool debug = false;
    Parsed_Edid* parsed_edid = NULL;
@@ -281,46 +300,136 @@ bye:
 }
 
 
+//
+// Interned Parsed_Edid instances
+//
+
+/*
+Parsed_Edid instances are interned: all requests to parse the same EDID
+bytes with the same source share a single reference counted instance.
+Each create_parsed_edid...() or copy_parsed_edid() call must be balanced
+by a call to free_parsed_edid().  Since instances are shared, they must
+not be modified after creation.
+*/
+
+static GMutex       parsed_edid_cache_mutex;
+static GHashTable * parsed_edid_cache = NULL;   // set of interned Parsed_Edid *
+static int          parsed_edid_cache_hits   = 0;
+static int          parsed_edid_cache_misses = 0;
+
+static guint parsed_edid_hash(gconstpointer key) {
+   const Parsed_Edid * edid = key;
+   return edid_bytes_hash(edid->bytes) ^ g_str_hash(edid->edid_source);
+}
+
+static gboolean parsed_edid_equal(gconstpointer a, gconstpointer b) {
+   const Parsed_Edid * edid1 = a;
+   const Parsed_Edid * edid2 = b;
+   return memcmp(edid1->bytes, edid2->bytes, 128) == 0 &&
+          streq(edid1->edid_source, edid2->edid_source);
+}
+
+
+/** Returns the interned Parsed_Edid for an EDID and source,
+ *  parsing the EDID if no instance exists.
+ *
+ *  @param  edidbytes  pointer to 128 byte EDID block
+ *  @param  source     source of EDID, "" if not specified
+ *  @return referenced instance, NULL if the bytes could not be parsed
+ */
+static Parsed_Edid * intern_parsed_edid(const Byte * edidbytes, const char * source) {
+   Parsed_Edid probe;
+   memcpy(probe.bytes, edidbytes, 128);
+   STRLCPY(probe.edid_source, source, EDID_SOURCE_FIELD_SIZE);
+
+   g_mutex_lock(&parsed_edid_cache_mutex);
+   if (!parsed_edid_cache)
+      parsed_edid_cache = g_hash_table_new(parsed_edid_hash, parsed_edid_equal);
+   Parsed_Edid * edid = g_hash_table_lookup(parsed_edid_cache, &probe);
+   if (edid) {
+      edid->refct++;
+      parsed_edid_cache_hits++;
+   }
+   else {
+      edid = parse_edid(edidbytes);
+      if (edid) {
+         STRLCPY(edid->edid_source, source, EDID_SOURCE_FIELD_SIZE);
+         edid->refct = 1;
+         g_hash_table_add(parsed_edid_cache, edid);
+         parsed_edid_cache_misses++;
+      }
+   }
+   g_mutex_unlock(&parsed_edid_cache_mutex);
+   return edid;
+}
+
+
+/** Parses an EDID.
+ *
+ * @param edidbytes   pointer to 128 byte EDID block
+ *
+ * @return pointer to Parsed_Edid struct,
+ *         or NULL if the bytes could not be parsed.
+ *         The caller must release it using #free_parsed_edid().
+ *
+ * @remark
+ * The bytes pointed to by **edidbytes** are copied into the
+ * Parsed_Edid.  If they were previously malloc'd they
+ * need to free'd.
+ * @remark
+ * The returned instance may be shared, and must not be modified.
+ */
+Parsed_Edid * create_parsed_edid(const Byte* edidbytes) {
+   assert(edidbytes);
+   return intern_parsed_edid(edidbytes, "");
+}
+
+
 /** Parses an EDID and sets the edid_source field.
  *
  * @param edidbytes   pointer to 128 byte EDID block
  * @param source      source of EDID, typically I2C but may be X11,
  *                    USB, SYSFS, DRM
  *
- * @return pointer to newly allocated Parsed_Edid struct,
+ * @return pointer to Parsed_Edid struct,
  *         or NULL if the bytes could not be parsed.
- *         It is the responsibility of the caller to free this memory.
+ *         The caller must release it using #free_parsed_edid().
  *
  * **source** is copied to the Parsed_Edid and should be freed is it
  * was allocated.
  */
 Parsed_Edid * create_parsed_edid2(const Byte* edidbytes, const char * source) {
-   Parsed_Edid * edid = create_parsed_edid(edidbytes);
-   if (edid) {
-      assert(source && strlen(source) < EDID_SOURCE_FIELD_SIZE);
-      STRLCPY(edid->edid_source, source, EDID_SOURCE_FIELD_SIZE);
-   }
-   return edid;
+   assert(edidbytes);
+   assert(source && strlen(source) < EDID_SOURCE_FIELD_SIZE);
+   return intern_parsed_edid(edidbytes, source);
 }
 
 
+/** Returns an additional reference to a Parsed_Edid.
+ *
+ * @param  original  instance to reference, may be NULL
+ * @return **original**
+ *
+ * The caller must release the reference using #free_parsed_edid().
+ */
 Parsed_Edid * copy_parsed_edid(Parsed_Edid * original) {
    bool debug = false;
    DBGF(debug, "Starting. original=%p", original);
-   Parsed_Edid * copy =  NULL;
    if (original) {
-      copy = create_parsed_edid(original->bytes);
-      memcpy(&copy->edid_source, original->edid_source, sizeof(original->edid_source));
-      // report_parsed_edid(copy, true, 2);
+      assert(memcmp(original->marker, EDID_MARKER_NAME, 4) == 0);
+      g_mutex_lock(&parsed_edid_cache_mutex);
+      original->refct++;
+      g_mutex_unlock(&parsed_edid_cache_mutex);
    }
-   DBGF(debug, "Done. returning %p -> ", copy);
-   return copy;
+   DBGF(debug, "Done. returning %p -> ", original);
+   return original;
 }
 
 
-/** Frees a Parsed_Edid struct.
+/** Releases a reference to a Parsed_Edid struct, freeing it
+ *  when the last reference is released.
  *
- * @param  parsed_edid  pointer to Parsed_Edid struct to free
+ * @param  parsed_edid  pointer to Parsed_Edid struct to release
  */
 void free_parsed_edid(Parsed_Edid * parsed_edid) {
    bool debug = false;
@@ -329,9 +438,16 @@ void free_parsed_edid(Parsed_Edid * parsed_edid) {
    DBGF(debug, "(free_parsed_edid) parsed_edid=%p", parsed_edid);
    // ASSERT_WITH_BACKTRACE(memcmp(parsed_edid->marker, EDID_MARKER_NAME, 4)==0);
    if ( memcmp(parsed_edid->marker, EDID_MARKER_NAME, 4)==0 ) {
-      parsed_edid->marker[3] = 'x';
-      // n. Parsed_Edid contains no pointers
-      free(parsed_edid);
+      g_mutex_lock(&parsed_edid_cache_mutex);
+      bool last_reference = (--parsed_edid->refct == 0);
+      if (last_reference)
+         g_hash_table_remove(parsed_edid_cache, parsed_edid);
+      g_mutex_unlock(&parsed_edid_cache_mutex);
+      if (last_reference) {
+         parsed_edid->marker[3] = 'x';
+         // n. Parsed_Edid contains no pointers
+         free(parsed_edid);
+      }
    }
    else {
       char * s = g_strdup_printf("Invalid free of Parsed_Edid@%p, marker=%s",
@@ -343,6 +459,21 @@ void free_parsed_edid(Parsed_Edid * parsed_edid) {
 }
 
 
+/** Reports statistics for the interned Parsed_Edid instances.
+ *
+ *  @param depth  logical indentation depth
+ */
+void report_parsed_edid_cache_stats(int depth) {
+   g_mutex_lock(&parsed_edid_cache_mutex);
+   int live_ct = (parsed_edid_cache) ? g_hash_table_size(parsed_edid_cache) : 0;
+   int hits    = parsed_edid_cache_hits;
+   int misses  = parsed_edid_cache_misses;
+   g_mutex_unlock(&parsed_edid_cache_mutex);
+   rpt_vstring(depth, "Parsed EDID cache: %d parsed, %d shared, %d currently interned",
+                      misses, hits, live_ct);
+}
+
+
 // TODO: generalize to base_asciify(char* s, char* prefix, char* suffix)
 //       move to string_util.h
 
@@ -4,7 +4,7 @@
  * the bytes of the EDID are obtained.
  */
 
-// Copyright (C) 2014-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2014-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #ifndef EDID_H_
@@ -38,6 +38,10 @@ bool is_valid_edid_header(const Byte * edidbytes);
 bool is_valid_raw_edid(const Byte * edidbytes, int len);
 bool is_valid_raw_cea861_extension_block(const Byte * edid, int len);
 
+// Hash table support for 128 byte EDIDs, compatible with GHashFunc and GEqualFunc
+unsigned int edid_bytes_hash(const void * edidbytes);
+int          edid_bytes_equal(const void * edidbytes1, const void * edidbytes2);
+
 void parse_mfg_id_in_buffer(const Byte * mfgIdBytes, char * buffer, int bufsize);
 void get_edid_mfg_id_in_buffer(const Byte* edidbytes, char * buffer, int bufsize);
 
@@ -70,6 +74,7 @@ struct {
    Byte         supported_features;      ///< EDID byte 24 (x18) supported features bitmap
    uint8_t      extension_flag;          ///< number of optional extension blocks
    char         edid_source[EDID_SOURCE_FIELD_SIZE];  ///< describes source of EDID
+   int          refct;                   ///< number of references to this shared instance
 } Parsed_Edid;
 
 Parsed_Edid * create_parsed_edid(const Byte* edidbytes);
@@ -79,6 +84,7 @@ bool          is_input_digital(Parsed_Edid * edid);
 void          report_parsed_edid(Parsed_Edid * edid, bool verbose, int depth);
 Parsed_Edid * copy_parsed_edid(Parsed_Edid * original);
 void          free_parsed_edid(Parsed_Edid * parsed_edid);
+void          report_parsed_edid_cache_stats(int depth);
 bool          is_laptop_parsed_edid(Parsed_Edid * parsed_edid);
 
 #endif /* EDID_H_ */
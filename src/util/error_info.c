@@ -9,7 +9,7 @@
  *  error is retained for use by higher levels in the call stack.
  */
 
-// Copyright (C) 2017-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2017-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 
@@ -490,6 +490,65 @@ Error_Info * errinfo_new_with_causes_gptr(
 }
 
 
+//
+// Status trails
+//
+
+/** Initializes an #Error_Status_Trail.
+ *
+ *  \param  trail  pointer to trail
+ *  \param  func   name of function whose status codes are recorded,
+ *                 must remain valid for the life of the trail, e.g. __func__
+ */
+void errinfo_status_trail_init(Error_Status_Trail * trail, const char * func) {
+   trail->func = func;
+   trail->ct = 0;
+}
+
+
+/** Records a status code in an #Error_Status_Trail.
+ *
+ *  Status code 0 (success) is not recorded.  If the trail is full the
+ *  status code is discarded.
+ *
+ *  \param  trail        pointer to trail
+ *  \param  status_code  status code
+ */
+void errinfo_status_trail_add(Error_Status_Trail * trail, int status_code) {
+   if (status_code != 0 && trail->ct < ERRINFO_STATUS_TRAIL_MAX)
+      trail->status_codes[trail->ct++] = status_code;
+}
+
+
+/** Creates a new #Error_Info instance whose causes are the status codes
+ *  recorded in an #Error_Status_Trail.  One cause instance is created
+ *  for each status code.
+ *
+ *  \param  status_code  status code of the new instance
+ *  \param  trail        pointer to trail
+ *  \param  func         name of function creating the new #Error_Info
+ *  \param  detail       detail format string
+ *  \param  ...          optional arguments for detail format string
+ *  \return pointer to new instance
+ */
+Error_Info * errinfo_new_from_status_trail(
+      int                  status_code,
+      Error_Status_Trail * trail,
+      const char *         func,
+      char *               detail,
+      ...)
+{
+   va_list ap;
+   va_start(ap, detail);
+   Error_Info * result = errinfo_newv(status_code, func, detail, ap);
+   va_end(ap);
+   for (int ndx = 0; ndx < trail->ct; ndx++) {
+      errinfo_add_cause(result, errinfo_new(trail->status_codes[ndx], trail->func, NULL));
+   }
+   return result;
+}
+
+
 #ifdef UNUSED
 
 // For creating a new Ddc_Error when the called functions
@@ -551,14 +610,34 @@ default_status_code_desc(int rc) {
 }
 
 
+static void
+append_status_code_run(
+      GString *             gs,
+      bool                  first,
+      int                   psc,
+      int                   ct)
+{
+   if (!first)
+      g_string_append(gs, ", ");
+   if (errinfo_name_func)
+      g_string_append(gs, errinfo_name_func(psc));
+   else {
+      char buf[20];
+      snprintf(buf, 20, "%d",psc);
+      buf[19] = '\0';
+      g_string_append(gs, buf);
+   }
+   if (ct > 1)
+      g_string_append_printf(gs, "(%d)", ct);
+}
+
+
 static GString *
 errinfo_array_summary_gs(
       struct error_info **  errors,    ///<  pointer to array of pointers to Error_Info
       int                   error_ct,  ///<  number of causal errors
       GString *             gs)        ///<  append result here
 {
-      bool first = true;
-
       int ndx = 0;
       while (ndx < error_ct) {
          // printf("(%s) this error = %p\n", __func__, errors[ndx]);
@@ -571,20 +650,7 @@ errinfo_array_summary_gs(
             cur_ct++;
          }
 
-         if (first)
-            first = false;
-         else
-            g_string_append(gs, ", ");
-         if (errinfo_name_func)
-            g_string_append(gs, errinfo_name_func(this_psc));
-         else {
-            char buf[20];
-            snprintf(buf, 20, "%d",this_psc);
-            buf[19] = '\0';
-            g_string_append(gs, buf);
-         }
-         if (cur_ct > 1)
-            g_string_append_printf(gs, "(%d)", cur_ct);
+         append_status_code_run(gs, ndx == 0, this_psc, cur_ct);
          ndx += cur_ct;
       }
 
@@ -616,6 +682,30 @@ errinfo_array_summary(
 }
 
 
+/** Returns a comma separated string of the status code names recorded
+ *  in an #Error_Status_Trail.
+ *  Multiple consecutive identical names are replaced with a
+ *  single name and a parenthesized instance count.
+ *
+ *  \param  trail  pointer to trail
+ *  \return comma separated string, caller is responsible for freeing
+ */
+char *
+errinfo_status_trail_summary(Error_Status_Trail * trail) {
+   GString * gs = g_string_new(NULL);
+   int ndx = 0;
+   while (ndx < trail->ct) {
+      int this_psc = trail->status_codes[ndx];
+      int cur_ct = 1;
+      while (ndx+cur_ct < trail->ct && trail->status_codes[ndx+cur_ct] == this_psc)
+         cur_ct++;
+      append_status_code_run(gs, ndx == 0, this_psc, cur_ct);
+      ndx += cur_ct;
+   }
+   return g_string_free(gs, false);
+}
+
+
 /** Returns a comma separated string of the names of the status codes in the
  *  causes of the specified #Error_Info.
  *  Multiple consecutive identical names are replaced with a
@@ -9,7 +9,7 @@
  *  error is retained for use by higher levels in the call stack.
  */
 
-// Copyright (C) 2017-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2017-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 
@@ -43,6 +43,20 @@ typedef struct error_info {
 } Error_Info;
 
 
+#define ERRINFO_STATUS_TRAIL_MAX 16
+
+/** Compact record of the status codes returned by a sequence of calls to
+ *  the same function, e.g. the tries of an operation that is retried.
+ *  No #Error_Info instances are allocated unless
+ *  #errinfo_new_from_status_trail() is called.
+ */
+typedef struct {
+   const char *       func;         ///<  name of function returning the status codes
+   int                ct;           ///<  number of status codes recorded
+   int                status_codes[ERRINFO_STATUS_TRAIL_MAX];
+} Error_Status_Trail;
+
+
 typedef char * (*ErrInfo_Status_String)(int code);
 
 bool errinfo_all_causes_same_status(
@@ -107,6 +121,21 @@ Error_Info * errinfo_new_with_causes_gptr(
       ...);
 
 
+void errinfo_status_trail_init(
+      Error_Status_Trail * trail,
+      const char *         func);
+
+void errinfo_status_trail_add(
+      Error_Status_Trail * trail,
+      int                  status_code);
+
+Error_Info * errinfo_new_from_status_trail(
+      int                  status_code,
+      Error_Status_Trail * trail,
+      const char *         func,
+      char *               detail,
+      ...);
+
 #ifdef UNUSED
 Error_Info * errinfo_new_with_callee_status_codes(
       int            status_code,
@@ -133,6 +162,9 @@ char * errinfo_array_summary(
       Error_Info **  errors,
       int            error_ct);
 
+char * errinfo_status_trail_summary(
+      Error_Status_Trail * trail);
+
 char * errinfo_causes_string(
       Error_Info *   erec);
 
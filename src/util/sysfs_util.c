@@ -3,20 +3,24 @@
   * Functions for reading /sys file system
   */
 
-// Copyright (C) 2016-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2016-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #define _GNU_SOURCE
 
 //* \cond */
 #include <assert.h>
+#include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <glib-2.0/glib.h>
 #include <libgen.h>
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 /** \endcond */
 
 #include "coredefs_base.h"
@@ -711,3 +715,180 @@ rpt_attr_note_indirect_subdir(
    return found;
 }
 
+
+
+//
+// Directory relative attribute reads
+//
+
+/*
+The sysfs_..._at() functions read attributes relative to a directory that
+has been opened once with O_PATH, instead of assembling and resolving a full
+path name for each attribute.  Values are returned in caller supplied
+buffers, so reading the many attributes of a device directory requires
+neither path string construction nor heap allocation.
+
+Relative names may contain more than one segment, e.g. "ddc/i2c-dev".
+*/
+
+/** Opens a sysfs directory for use with the sysfs_..._at() functions.
+ *
+ *  \param  dirfd    directory relative to which **relpath** is resolved,
+ *                   or AT_FDCWD
+ *  \param  relpath  directory name
+ *  \return file descriptor opened with O_PATH, -errno if error
+ *
+ *  Caller is responsible for closing the returned descriptor.
+ */
+int
+sysfs_open_dir_at(
+      int          dirfd,
+      const char * relpath)
+{
+   int fd = openat(dirfd, relpath, O_PATH|O_DIRECTORY|O_CLOEXEC);
+   if (fd < 0)
+      fd = -errno;
+   return fd;
+}
+
+
+/** Reports whether a subdirectory exists.
+ *
+ *  \param  dirfd    directory descriptor
+ *  \param  relpath  name of subdirectory relative to **dirfd**
+ *  \return true if **relpath** exists and is a directory, false if not
+ */
+bool
+sysfs_dir_exists_at(
+      int          dirfd,
+      const char * relpath)
+{
+   struct stat statbuf;
+   return fstatat(dirfd, relpath, &statbuf, 0) == 0 && S_ISDIR(statbuf.st_mode);
+}
+
+
+/** Reads a /sys attribute file, which is 1 line of text, into a
+ *  caller supplied buffer.  The trailing newline is removed.
+ *
+ *  \param  dirfd    directory descriptor
+ *  \param  relpath  attribute name relative to **dirfd**
+ *  \param  buf      buffer in which to return value
+ *  \param  bufsz    buffer size
+ *  \retval buf      attribute value
+ *  \retval NULL     attribute cannot be read or is empty
+ *
+ *  The value will be silently truncated if necessary to fit in buffer.
+ */
+char *
+sysfs_read_attr_at_r(
+      int          dirfd,
+      const char * relpath,
+      char *       buf,
+      unsigned     bufsz)
+{
+   assert(buf && bufsz > 1);
+   char * result = NULL;
+   int fd = openat(dirfd, relpath, O_RDONLY|O_CLOEXEC);
+   if (fd >= 0) {
+      ssize_t ct = read(fd, buf, bufsz-1);
+      close(fd);
+      if (ct > 0) {
+         buf[ct] = '\0';
+         char * nl = strchr(buf, '\n');
+         if (nl)
+            *nl = '\0';
+         result = buf;
+      }
+   }
+   return result;
+}
+
+
+/** Reads a binary /sys attribute file into a caller supplied buffer.
+ *
+ *  \param  dirfd    directory descriptor
+ *  \param  relpath  attribute name relative to **dirfd**
+ *  \param  buf      buffer in which to return value
+ *  \param  bufsz    buffer size
+ *  \retval >= 0        number of bytes read
+ *  \retval -EOVERFLOW  attribute value is larger than the buffer,
+ *                      the buffer contains its first **bufsz** bytes
+ *  \retval < 0         -errno for open or read failure
+ */
+int
+sysfs_read_binary_attr_at_r(
+      int          dirfd,
+      const char * relpath,
+      Byte *       buf,
+      unsigned     bufsz)
+{
+   int fd = openat(dirfd, relpath, O_RDONLY|O_CLOEXEC);
+   if (fd < 0)
+      return -errno;
+
+   int result = 0;
+   while ((unsigned) result < bufsz) {
+      ssize_t ct = read(fd, buf+result, bufsz-result);
+      if (ct < 0) {
+         if (errno == EINTR)
+            continue;
+         result = -errno;
+         break;
+      }
+      if (ct == 0)
+         break;
+      result += ct;
+   }
+   if ((unsigned) result == bufsz) {
+      Byte extra;
+      if (read(fd, &extra, 1) > 0)
+         result = -EOVERFLOW;
+   }
+   close(fd);
+   return result;
+}
+
+
+/** Returns the name of the first entry of a directory whose name starts with
+ *  a specified prefix.
+ *
+ *  \param  dirfd    directory descriptor
+ *  \param  relpath  name of directory to search relative to **dirfd**,
+ *                   "." to search **dirfd** itself
+ *  \param  prefix   required name prefix
+ *  \param  buf      buffer in which to return name
+ *  \param  bufsz    buffer size
+ *  \retval buf      name found
+ *  \retval NULL     directory cannot be read or no entry found
+ */
+char *
+sysfs_find_subdir_at_r(
+      int          dirfd,
+      const char * relpath,
+      const char * prefix,
+      char *       buf,
+      unsigned     bufsz)
+{
+   char * result = NULL;
+   // fdopendir() requires a descriptor that can be read, which O_PATH is not
+   int fd = openat(dirfd, relpath, O_RDONLY|O_DIRECTORY|O_CLOEXEC);
+   if (fd >= 0) {
+      DIR * dir = fdopendir(fd);
+      if (!dir) {
+         close(fd);
+      }
+      else {
+         struct dirent * dent;
+         while ((dent = readdir(dir)) != NULL) {
+            if (str_starts_with(dent->d_name, prefix)) {
+               g_strlcpy(buf, dent->d_name, bufsz);
+               result = buf;
+               break;
+            }
+         }
+         closedir(dir);   // also closes fd
+      }
+   }
+   return result;
+}
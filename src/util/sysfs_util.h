@@ -2,7 +2,7 @@
  * Functions for reading /sys file system
  */
 
-// Copyright (C) 2016-2023 Sanford Rockowitz <rockowitz@minsoft.com>
+// Copyright (C) 2016-2024 Sanford Rockowitz <rockowitz@minsoft.com>
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #ifndef SYSFS_UTIL_H_
@@ -13,6 +13,8 @@
 #include <stdbool.h>
 #include <glib-2.0/glib.h>
 
+#include "coredefs_base.h"   // for Byte
+
 
 char *
 read_sysfs_attr(
@@ -143,4 +145,38 @@ rpt_attr_note_indirect_subdir(
 #define RPT_ATTR_NOTE_INDIRECT_SUBDIR(depth, value_loc, fn_segment, ...) \
    rpt_attr_note_indirect_subdir(depth, value_loc, fn_segment,  ##__VA_ARGS__, NULL)
 
+// Directory relative reads into caller supplied buffers
+
+int
+sysfs_open_dir_at(
+      int          dirfd,
+      const char * relpath);
+
+bool
+sysfs_dir_exists_at(
+      int          dirfd,
+      const char * relpath);
+
+char *
+sysfs_read_attr_at_r(
+      int          dirfd,
+      const char * relpath,
+      char *       buf,
+      unsigned     bufsz);
+
+int
+sysfs_read_binary_attr_at_r(
+      int          dirfd,
+      const char * relpath,
+      Byte *       buf,
+      unsigned     bufsz);
+
+char *
+sysfs_find_subdir_at_r(
+      int          dirfd,
+      const char * relpath,
+      const char * prefix,
+      char *       buf,
+      unsigned     bufsz);
+
 #endif /* SYSFS_UTIL_H_ */